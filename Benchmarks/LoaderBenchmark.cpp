@@ -0,0 +1,617 @@
+// LoaderBenchmark.cpp
+// ޽ļع߻׼һ tileset / ƬĿ¼
+// TilesetParserB3DMLoaderGLTF1ParserGLBParser׶¡ֵפڴ档
+//  GL ģû GPU ĻС
+//
+// ÷: LoaderBenchmark <tileset.json | ƬĿ¼ |  b3dm/glb> [--iterations N] [--compare] [--simplify] [--optimize]
+//   --iterations N  ÿ׶ظ N ΣȡһΣĬ 3
+//   --compare       ͬʱвʵ֣DOM  tilesettinygltf  glTF 2.0
+//   --simplify       QEM 򻯣ÿƬ򻯵һ붥㣬밴ƬУУ߽һ£ɢ LOD 
+//   --optimize      ʱ˳Żз֣ŻǰĶ㻺ͳƣACMR / ATVR
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "3Dtiles/B3DMLoader.h"
+#include "3Dtiles/TilesetParser.h"
+#include "Core/MappedFile.h"
+#include "Core/ThreadPool.h"
+#include "Render/QuadricSimplifier.h"
+#include "Render/LODChainBuilder.h"
+#include "Render/MeshOptimizer.h"
+#include "Render/MeshletBuilder.h"
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// 滻ȫ operator newͳÿ׶εĶѷֽ
+// ---------------------------------------------------------------------------
+namespace {
+    std::atomic<size_t> g_allocations{ 0 };
+    std::atomic<size_t> g_allocatedBytes{ 0 };
+}
+
+// 滻汾 malloc 䡢free ͷţ˴һ£GCC Щ÷
+//  operator new صָ free Զ -Wmismatched-new-delete
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+using Mirror::Core::MappedFile;
+
+/// ̷ֵפڴ棨ֽڣ
+size_t PeakResidentBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    return 0;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+  #if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss);          // macOS λΪֽ
+  #else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;   // Linux λΪ KB
+  #endif
+#endif
+}
+
+/// ļӡ־ʱڼα׼ѿ̨
+class ScopedQuiet {
+public:
+    ScopedQuiet() {
+        std::cout.setstate(std::ios::badbit);
+        std::cerr.setstate(std::ios::badbit);
+    }
+    ~ScopedQuiet() {
+        std::cout.clear();
+        std::cerr.clear();
+    }
+};
+
+/// αļ
+struct PassCounts {
+    size_t items = 0;
+    size_t failures = 0;
+    uint64_t bytes = 0;
+    uint64_t triangles = 0;
+    std::string firstError;
+
+    void Fail(const std::string& path, const std::exception& e) {
+        if (failures++ == 0) firstError = path + ": " + e.what();
+    }
+};
+
+struct StageResult {
+    std::string name;
+    PassCounts counts;          // һαļ
+    double bestSeconds = 0.0;   // һαĺʱ
+    size_t allocations = 0;     // ÿαķ
+    size_t allocatedBytes = 0;  // ÿαķֽ
+    size_t peakResident = 0;    // ׶νʱĽ̷ֵפڴ
+};
+
+/// ظһα¼ʱͳ
+StageResult RunStage(const std::string& name, int iterations, const std::function<PassCounts()>& pass) {
+    StageResult result;
+    result.name = name;
+    result.bestSeconds = -1.0;
+    for (int i = 0; i < iterations; ++i) {
+        const size_t allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+        const size_t bytesBefore = g_allocatedBytes.load(std::memory_order_relaxed);
+        const auto start = Clock::now();
+        {
+            ScopedQuiet quiet;
+            result.counts = pass();
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        result.allocations = g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+        result.allocatedBytes = g_allocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+        if (result.bestSeconds < 0.0 || seconds < result.bestSeconds) result.bestSeconds = seconds;
+    }
+    result.peakResident = PeakResidentBytes();
+    return result;
+}
+
+void PrintHeader() {
+    std::printf("%-22s %7s %9s %10s %9s %9s %12s %10s %10s\n",
+                "stage", "items", "MB", "best ms", "MB/s", "Mtri/s", "allocs/pass", "alloc MB", "peak RSS");
+}
+
+void PrintStage(const StageResult& r) {
+    constexpr double MB = 1024.0 * 1024.0;
+    const double seconds = std::max(r.bestSeconds, 1e-9);
+    const double megabytes = static_cast<double>(r.counts.bytes) / MB;
+    char triangles[32] = "-";
+    if (r.counts.triangles)
+        std::snprintf(triangles, sizeof(triangles), "%.2f", static_cast<double>(r.counts.triangles) / seconds / 1e6);
+
+    std::printf("%-22s %7zu %9.2f %10.2f %9.1f %9s %12zu %10.2f %9.1fM\n",
+                r.name.c_str(), r.counts.items, megabytes, r.bestSeconds * 1000.0, megabytes / seconds,
+                triangles, r.allocations, static_cast<double>(r.allocatedBytes) / MB,
+                static_cast<double>(r.peakResident) / MB);
+    if (r.counts.failures)
+        std::printf("    %zu ʧܣ׸: %s\n", r.counts.failures, r.counts.firstError.c_str());
+}
+
+/// ӳƬļе GLB 
+struct TileInput {
+    std::string path;
+    MappedFile file;
+    std::span<const uint8_t> glb;
+    uint32_t glbVersion = 0;
+    bool isB3DM = false;
+};
+
+bool HasExtension(const fs::path& path, const char* ext) {
+    std::string e = path.extension().string();
+    std::transform(e.begin(), e.end(), e.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return e == ext;
+}
+
+void WalkTree(const TileNode& tile, const std::function<void(const TileNode&)>& visit) {
+    visit(tile);
+    for (const auto& child : tile.children) {
+        if (child) WalkTree(*child, visit);
+    }
+}
+
+/// ȫ tileset ļ + չⲿ tilesetֽ
+uint64_t TilesetBytes(const std::string& rootPath, const TileNode& root) {
+    uint64_t bytes = fs::file_size(rootPath);
+    WalkTree(root, [&](const TileNode& tile) {
+        if (tile.external == TileNode::ExternalState::Expanded) {
+            std::error_code ec;
+            const auto size = fs::file_size(tile.path, ec);
+            if (!ec) bytes += size;
+        }
+    });
+    return bytes;
+}
+
+void PrintUsage() {
+    std::cout << "÷: LoaderBenchmark <tileset.json | ƬĿ¼ |  b3dm/glb> [--iterations N] [--compare] [--simplify] [--optimize]\n"
+                 "  --iterations N  ÿ׶ظ N ΣȡһΣĬ 3\n"
+                 "  --compare       ͬʱвʵ֣DOM  tilesettinygltf  glTF 2.0\n"
+                 "  --simplify       QEM 򻯣ÿƬ򻯵һ붥㣬밴ƬУУ߽һ£ɢ LOD \n"
+                 "  --optimize      ʱ˳Żз֣ŻǰĶ㻺ͳƣACMR / ATVR\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string input;
+    int iterations = 3;
+    bool compare = false;
+    bool simplify = false;
+    bool optimize = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--compare") {
+            compare = true;
+        } else if (arg == "--simplify") {
+            simplify = true;
+        } else if (arg == "--optimize") {
+            optimize = true;
+        } else if (arg == "--help" || arg == "-h") {
+            PrintUsage();
+            return 0;
+        } else if (input.empty()) {
+            input = arg;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (input.empty() || !fs::exists(input)) {
+        PrintUsage();
+        return 1;
+    }
+
+    // ---- ȷ tileset Ƭļ ----
+    std::string tilesetPath;
+    std::vector<std::string> tilePaths;
+    if (fs::is_directory(input)) {
+        if (fs::exists(fs::path(input) / "tileset.json"))
+            tilesetPath = (fs::path(input) / "tileset.json").string();
+        for (const auto& entry : fs::recursive_directory_iterator(input)) {
+            if (entry.is_regular_file() && (HasExtension(entry.path(), ".b3dm") || HasExtension(entry.path(), ".glb")))
+                tilePaths.push_back(entry.path().string());
+        }
+        std::sort(tilePaths.begin(), tilePaths.end());
+    } else if (HasExtension(input, ".json")) {
+        tilesetPath = input;
+    } else {
+        tilePaths.push_back(input);
+    }
+
+    std::vector<StageResult> results;
+    std::string summary;  // ֮ĸͳ
+    bool mismatch = false;  // УʧʱԷ״̬˳
+
+    // ---- ׶ 1tileset ȫչⲿ tilesetĹ----
+    if (!tilesetPath.empty()) {
+        std::shared_ptr<TileNode> root;
+        try {
+            ScopedQuiet quiet;
+            root = TilesetParser::BuildTileTree(tilesetPath, { true, false });
+        } catch (const std::exception& e) {
+            std::cerr << "tileset ʧ: " << e.what() << std::endl;
+            return 1;
+        }
+        if (!root) {
+            std::cerr << "tileset ʧ: " << tilesetPath << std::endl;
+            return 1;
+        }
+
+        const uint64_t jsonBytes = TilesetBytes(tilesetPath, *root);
+        //  tileset ļʱƬȡдݵĽڵ㣻Ŀ¼ʱɨ
+        const bool collectTiles = !fs::is_directory(input);
+        size_t nodeCount = 0;
+        WalkTree(*root, [&](const TileNode& tile) {
+            ++nodeCount;
+            if (collectTiles && tile.HasRenderableContent() && fs::exists(tile.path)) tilePaths.push_back(tile.path);
+        });
+        std::sort(tilePaths.begin(), tilePaths.end());
+        tilePaths.erase(std::unique(tilePaths.begin(), tilePaths.end()), tilePaths.end());
+
+        auto tilesetPass = [&](bool streaming) {
+            return [&, streaming]() {
+                PassCounts counts;
+                try {
+                    auto tree = TilesetParser::BuildTileTree(tilesetPath, { streaming, false });
+                    if (tree) WalkTree(*tree, [&](const TileNode&) { ++counts.items; });
+                    counts.bytes = jsonBytes;
+                } catch (const std::exception& e) {
+                    counts.Fail(tilesetPath, e);
+                }
+                return counts;
+            };
+        };
+        results.push_back(RunStage("tileset (SAX)", iterations, tilesetPass(true)));
+        if (compare) results.push_back(RunStage("tileset (DOM)", iterations, tilesetPass(false)));
+
+        std::cout << "tileset: " << tilesetPath << "" << nodeCount << " ڵ" << std::endl;
+    }
+
+    // ---- ׼Ƭӳļλ GLB Σʱ----
+    std::vector<TileInput> tiles;
+    tiles.reserve(tilePaths.size());
+    size_t skipped = 0;
+    for (const auto& path : tilePaths) {
+        try {
+            TileInput tile;
+            tile.path = path;
+            tile.file = MappedFile(path);
+            const auto bytes = tile.file.Bytes();
+            tile.isB3DM = bytes.size() >= 4 && std::memcmp(bytes.data(), "b3dm", 4) == 0;
+            tile.glb = tile.isB3DM ? B3DMLoader::ParseB3DM(bytes).glb : bytes;
+            if (tile.glb.size() < sizeof(Mirror::GLTF::GLTF1Parser::GLBHeader))
+                throw std::runtime_error("GLBݹ");
+            Mirror::GLTF::GLTF1Parser::GLBHeader header;
+            std::memcpy(&header, tile.glb.data(), sizeof(header));
+            tile.glbVersion = Mirror::Core::EndianUtils::FromLittleEndian(header.version);
+            tiles.push_back(std::move(tile));
+        } catch (const std::exception& e) {
+            if (skipped++ == 0) std::cerr << " " << path << ": " << e.what() << std::endl;
+        }
+    }
+    std::cout << "Ƭ: " << tiles.size() << " ";
+    if (skipped) std::cout << " " << skipped << " ޷ʶļ";
+    std::cout << "ÿ׶ " << iterations << " ȡ\n" << std::endl;
+
+    if (!tiles.empty()) {
+        // ---- ׶ 2ӳ䲢ȡҳ I/O ȱҳ----
+        results.push_back(RunStage("read (mmap)", iterations, [&]() {
+            PassCounts counts;
+            volatile uint8_t sink = 0;
+            for (const auto& tile : tiles) {
+                try {
+                    const MappedFile file(tile.path);
+                    const auto bytes = file.Bytes();
+                    uint8_t acc = 0;
+                    for (size_t i = 0; i < bytes.size(); i += 4096) acc ^= bytes[i];
+                    sink = sink ^ acc;
+                    counts.bytes += bytes.size();
+                    ++counts.items;
+                } catch (const std::exception& e) {
+                    counts.Fail(tile.path, e);
+                }
+            }
+            return counts;
+        }));
+
+        // ---- ׶ 3b3dm ֶ ----
+        results.push_back(RunStage("b3dm sections", iterations, [&]() {
+            PassCounts counts;
+            for (const auto& tile : tiles) {
+                if (!tile.isB3DM) continue;
+                try {
+                    const auto view = B3DMLoader::ParseB3DM(tile.file.Bytes());
+                    counts.bytes += view.header.byteLength;
+                    ++counts.items;
+                } catch (const std::exception& e) {
+                    counts.Fail(tile.path, e);
+                }
+            }
+            return counts;
+        }));
+
+        // ---- ׶ 4glTF 루 GLB 汾ֱͳƣ----
+        using DecodeFn = std::function<size_t(std::span<const uint8_t>)>;  // 
+        auto decodePass = [&](uint32_t version, DecodeFn decode) {
+            return [&, version, decode]() {
+                PassCounts counts;
+                for (const auto& tile : tiles) {
+                    if (tile.glbVersion != version) continue;
+                    try {
+                        counts.triangles += decode(tile.glb) / 3;
+                        counts.bytes += tile.glb.size();
+                        ++counts.items;
+                    } catch (const std::exception& e) {
+                        counts.Fail(tile.path, e);
+                    }
+                }
+                return counts;
+            };
+        };
+
+        const bool hasGLTF1 = std::any_of(tiles.begin(), tiles.end(), [](const TileInput& t) { return t.glbVersion == 1; });
+        const bool hasGLTF2 = std::any_of(tiles.begin(), tiles.end(), [](const TileInput& t) { return t.glbVersion == 2; });
+        if (hasGLTF1) {
+            results.push_back(RunStage("glTF 1.0", iterations, decodePass(1, [](std::span<const uint8_t> glb) {
+                const auto mesh = Mirror::GLTF::GLTF1Parser::Parse(glb);
+                const auto vertices = mesh.BuildVertices();  //  B3DMLoader һΪ Vertex
+                return mesh.indices.size();
+            })));
+        }
+        if (hasGLTF2) {
+            results.push_back(RunStage("glTF 2.0", iterations, decodePass(2, [](std::span<const uint8_t> glb) {
+                return Mirror::GLTF::GLBParser::Parse(glb).indices.size();
+            })));
+            if (compare) {
+                results.push_back(RunStage("glTF 2.0 (tinygltf)", iterations, decodePass(2, [](std::span<const uint8_t> glb) {
+                    return Mirror::GLTF::GLBParser::ParseWithTinyGLTF(glb).indices.size();
+                })));
+            }
+        }
+
+        // ---- ׶ 5˵ˣB3DMLoader::Decode̵߳Ĺͬ----
+        results.push_back(RunStage("decode (end-to-end)", iterations, [&]() {
+            PassCounts counts;
+            for (const auto& tile : tiles) {
+                try {
+                    const auto data = B3DMLoader::Decode(tile.path);
+                    counts.triangles += data.indices.size() / 3;
+                    counts.bytes += tile.file.Size();
+                    ++counts.items;
+                } catch (const std::exception& e) {
+                    counts.Fail(tile.path, e);
+                }
+            }
+            return counts;
+        }));
+
+        // ---- ׶ 6QEM 򻯣ProgressiveLOD Ԥ㣩˳Ż벻 ----
+        std::vector<B3DMLoader::MeshData> meshes;
+        if (simplify || optimize) {
+            ScopedQuiet quiet;
+            for (const auto& tile : tiles) {
+                try {
+                    meshes.push_back(B3DMLoader::Decode(tile.file.Bytes()));
+                } catch (const std::exception&) {
+                    // ʧһ׶α
+                }
+            }
+        }
+        if (simplify) {
+            results.push_back(RunStage("simplify (QEM 50%)", iterations, [&]() {
+                PassCounts counts;
+                for (const auto& mesh : meshes) {
+                    try {
+                        QuadricSimplifier simplifier(mesh.vertices, mesh.indices);
+                        simplifier.SimplifyTo(simplifier.GetSourceVertexCount() / 2);
+                        counts.triangles += mesh.indices.size() / 3;
+                        counts.bytes += mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(uint32_t);
+                        ++counts.items;
+                    } catch (const std::exception& e) {
+                        counts.Fail("mesh", e);
+                    }
+                }
+                return counts;
+            }));
+
+            // ͬĹƬַأӦƬԤ
+            results.push_back(RunStage("simplify (pool)", iterations, [&]() {
+                std::vector<PassCounts> perMesh(meshes.size());
+                Mirror::Core::ThreadPool::Shared().ParallelFor(meshes.size(), 1, [&](size_t first, size_t last) {
+                    for (size_t i = first; i < last; ++i) {
+                        const auto& mesh = meshes[i];
+                        try {
+                            QuadricSimplifier simplifier(mesh.vertices, mesh.indices);
+                            simplifier.SimplifyTo(simplifier.GetSourceVertexCount() / 2);
+                            perMesh[i].triangles = mesh.indices.size() / 3;
+                            perMesh[i].bytes = mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(uint32_t);
+                            perMesh[i].items = 1;
+                        } catch (const std::exception& e) {
+                            perMesh[i].Fail("mesh", e);
+                        }
+                    }
+                });
+                PassCounts counts;
+                for (const auto& c : perMesh) {
+                    counts.items += c.items;
+                    counts.triangles += c.triangles;
+                    counts.bytes += c.bytes;
+                    if (c.failures > 0 && counts.failures++ == 0) counts.firstError = c.firstError;
+                }
+                return counts;
+            }));
+
+            // ȷԣرղԤ򻯣밴ƬԤеĽȽϣȫһ
+            std::vector<std::vector<uint32_t>> serialIndices(meshes.size()), poolIndices(meshes.size());
+            const auto simplifyInto = [&](size_t i, bool parallelSetup, std::vector<uint32_t>& out) {
+                QuadricSimplifier::Options simplifierOptions;
+                simplifierOptions.parallelSetup = parallelSetup;
+                try {
+                    QuadricSimplifier simplifier(meshes[i].vertices, meshes[i].indices, simplifierOptions);
+                    simplifier.SimplifyTo(simplifier.GetSourceVertexCount() / 2);
+                    out = simplifier.GetIndices();
+                } catch (const std::exception&) {
+                    out.clear();  // ʧڼʱ׶α
+                }
+            };
+            for (size_t i = 0; i < meshes.size(); ++i) simplifyInto(i, false, serialIndices[i]);
+            Mirror::Core::ThreadPool::Shared().ParallelFor(meshes.size(), 1, [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) simplifyInto(i, true, poolIndices[i]);
+            });
+            size_t differing = 0;
+            for (size_t i = 0; i < meshes.size(); ++i) differing += serialIndices[i] != poolIndices[i];
+            char line[128];
+            std::snprintf(line, sizeof(line), "simplify: serial vs pool output %s (%zu of %zu meshes differ)\n",
+                          differing == 0 ? "identical" : "MISMATCH", differing, meshes.size());
+            summary += line;
+            if (differing > 0) mismatch = true;
+
+            // ع߳ϵĬ LOD 𼶼ֱ治
+            results.push_back(RunStage("lod chain", iterations, [&]() {
+                PassCounts counts;
+                for (const auto& mesh : meshes) {
+                    try {
+                        std::vector<uint32_t> indices = mesh.indices;
+                        LODChainBuilder::Build(mesh.vertices, indices);
+                        counts.triangles += mesh.indices.size() / 3;
+                        counts.bytes += mesh.vertices.size() * sizeof(Vertex) + indices.size() * sizeof(uint32_t);
+                        ++counts.items;
+                    } catch (const std::exception& e) {
+                        counts.Fail("mesh", e);
+                    }
+                }
+                return counts;
+            }));
+        }
+
+        // ع̵߳˳Żͳư / Ȩ
+        if (optimize) {
+            MeshOptimizer::CacheStatistics before, after;
+            results.push_back(RunStage("optimize (mesh)", iterations, [&]() {
+                PassCounts counts;
+                double missesBefore = 0.0, missesAfter = 0.0, triangles = 0.0, referenced = 0.0;
+                for (const auto& mesh : meshes) {
+                    try {
+                        std::vector<Vertex> vertices = mesh.vertices;
+                        std::vector<uint32_t> indices = mesh.indices;
+                        const auto report = MeshOptimizer::Optimize(vertices, indices);
+                        const double t = static_cast<double>(indices.size() / 3);
+                        missesBefore += report.before.acmr * t;
+                        missesAfter += report.after.acmr * t;
+                        triangles += t;
+                        if (report.after.atvr > 0.0f) referenced += report.after.acmr * t / report.after.atvr;
+                        counts.triangles += mesh.indices.size() / 3;
+                        counts.bytes += mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(uint32_t);
+                        ++counts.items;
+                    } catch (const std::exception& e) {
+                        counts.Fail("mesh", e);
+                    }
+                }
+                if (triangles > 0.0) {
+                    before = { float(missesBefore / triangles), float(missesBefore / referenced) };
+                    after = { float(missesAfter / triangles), float(missesAfter / referenced) };
+                }
+                return counts;
+            }));
+            char line[128];
+            std::snprintf(line, sizeof(line), "vertex cache (FIFO 16): ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+                          before.acmr, after.acmr, before.atvr, after.atvr);
+            summary += line;
+
+            // зŻϽУ߳һ
+            std::vector<B3DMLoader::MeshData> optimized;
+            for (const auto& mesh : meshes) {
+                try {
+                    B3DMLoader::MeshData copy = mesh;
+                    MeshOptimizer::Optimize(copy.vertices, copy.indices);
+                    optimized.push_back(std::move(copy));
+                } catch (const std::exception&) {
+                    // ʧһ׶α
+                }
+            }
+            size_t meshletCount = 0, meshletTriangles = 0, cones = 0;
+            results.push_back(RunStage("meshlets", iterations, [&]() {
+                PassCounts counts;
+                meshletCount = meshletTriangles = cones = 0;
+                for (const auto& mesh : optimized) {
+                    try {
+                        std::vector<uint32_t> indices = mesh.indices;
+                        const auto meshlets = MeshletBuilder::Build(mesh.vertices, indices);
+                        for (const auto& meshlet : meshlets) {
+                            meshletTriangles += meshlet.indexCount / 3;
+                            cones += meshlet.coneCutoff < 1.0f;
+                        }
+                        meshletCount += meshlets.size();
+                        counts.triangles += mesh.indices.size() / 3;
+                        counts.bytes += mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(uint32_t);
+                        ++counts.items;
+                    } catch (const std::exception& e) {
+                        counts.Fail("mesh", e);
+                    }
+                }
+                return counts;
+            }));
+            if (meshletCount > 0) {
+                std::snprintf(line, sizeof(line), "meshlets: %zu, %.1f triangles each, %.0f%% with a normal cone\n",
+                              meshletCount, double(meshletTriangles) / meshletCount, 100.0 * cones / meshletCount);
+                summary += line;
+            }
+        }
+    }
+
+    if (results.empty()) {
+        std::cerr << "ûпɲԵ tileset Ƭļ: " << input << std::endl;
+        return 1;
+    }
+
+    PrintHeader();
+    for (const auto& result : results) PrintStage(result);
+    if (!summary.empty()) std::cout << '\n' << summary;
+    return mismatch ? 1 : 0;
+}
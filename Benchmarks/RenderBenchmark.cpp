@@ -0,0 +1,496 @@
+// RenderBenchmark.cpp
+// ޽Ⱦǰ˻׼ںϳɳϲÿ֡ύǰ CPU Χ¡׶޳
+//  BVH Ĺ¡޳/Χѯֵӽǳгϵڵ޳
+// Լб򣨱Ƚ 64 λĻ򣩡
+//  GL ģû GPU ĻС
+//
+// ÷: RenderBenchmark [--entities N] [--city N] [--draws N] [--iterations N] [--seed N]
+//   --entities N    ʵĬ 200000
+//   --city N        гÿߵĽĬ 40
+//   --draws N       ĻĬ 100000
+//   --iterations N  ÿ׶ظ N ΣȡһΣĬ 20
+//   --seed N        ӣĬ 1
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Render/Frustum.h"
+#include "Render/FrustumCuller.h"
+#include "Render/BoundingVolumeHierarchy.h"
+#include "Render/OcclusionCuller.h"
+#include "Render/RenderQueue.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// ϳɳеһʵ壨AoSģʵϵİΧ壩
+struct SceneEntity {
+    glm::vec3 center;
+    float radius;
+};
+
+/// õʵ壺ȾС״̬ģ;󣬰 shared_ptr У SceneManager ͬ
+struct DrawEntity {
+    int queue;
+    const void* shader;
+    const void* material;
+    const void* mesh;
+    glm::mat4 model;
+    glm::vec3 boundsCenter;
+
+    bool IsTransparent() const { return queue > 2500; }
+    float GetDepth(const glm::mat4& view) const {
+        const glm::vec4 position = view * model[3];
+        return position.z / position.w;
+    }
+};
+
+struct StageResult {
+    std::string name;
+    size_t items = 0;          // ÿδʵ
+    size_t output = 0;         // ɼȽ
+    double bestSeconds = 0.0;
+};
+
+/// ظһα¼ʱpass ؽ
+StageResult RunStage(const std::string& name, size_t items, int iterations, const std::function<size_t()>& pass) {
+    StageResult result;
+    result.name = name;
+    result.items = items;
+    result.bestSeconds = -1.0;
+    for (int i = 0; i < iterations; ++i) {
+        const auto start = Clock::now();
+        result.output = pass();
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (result.bestSeconds < 0.0 || seconds < result.bestSeconds) result.bestSeconds = seconds;
+    }
+    return result;
+}
+
+void PrintHeader() {
+    std::printf("%-22s %9s %10s %11s %9s\n", "stage", "items", "best ms", "Mitems/s", "output");
+}
+
+void PrintStage(const StageResult& r) {
+    const double seconds = std::max(r.bestSeconds, 1e-9);
+    std::printf("%-22s %9zu %10.3f %11.1f %9zu\n",
+                r.name.c_str(), r.items, r.bestSeconds * 1000.0, static_cast<double>(r.items) / seconds / 1e6,
+                r.output);
+}
+
+void PrintUsage() {
+    std::printf("÷: RenderBenchmark [--entities N] [--city N] [--draws N] [--iterations N] [--seed N]\n"
+                "  --entities N    ʵĬ 200000\n"
+                "  --city N        гÿߵĽĬ 40\n"
+                "  --draws N       ĻĬ 100000\n"
+                "  --iterations N  ÿ׶ظ N ΣȡһΣĬ 20\n"
+                "  --seed N        ӣĬ 1\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t entityCount = 200000;
+    int iterations = 20;
+    unsigned seed = 1;
+    int citySize = 40;
+    size_t drawCount = 100000;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--entities" && i + 1 < argc) {
+            entityCount = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--city" && i + 1 < argc) {
+            citySize = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--draws" && i + 1 < argc) {
+            drawCount = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--help" || arg == "-h") {
+            PrintUsage();
+            return 0;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    // ---- ϳɳʵȷֲڱ߳ 2000 УλģԼ 1/10 ɼ ----
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> size(0.5f, 5.0f);
+    std::vector<SceneEntity> scene(entityCount);
+    for (auto& entity : scene) entity = { glm::vec3(position(rng), position(rng), position(rng)), size(rng) };
+
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1500.0f);
+    const Frustum frustum(projection * view);
+
+    std::printf(": %zu ʵ,  %d , ʵ %s\n\n", entityCount, iterations,
+                FrustumCuller::BackendName(FrustumCuller::BestBackend()));
+    PrintHeader();
+
+    FrustumCuller culler;
+    culler.Resize(entityCount);
+    PrintStage(RunStage("update bounds (SoA)", entityCount, iterations, [&]() {
+        for (size_t i = 0; i < scene.size(); ++i) culler.SetSphere(i, scene[i].center, scene[i].radius);
+        return scene.size();
+    }));
+
+    // գʵ Frustum::IntersectsSphereĶǰԵдͬ
+    std::vector<uint32_t> reference;
+    PrintStage(RunStage("cull per-entity", entityCount, iterations, [&]() {
+        reference.clear();
+        for (size_t i = 0; i < scene.size(); ++i) {
+            if (frustum.IntersectsSphere(scene[i].center, scene[i].radius))
+                reference.push_back(static_cast<uint32_t>(i));
+        }
+        return reference.size();
+    }));
+
+    std::vector<uint32_t> visible;
+    bool mismatch = false;
+    for (auto backend : { FrustumCuller::Backend::Scalar, FrustumCuller::Backend::SSE, FrustumCuller::Backend::AVX }) {
+        if (!FrustumCuller::IsSupported(backend)) continue;
+        const std::string name = std::string("cull SoA ") + FrustumCuller::BackendName(backend);
+        PrintStage(RunStage(name, entityCount, iterations, [&]() {
+            return culler.Cull(frustum, visible, backend);
+        }));
+        if (visible != reference) {
+            std::printf("    ʵԲһ\n");
+            mismatch = true;
+        }
+    }
+
+    // ---- BVHʵ԰ΧӺʵ Frustum::IntersectsAABB ----
+    using BVH = BoundingVolumeHierarchy;
+    std::vector<BVH::AABB> boxes(entityCount);
+    for (size_t i = 0; i < scene.size(); ++i) boxes[i] = { scene[i].center - scene[i].radius, scene[i].center + scene[i].radius };
+
+    std::printf("\n");
+    PrintHeader();
+    BVH bvh;
+    std::vector<BVH::ProxyId> proxies(entityCount);
+    const auto insertAll = [&]() {
+        bvh.Clear();
+        for (size_t i = 0; i < boxes.size(); ++i) proxies[i] = bvh.Insert(boxes[i], static_cast<uint32_t>(i));
+        return bvh.Size();
+    };
+    PrintStage(RunStage("bvh insert", entityCount, iterations, insertAll));
+    const BVH::Statistics incremental = bvh.GetStatistics();
+    PrintStage(RunStage("bvh rebuild (SAH)", entityCount, iterations, [&]() {
+        bvh.Rebuild();
+        return bvh.Size();
+    }));
+    const BVH::Statistics rebuilt = bvh.GetStatistics();
+
+    std::vector<uint32_t> boxReference;
+    PrintStage(RunStage("cull per-entity AABB", entityCount, iterations, [&]() {
+        boxReference.clear();
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            if (frustum.IntersectsAABB(boxes[i].min, boxes[i].max)) boxReference.push_back(static_cast<uint32_t>(i));
+        }
+        return boxReference.size();
+    }));
+    PrintStage(RunStage("cull BVH", entityCount, iterations, [&]() {
+        return (bvh.Cull(frustum, visible), visible.size());
+    }));
+    std::sort(visible.begin(), visible.end());
+    if (visible != boxReference) {
+        std::printf("    ʵԲһ\n");
+        mismatch = true;
+    }
+
+    // ÿƶ 10% ʵ壨ÿ֡СλƣֺڵֻҶڵ
+    std::uniform_int_distribution<size_t> pick(0, entityCount - 1);
+    std::uniform_real_distribution<float> drift(-0.25f, 0.25f);
+    std::uniform_real_distribution<float> step(-1.0f, 1.0f);
+    const size_t moveCount = std::max<size_t>(1, entityCount / 10);
+    size_t reinserted = 0;
+    PrintStage(RunStage("bvh move 10%", moveCount, iterations, [&]() {
+        size_t count = 0;
+        for (size_t k = 0; k < moveCount; ++k) {
+            const size_t i = pick(rng);
+            const glm::vec3 delta(drift(rng), drift(rng), drift(rng));
+            boxes[i].min += delta;
+            boxes[i].max += delta;
+            count += bvh.Move(proxies[i], boxes[i]);
+        }
+        reinserted += count;
+        return count;
+    }));
+
+    // ߣӹ۲򣬻ص԰Χ룻ձ
+    const auto enterDistance = [](const glm::vec3& origin, const glm::vec3& inverse, const BVH::AABB& box) {
+        const glm::vec3 t0 = (box.min - origin) * inverse, t1 = (box.max - origin) * inverse;
+        const glm::vec3 tmin = glm::min(t0, t1), tmax = glm::max(t0, t1);
+        const float enter = std::max(std::max(tmin.x, tmin.y), std::max(tmin.z, 0.0f));
+        const float exit = std::min(std::min(tmax.x, tmax.y), tmax.z);
+        return enter <= exit ? enter : -1.0f;
+    };
+    constexpr size_t RayCount = 1000;
+    std::vector<glm::vec3> rays(RayCount);
+    for (auto& ray : rays) ray = glm::normalize(glm::vec3(step(rng), step(rng), step(rng)) + glm::vec3(0.0f, 0.0f, -0.5f));
+    std::vector<float> hits(RayCount);
+    PrintStage(RunStage("raycast BVH", RayCount, iterations, [&]() {
+        size_t count = 0;
+        for (size_t r = 0; r < RayCount; ++r) {
+            const glm::vec3 inverse = 1.0f / rays[r];
+            uint32_t item = 0;
+            float distance = std::numeric_limits<float>::max();
+            const bool hit = bvh.Raycast(glm::vec3(0.0f), rays[r], [&](uint32_t i, float) {
+                return enterDistance(glm::vec3(0.0f), inverse, boxes[i]);
+            }, item, distance);
+            hits[r] = hit ? distance : -1.0f;
+            count += hit;
+        }
+        return count;
+    }));
+    size_t rayMismatch = 0;
+    for (size_t r = 0; r < RayCount; ++r) {
+        const glm::vec3 inverse = 1.0f / rays[r];
+        float nearest = -1.0f;
+        for (const auto& box : boxes) {
+            const float d = enterDistance(glm::vec3(0.0f), inverse, box);
+            if (d >= 0.0f && (nearest < 0.0f || d < nearest)) nearest = d;
+        }
+        rayMismatch += nearest != hits[r];
+    }
+    if (rayMismatch) {
+        std::printf("    %zu 뱩󽻲һ\n", rayMismatch);
+        mismatch = true;
+    }
+
+    const BVH::AABB range{ glm::vec3(-100.0f), glm::vec3(100.0f) };
+    std::vector<uint32_t> inRange;
+    PrintStage(RunStage("range query BVH", entityCount, iterations, [&]() {
+        return (bvh.Query(range, inRange), inRange.size());
+    }));
+    const size_t rangeReference = static_cast<size_t>(std::count_if(boxes.begin(), boxes.end(),
+        [&](const BVH::AABB& box) { return box.Overlaps(range); }));
+    if (inRange.size() != rangeReference) {
+        std::printf("    Χѯ뱩һ\n");
+        mismatch = true;
+    }
+
+    const BVH::Statistics moved = bvh.GetStatistics();
+    std::printf("\nBVH: ߶ %d ( %d)ڲڵ %.1f ( %.1f)ƶ %.1f² %zu \n",
+                rebuilt.height, incremental.height, rebuilt.areaRatio, incremental.areaRatio, moved.areaRatio, reinserted);
+
+    // ---- ڵ޳ϵ¥ 10~80ֱС壬λڽֵСؽֵ ----
+    // ÿʵǵλ徭ģ;ƽƣ¥ڵ壨12 Σ
+    const glm::vec3 cube[8] = { {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}, {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1} };
+    const uint32_t cubeIndices[36] = { 0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7, 0, 1, 5, 0, 5, 4,
+                                       3, 7, 6, 3, 6, 2, 0, 4, 7, 0, 7, 3, 1, 2, 6, 1, 6, 5 };
+    constexpr float BlockPitch = 40.0f, Footprint = 30.0f;
+    std::uniform_real_distribution<float> storeys(10.0f, 80.0f), offset(0.0f, Footprint), propSize(0.5f, 2.5f);
+    std::vector<glm::mat4> buildings, props;
+    const float cityOrigin = -0.5f * citySize * BlockPitch;
+    for (int bx = 0; bx < citySize; ++bx) {
+        for (int bz = 0; bz < citySize; ++bz) {
+            const glm::vec3 corner(cityOrigin + bx * BlockPitch, 0.0f, cityOrigin + bz * BlockPitch);
+            buildings.push_back(glm::scale(glm::translate(glm::mat4(1.0f), corner), glm::vec3(Footprint, storeys(rng), Footprint)));
+            // ܵĽֵϷС
+            for (int k = 0; k < 8; ++k) {
+                const float size = propSize(rng);
+                const glm::vec3 position = (k & 1) ? corner + glm::vec3(offset(rng), 0.0f, Footprint + 2.0f)
+                                                   : corner + glm::vec3(Footprint + 2.0f, 0.0f, offset(rng));
+                props.push_back(glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(size)));
+            }
+        }
+    }
+    std::vector<glm::mat4> cityEntities = buildings;
+    cityEntities.insert(cityEntities.end(), props.begin(), props.end());
+
+    const glm::vec3 eye(cityOrigin + Footprint + 0.5f * (BlockPitch - Footprint), 1.7f, -cityOrigin);
+    const glm::mat4 streetView = glm::lookAt(eye, eye + glm::vec3(0.05f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const glm::mat4 streetViewProjection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 2000.0f) * streetView;
+    const Frustum streetFrustum(streetViewProjection);
+
+    // ׶ڵʵ壬Լӽ 32 ¥Ϊڵ
+    std::vector<uint32_t> inFrustum;
+    std::vector<std::pair<float, uint32_t>> candidates;
+    for (size_t i = 0; i < cityEntities.size(); ++i) {
+        const glm::vec3 lo(cityEntities[i] * glm::vec4(0, 0, 0, 1)), hi(cityEntities[i] * glm::vec4(1, 1, 1, 1));
+        if (!streetFrustum.IntersectsAABB(lo, hi)) continue;
+        inFrustum.push_back(static_cast<uint32_t>(i));
+        if (i < buildings.size()) {
+            const glm::vec3 center = 0.5f * (lo + hi);
+            candidates.emplace_back(0.5f * glm::length(hi - lo) / std::max(glm::length(center - eye), 1.0f),
+                                    static_cast<uint32_t>(i));
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    candidates.resize(std::min<size_t>(candidates.size(), 32));
+
+    std::printf("\n: %zu ¥%zu С, ׶ %zu , ڵ %zu , Ȼ 256x128\n",
+                buildings.size(), props.size(), inFrustum.size(), candidates.size());
+    PrintHeader();
+    OcclusionCuller occlusion;
+    std::vector<float> referenceDepth;
+    for (auto backend : { OcclusionCuller::Backend::Scalar, OcclusionCuller::Backend::SSE }) {
+        if (!OcclusionCuller::IsSupported(backend)) continue;
+        const std::string name = std::string("occluder raster ") + OcclusionCuller::BackendName(backend);
+        PrintStage(RunStage(name, candidates.size() * 12, iterations, [&]() {
+            occlusion.Begin(streetViewProjection);
+            for (const auto& [size, index] : candidates)
+                occlusion.RasterizeOccluder(cityEntities[index], &cube[0].x, sizeof(glm::vec3), 8, cubeIndices, 36, backend);
+            return occlusion.GetStatistics().rasterizedTriangles;
+        }));
+        const std::vector<float> depth = occlusion.GetDepth();
+        if (referenceDepth.empty()) {
+            referenceDepth = depth;
+        } else if (depth != referenceDepth) {
+            std::printf("    Ȼʵֲһ\n");
+            mismatch = true;
+        }
+    }
+    PrintStage(RunStage("hi-z build", static_cast<size_t>(occlusion.GetWidth()) * occlusion.GetHeight(), iterations, [&]() {
+        occlusion.BuildHiZ();
+        return static_cast<size_t>(occlusion.GetWidth()) * occlusion.GetHeight();
+    }));
+    PrintStage(RunStage("occlusion test", inFrustum.size(), iterations, [&]() {
+        size_t count = 0;
+        for (uint32_t index : inFrustum) count += occlusion.IsVisible(cityEntities[index], glm::vec3(0.0f), glm::vec3(1.0f));
+        return count;
+    }));
+
+    // Լ飺޳ʵĲ㣨ÿ 2525׶߲κڵ壬Ϊ
+    auto segmentBlocked = [&](const glm::vec3& target) {
+        const glm::vec3 direction = target - eye;
+        for (const auto& [size, index] : candidates) {
+            const glm::vec3 lo(cityEntities[index] * glm::vec4(0, 0, 0, 1)), hi(cityEntities[index] * glm::vec4(1, 1, 1, 1));
+            float enter = 0.0f, leave = 0.999f;  // Ŀ㱾ڵı
+            for (int axis = 0; axis < 3 && enter <= leave; ++axis) {
+                if (std::abs(direction[axis]) < 1e-12f) {
+                    if (eye[axis] < lo[axis] || eye[axis] > hi[axis]) leave = -1.0f;
+                    continue;
+                }
+                float t0 = (lo[axis] - eye[axis]) / direction[axis], t1 = (hi[axis] - eye[axis]) / direction[axis];
+                if (t0 > t1) std::swap(t0, t1);
+                enter = std::max(enter, t0);
+                leave = std::min(leave, t1);
+            }
+            if (enter <= leave) return true;
+        }
+        return false;
+    };
+    size_t culled = 0, wronglyCulled = 0;
+    for (uint32_t index : inFrustum) {
+        if (std::any_of(candidates.begin(), candidates.end(), [&](const auto& c) { return c.second == index; })) continue;
+        if (occlusion.IsVisible(cityEntities[index], glm::vec3(0.0f), glm::vec3(1.0f))) continue;
+        ++culled;
+        bool visible = false;
+        for (int face = 0; face < 6 && !visible; ++face) {
+            for (int i = 0; i < 25 && !visible; ++i) {
+                for (int j = 0; j < 25 && !visible; ++j) {
+                    glm::vec3 local(0.0f);
+                    local[face % 3] = face < 3 ? 0.0f : 1.0f;
+                    local[(face + 1) % 3] = i / 24.0f;
+                    local[(face + 2) % 3] = j / 24.0f;
+                    const glm::vec3 point(cityEntities[index] * glm::vec4(local, 1.0f));
+                    const glm::vec4 clip = streetViewProjection * glm::vec4(point, 1.0f);
+                    if (!(clip.w > 0.0f) || std::abs(clip.x) > clip.w || std::abs(clip.y) > clip.w) continue;
+                    visible = !segmentBlocked(point);
+                }
+            }
+        }
+        wronglyCulled += visible;
+    }
+    std::printf("    ڵ޳ %zu  %zu \n", culled, wronglyCulled);
+    if (wronglyCulled > 0) mismatch = true;
+
+    // ---- 8 ɫ64 ʡ1000 10% Ϊ͸ 3000 ----
+    std::vector<unsigned char> stateObjects(8 + 64 + 1000);
+    std::uniform_int_distribution<int> shaderOf(0, 7), materialOf(0, 63), meshOf(0, 999), percent(0, 99);
+    std::vector<std::shared_ptr<DrawEntity>> draws(drawCount);
+    for (auto& draw : draws) {
+        const glm::vec3 center(position(rng), position(rng), position(rng));
+        draw = std::make_shared<DrawEntity>(DrawEntity{ percent(rng) < 10 ? 3000 : 2000,
+            &stateObjects[shaderOf(rng)], &stateObjects[8 + materialOf(rng)], &stateObjects[72 + meshOf(rng)],
+            glm::translate(glm::mat4(1.0f), center), glm::vec3(0.0f) });
+    }
+
+    std::printf("\n");
+    PrintHeader();
+    // ԭ򣬷ֳ͸壬ٰÿαȽ¼ȣ
+    std::vector<std::shared_ptr<DrawEntity>> comparatorOrder;
+    PrintStage(RunStage("sort comparator", drawCount, iterations, [&]() {
+        comparatorOrder = draws;
+        std::sort(comparatorOrder.begin(), comparatorOrder.end(),
+                  [](const auto& a, const auto& b) { return a->queue < b->queue; });
+        auto transparentStart = std::partition(comparatorOrder.begin(), comparatorOrder.end(),
+                                               [](const auto& e) { return !e->IsTransparent(); });
+        std::sort(transparentStart, comparatorOrder.end(),
+                  [&](const auto& a, const auto& b) { return a->GetDepth(view) > b->GetDepth(view); });
+        return comparatorOrder.size();
+    }));
+
+    // SceneManager ÿ֡Ϊɼʵ建һӾ࣬ڵ޳ƹ
+    std::vector<glm::mat4> worldMatrices(draws.size());
+    std::vector<float> viewDepths(draws.size());
+    PrintStage(RunStage("transform cache", drawCount, iterations, [&]() {
+        for (size_t i = 0; i < draws.size(); ++i) {
+            worldMatrices[i] = draws[i]->model;
+            viewDepths[i] = -(view * (worldMatrices[i] * glm::vec4(draws[i]->boundsCenter, 1.0f))).z;
+        }
+        return viewDepths.size();
+    }));
+
+    RenderQueue drawQueue;
+    const auto buildKeys = [&]() {
+        drawQueue.Clear();
+        drawQueue.Reserve(draws.size());
+        for (size_t i = 0; i < draws.size(); ++i) {
+            const DrawEntity& draw = *draws[i];
+            const float depth = viewDepths[i];
+            drawQueue.Push(draw.IsTransparent()
+                               ? RenderQueue::TransparentKey(draw.queue, draw.shader, draw.material, draw.mesh, depth)
+                               : RenderQueue::OpaqueKey(draw.queue, draw.shader, draw.material, draw.mesh, depth),
+                           static_cast<uint32_t>(i));
+        }
+        return drawQueue.Size();
+    };
+    PrintStage(RunStage("draw keys build", drawCount, iterations, buildKeys));
+
+    // գͬļ stable_sort 
+    struct KeyedDraw {
+        uint64_t key;
+        uint32_t index;
+    };
+    std::vector<KeyedDraw> unsorted(drawQueue.Size()), stableOrder;
+    for (size_t i = 0; i < unsorted.size(); ++i) unsorted[i] = { drawQueue.GetKey(i), drawQueue.GetIndex(i) };
+    PrintStage(RunStage("std::stable_sort keys", drawCount, iterations, [&]() {
+        stableOrder = unsorted;
+        std::stable_sort(stableOrder.begin(), stableOrder.end(),
+                         [](const KeyedDraw& a, const KeyedDraw& b) { return a.key < b.key; });
+        return stableOrder.size();
+    }));
+    PrintStage(RunStage("radix sort keys", drawCount, iterations, [&]() {
+        drawQueue.Clear();
+        for (const KeyedDraw& draw : unsorted) drawQueue.Push(draw.key, draw.index);
+        drawQueue.Sort();
+        return drawQueue.Size();
+    }));
+    bool sameOrder = drawQueue.Size() == stableOrder.size();
+    for (size_t i = 0; sameOrder && i < stableOrder.size(); ++i)
+        sameOrder = drawQueue.GetKey(i) == stableOrder[i].key && drawQueue.GetIndex(i) == stableOrder[i].index;
+    if (!sameOrder) {
+        std::printf("     stable_sort һ\n");
+        mismatch = true;
+    }
+    return mismatch ? 1 : 0;
+}
@@ -2,7 +2,7 @@
 
 // 붥
 layout (location = 0) in vec3 aPos;  
-layout (location = 1) in vec3 aNormal;
+layout (location = 1) in vec3 aNormal;  // ʽֻ xyΪ
 
 // ݵƬɫı
 out vec3 Normal;     //  
@@ -12,7 +12,21 @@ uniform mat4 uModel;
 uniform mat4 uView;
 uniform mat4 uProjection;
 
+// ķFloat32 Ϊȱ任
+uniform vec3 uPositionOffset = vec3(0.0);
+uniform vec3 uPositionScale = vec3(1.0);
+uniform float uOctahedralNormals = 0.0;
+
+vec3 DecodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
 void main() {
-    gl_Position = uProjection * uView * uModel * vec4(aPos, 1.0);
-    Normal = aNormal; // ֱӴݷߣҪתΪռ䣩
+    vec3 position = uPositionOffset + uPositionScale * aPos;
+    gl_Position = uProjection * uView * uModel * vec4(position, 1.0);
+    Normal = uOctahedralNormals > 0.5 ? DecodeOctahedral(aNormal.xy) : aNormal; // ֱӴݷߣҪתΪռ䣩
 }
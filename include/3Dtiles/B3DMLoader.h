@@ -1,11 +1,13 @@
 ﻿#pragma once
 #include <vector>
+#include <span>
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
 #include <cstring>
 #include "Core/EndianUtils.h"
+#include "Core/MappedFile.h"
 #include <iostream> 
 #include "GLTF1Parser.h"
 #include <filesystem>
@@ -37,62 +39,68 @@ public:
         uint32_t btBinLen;
     };
 
-    static Mesh LoadFromFile(const std::string& path) {
-        std::cout << "开始加载模型文件: " << path << std::endl;
-
-        std::ifstream file(path, std::ios::binary);
-        if (!file) throw std::runtime_error("无法打开文件: " + path);
-
-        std::string ext = fs::path(path).extension().string();
-        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-
-        if (ext == ".glb") {
-            std::cout << " 识别为 GLB 文件，准备直接解析..." << std::endl;
-
-            file.seekg(0, std::ios::end);
-            size_t fileSize = file.tellg();
-            file.seekg(0, std::ios::beg);
-
-            std::vector<uint8_t> glbData(fileSize);
-            file.read(reinterpret_cast<char*>(glbData.data()), fileSize);
-            if (!file) throw std::runtime_error("无法完整读取GLB数据");
-
-            std::cout << "读取GLB数据完毕，共 " << fileSize << " 字节" << std::endl;
+    /// b3dm 各段在文件内存中的视图（不持有数据）
+    struct B3DMView {
+        B3DMHeader header;
+        std::span<const uint8_t> featureTableJSON;
+        std::span<const uint8_t> featureTableBinary;
+        std::span<const uint8_t> batchTableJSON;
+        std::span<const uint8_t> batchTableBinary;
+        std::span<const uint8_t> glb;
+    };
 
-            Mirror::GLTF::GLTF1Parser::GLBHeader glbHeader;
-            std::memcpy(&glbHeader, glbData.data(), sizeof(glbHeader));
+    using MeshData = Mirror::GLTF::GLBParser::GLBData;
 
-            if (std::string_view(glbHeader.magic, 4) != "glTF")
-                throw std::runtime_error("无效的 GLB 魔数");
+    /**
+     * 加载并上传到 GPU，必须在 GL 线程调用
+     */
+    static Mesh LoadFromFile(const std::string& path) {
+        return Decode(path).ToMesh();
+    }
 
-            uint32_t glbVersion = Mirror::Core::EndianUtils::FromLittleEndian(glbHeader.version);
-            std::cout << "GLB版本: " << glbVersion << std::endl;
+    /**
+     * 只读取并解析为 CPU 侧的顶点/索引，不触碰 OpenGL，可在工作线程调用。
+     * 文件以内存映射方式打开，各段直接在映射上解析，不经过中间缓冲。
+     */
+    static MeshData Decode(const std::string& path) {
+        std::cout << "开始加载模型文件: " << path << std::endl;
+        const Mirror::Core::MappedFile file(path);
+        return Decode(file.Bytes());
+    }
 
-            if (glbVersion == 1) {
-                std::cout << "使用 GLTF 1.0 解析器..." << std::endl;
-                return Mirror::GLTF::GLTF1Parser::Parse(glbData).ToMesh();
-            } else if (glbVersion == 2) {
-                std::cout << "使用 GLTF 2.0 解析器..." << std::endl;
-                return Mirror::GLTF::GLBParser::Parse(glbData).ToMesh();
-            } else {
-                throw std::runtime_error("不支持的GLB版本: " + std::to_string(glbVersion));
-            }
+    /**
+     * 解析内存中的 b3dm 或 glb（按魔数识别）
+     */
+    static MeshData Decode(std::span<const uint8_t> bytes) {
+        if (bytes.size() >= 4 && std::memcmp(bytes.data(), "glTF", 4) == 0) {
+            std::cout << " 识别为 GLB 文件，准备直接解析..." << std::endl;
+            return DecodeGLB(bytes);
         }
 
-        // === 默认处理 .b3dm 文件 ===
         std::cout << "识别为 B3DM 文件，准备解析..." << std::endl;
+        const B3DMView view = ParseB3DM(bytes);
+        std::cout << "嵌入GLB数据定位成功，大小: " << view.glb.size() << " 字节" << std::endl;
+        return DecodeGLB(view.glb);
+    }
+
+    /**
+     * 解析 b3dm 头部并划分各段，返回的 span 指向传入的内存
+     */
+    static B3DMView ParseB3DM(std::span<const uint8_t> bytes) {
+        if (bytes.size() < sizeof(PackedB3DMHeader))
+            throw std::runtime_error("无法读取 B3DM Header");
 
         PackedB3DMHeader packed;
-        file.read(reinterpret_cast<char*>(&packed), sizeof(packed));
-        if (!file) throw std::runtime_error("无法读取 B3DM Header");
+        std::memcpy(&packed, bytes.data(), sizeof(packed));
 
-        auto readU32 = [&](const uint8_t* bytes) {
+        auto readU32 = [](const uint8_t* p) {
             uint32_t v;
-            std::memcpy(&v, bytes, sizeof(v));
+            std::memcpy(&v, p, sizeof(v));
             return Mirror::Core::EndianUtils::FromLittleEndian(v);
         };
 
-        B3DMHeader hdr;
+        B3DMView view;
+        B3DMHeader& hdr = view.header;
         std::memcpy(hdr.magic, packed.magic, 4);
         hdr.version    = readU32(packed.version);
         hdr.byteLength = readU32(packed.byteLength);
@@ -103,46 +111,63 @@ public:
 
         if (std::string_view(hdr.magic, 4) != "b3dm")
             throw std::runtime_error("无效的B3DM魔数");
+        if (hdr.byteLength > bytes.size())
+            throw std::runtime_error("B3DM 数据不完整: 声明 " + std::to_string(hdr.byteLength)
+                                     + " 字节，实际 " + std::to_string(bytes.size()) + " 字节");
+
+        // 依次切出各段，越界即视为损坏
+        auto pad4 = [](uint64_t n){ return (n + 3) & ~uint64_t(3); };
+        uint64_t offset = sizeof(PackedB3DMHeader);
+        auto take = [&](uint32_t length) {
+            if (offset + length > hdr.byteLength)
+                throw std::runtime_error("B3DM 段长度越界");
+            auto section = bytes.subspan(static_cast<size_t>(offset), length);
+            offset = pad4(offset + length);
+            return section;
+        };
+        view.featureTableJSON   = take(hdr.ftJSONLen);
+        view.featureTableBinary = take(hdr.ftBinLen);
+        view.batchTableJSON     = take(hdr.btJSONLen);
+        view.batchTableBinary   = take(hdr.btBinLen);
+
+        if (offset >= hdr.byteLength)
+            throw std::runtime_error("B3DM 缺少嵌入的GLB数据");
+        view.glb = bytes.subspan(static_cast<size_t>(offset), static_cast<size_t>(hdr.byteLength - offset));
+        return view;
+    }
 
-        auto pad4 = [](uint32_t n){ return (n + 3) & ~3u; };
-        size_t offset = sizeof(PackedB3DMHeader)
-                      + pad4(hdr.ftJSONLen)
-                      + pad4(hdr.ftBinLen)
-                      + pad4(hdr.btJSONLen)
-                      + pad4(hdr.btBinLen);
-
-        std::cout << "B3DM头部信息解析:\n"
-                  << " - 版本: " << hdr.version << "\n"
-                  << " - 总长度: " << hdr.byteLength << "\n"
-                  << " - FeatureTable JSON 长度: " << hdr.ftJSONLen << "（对齐后: " << pad4(hdr.ftJSONLen) << "）\n"
-                  << " - FeatureTable Binary 长度: " << hdr.ftBinLen << "（对齐后: " << pad4(hdr.ftBinLen) << "）\n"
-                  << " - BatchTable JSON 长度: " << hdr.btJSONLen << "（对齐后: " << pad4(hdr.btJSONLen) << "）\n"
-                  << " - BatchTable Binary 长度: " << hdr.btBinLen << "（对齐后: " << pad4(hdr.btBinLen) << "）\n"
-                  << " - 计算得到的GLB偏移: " << offset << "\n";
-
-        file.seekg(offset);
-        std::vector<uint8_t> glbData(hdr.byteLength - offset);
-        file.read(reinterpret_cast<char*>(glbData.data()), glbData.size());
-        if (!file) throw std::runtime_error("无法读取嵌入的GLB数据");
-
-        std::cout << "嵌入GLB数据读取成功，大小: " << glbData.size() << " 字节" << std::endl;
+    /**
+     * 解析 GLB（glTF 1.0 / 2.0）
+     */
+    static MeshData DecodeGLB(std::span<const uint8_t> glbData) {
+        if (glbData.size() < sizeof(Mirror::GLTF::GLTF1Parser::GLBHeader))
+            throw std::runtime_error("GLB数据过短");
 
         Mirror::GLTF::GLTF1Parser::GLBHeader glbHeader;
         std::memcpy(&glbHeader, glbData.data(), sizeof(glbHeader));
         if (std::string_view(glbHeader.magic, 4) != "glTF")
-            throw std::runtime_error("嵌入GLB魔数无效");
+            throw std::runtime_error("无效的 GLB 魔数");
 
         uint32_t glbVersion = Mirror::Core::EndianUtils::FromLittleEndian(glbHeader.version);
-        std::cout << "嵌入GLB版本: " << glbVersion << std::endl;
+        std::cout << "GLB版本: " << glbVersion << std::endl;
 
         if (glbVersion == 1) {
-            std::cout << "使用 GLTF 1.0 解析器解析嵌入GLB..." << std::endl;
-            return Mirror::GLTF::GLTF1Parser::Parse(glbData).ToMesh();
+            std::cout << "使用 GLTF 1.0 解析器..." << std::endl;
+            return FromGLTF1(Mirror::GLTF::GLTF1Parser::Parse(glbData));
         } else if (glbVersion == 2) {
-            std::cout << "使用 GLTF 2.0 解析器解析嵌入GLB..." << std::endl;
-            return Mirror::GLTF::GLBParser::Parse(glbData).ToMesh();
+            std::cout << "使用 GLTF 2.0 解析器..." << std::endl;
+            return Mirror::GLTF::GLBParser::Parse(glbData);
         } else {
-            throw std::runtime_error("不支持的嵌入GLB版本: " + std::to_string(glbVersion));
+            throw std::runtime_error("不支持的GLB版本: " + std::to_string(glbVersion));
         }
     }
+
+private:
+    static MeshData FromGLTF1(const Mirror::GLTF::GLTF1Parser::MeshData& gltf1) {
+        MeshData data;
+        data.vertices = gltf1.BuildVertices();
+        data.indices.assign(gltf1.indices.begin(), gltf1.indices.end());
+        data.transform = gltf1.transform;
+        return data;
+    }
 };
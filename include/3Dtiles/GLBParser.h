@@ -1,6 +1,7 @@
 ﻿// GLBParser.h
 #pragma once
 #include <vector>
+#include <span>
 #include <glm/glm.hpp>
 // 在包含GLM头文件的位置添加
 #include <glm/gtc/type_ptr.hpp>  // 必须包含的value_ptr来源
@@ -32,9 +33,22 @@ public:
         std::vector<unsigned int> indices;
         glm::mat4 transform = glm::mat4(1.0f);
         
-        Mesh ToMesh() const;
+        Mesh ToMesh() const &;
+        Mesh ToMesh() &&;   // 移动顶点/索引，避免再拷贝一次
     };
-    static GLBData Parse(const std::vector<uint8_t>& glbData);
+    /**
+     * @brief 解析 glTF 2.0 GLB
+     *
+     * 只解析引擎需要的 JSON 字段（accessors / bufferViews / buffers / meshes / nodes），
+     * 按 accessor 与 bufferView（含 byteStride）直接从 BIN 块读取并写入最终的 Vertex 布局，
+     * 不构建中间模型、不复制缓冲区。
+     */
+    static GLBData Parse(std::span<const uint8_t> glbData);
+
+    /**
+     * @brief 旧的 tinygltf 解析路径，保留用于对比测试与基准
+     */
+    static GLBData ParseWithTinyGLTF(std::span<const uint8_t> glbData);
 private:
     static void ProcessModel(const tinygltf::Model& model, GLBData& result);
     static void ProcessPrimitive(const tinygltf::Model& model,
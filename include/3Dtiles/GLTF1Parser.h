@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include <vector>
+#include <span>
 #include <string>
 #include <glm/glm.hpp>
 #include <json.hpp>
@@ -17,13 +18,18 @@ public:
         std::vector<uint32_t> indices;
         glm::mat4 transform = glm::mat4(1.0f);
 
-        ::Mesh ToMesh() const {
+        // 交错为 Vertex 数组（仅 CPU 操作，可在工作线程调用）
+        std::vector<Vertex> BuildVertices() const {
             std::vector<Vertex> verts;
             verts.reserve(positions.size());
             for (size_t i = 0; i < positions.size(); ++i) {
                 verts.push_back({positions[i], normals[i], texCoords.size()>i?texCoords[i]:glm::vec2(0.0f)});
             }
-            return ::Mesh(std::move(verts), std::vector<unsigned int>(indices.begin(), indices.end()));
+            return verts;
+        }
+
+        ::Mesh ToMesh() const {
+            return ::Mesh(BuildVertices(), std::vector<unsigned int>(indices.begin(), indices.end()));
         }
     };
 
@@ -39,11 +45,12 @@ public:
     };
     #pragma pack(pop)
 
-    static MeshData Parse(const std::vector<uint8_t>& data) { return GLTF1Parser().ParseImpl(data); }
+    // 直接在调用方的内存（例如映射的文件）上解析，二进制块不会被复制
+    static MeshData Parse(std::span<const uint8_t> data) { return GLTF1Parser().ParseImpl(data); }
 
 private:
-    MeshData ParseImpl(const std::vector<uint8_t>& data);
-    void ValidateGLBHeader(const GLBHeader& header, const std::vector<uint8_t>& data, size_t baseOffset);
+    MeshData ParseImpl(std::span<const uint8_t> data);
+    void ValidateGLBHeader(const GLBHeader& header, std::span<const uint8_t> data, size_t baseOffset);
     void ParseScene(const nlohmann::json& root);
     void ParseNode(const nlohmann::json& node);
     void ParseMesh(const nlohmann::json& mesh);
@@ -0,0 +1,93 @@
+﻿// TileCache.h
+#pragma once
+#include <list>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+#include "TileNode.h"
+#include "Render/Entity.h"
+
+/**
+ * @class TileCache
+ * @brief 按内存预算管理已加载瓦片的 LRU 缓存
+ *
+ * CPU 与 GPU 分别设置字节预算：
+ *  - CPU 超出预算时，按最近最少使用的顺序释放网格的 CPU 副本，GPU 缓冲保留，瓦片仍可渲染；
+ *    只释放完整副本仍不够时，再释放 PositionsOnly 留下的拾取副本；
+ *  - GPU 超出预算时，按同样顺序整块卸载最近若干帧未被选中的瓦片，再次需要时重新加载。
+ * 本帧（及 minIdleFrames 内）被选中的瓦片不会被卸载，因此预算只是软上限。
+ */
+class TileCache {
+public:
+    struct Options {
+        size_t   cpuBudgetBytes = size_t(256) << 20;  // CPU 侧网格数据预算
+        size_t   gpuBudgetBytes = size_t(512) << 20;  // GPU 缓冲预算
+        uint64_t minIdleFrames  = 1;                  // 至少连续多少帧未被选中才允许卸载
+    };
+
+    struct Statistics {
+        size_t residentTiles = 0;     // 驻留（GPU）瓦片数
+        size_t cpuResidentTiles = 0;  // 仍保留 CPU 副本的瓦片数
+        size_t cpuBytes = 0;
+        size_t gpuBytes = 0;
+        size_t hits = 0;              // 累计：选中时内容已驻留
+        size_t misses = 0;            // 累计：需要但未驻留（每次发出加载请求计一次）
+        size_t gpuEvictions = 0;      // 累计：整块卸载的瓦片
+        size_t cpuEvictions = 0;      // 累计：释放 CPU 副本（含拾取副本）的次数
+    };
+
+    TileCache() = default;
+    explicit TileCache(const Options& options) : options(options) {}
+
+    TileCache(const TileCache&) = delete;
+    TileCache& operator=(const TileCache&) = delete;
+
+    /// 开始新的一帧（推进 LRU 时钟）
+    void BeginFrame() { ++frame; }
+
+    /// 放入新加载的瓦片内容（视为本帧使用过）
+    void Insert(const TileNode& tile, std::shared_ptr<Entity> entity);
+
+    /// 是否驻留（不影响 LRU 与统计）
+    bool Contains(const TileNode& tile) const { return entries.count(&tile) != 0; }
+
+    /**
+     * @brief 取出本帧要使用的瓦片内容，计为一次命中并刷新 LRU 位置
+     * @return 未驻留时返回空（不计未命中，见 RecordMisses）
+     */
+    std::shared_ptr<Entity> Touch(const TileNode& tile);
+
+    /// 记录未命中：本帧新发出的加载请求数，同一瓦片等待加载期间不重复计入
+    void RecordMisses(size_t count) { stats.misses += count; }
+
+    /// 按预算释放 CPU 副本并卸载空闲瓦片
+    void Trim();
+
+    /// 卸载全部内容
+    void Clear();
+
+    const Statistics& GetStatistics() const { return stats; }
+
+    Options& GetOptions() { return options; }
+    const Options& GetOptions() const { return options; }
+
+private:
+    struct Entry {
+        const TileNode* tile = nullptr;
+        std::shared_ptr<Entity> entity;
+        size_t cpuBytes = 0;
+        size_t gpuBytes = 0;
+        uint64_t lastUsedFrame = 0;
+    };
+    using EntryList = std::list<Entry>;
+
+    void Measure(Entry& entry);
+    bool IsIdle(const Entry& entry) const { return entry.lastUsedFrame + options.minIdleFrames <= frame; }
+
+    Options options;
+    Statistics stats;
+    uint64_t frame = 0;
+
+    EntryList lru;  // 表头为最近使用
+    std::unordered_map<const TileNode*, EntryList::iterator> entries;
+};
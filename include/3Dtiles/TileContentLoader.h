@@ -0,0 +1,129 @@
+﻿// TileContentLoader.h
+#pragma once
+#include <deque>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include "TileNode.h"
+#include "B3DMLoader.h"
+#include "TilesetParser.h"
+#include "Render/LODChainBuilder.h"
+#include "Render/MeshOptimizer.h"
+#include "Render/MeshletBuilder.h"
+
+/**
+ * @class TileContentLoader
+ * @brief 异步瓦片内容加载服务
+ *
+ * 工作线程负责读取文件并解析 b3dm / glb 为 CPU 侧的顶点/索引数据，重排顶点与三角形顺序，
+ * 把稠密网格切分为可逐簇剔除的小簇，再生成离散 LOD 链；
+ * 外部 tileset 占位节点则解析为独立的 TileNode 子树；
+ * 完成的结果放入有界队列（队列满时工作线程阻塞，形成背压）；
+ * GL 线程每帧调用 ProcessCompleted，在时间预算内把 Mesh 上传到共享缓冲池或挂接子树。
+ * 上传后按 residency 策略处理网格的 CPU 副本；网格附带重新解码源文件的 Reloader，
+ * 需要完整数据时（如渐进简化）可按需重建。
+ */
+class TileContentLoader {
+public:
+    struct Options {
+        unsigned workerCount = 0;        // 0 表示 hardware_concurrency - 1（至少 1）
+        size_t maxCompletedResults = 16; // 等待上传的结果上限
+        TilesetParser::Options tileset;  // 解析外部 tileset 时使用
+        bool optimizeMeshes = true;            // 解码后做顶点缓存/过度绘制/顶点读取优化
+        MeshOptimizer::Options meshOptimizer;
+        bool buildMeshlets = true;             // 稠密网格切分为小簇，绘制时逐簇剔除
+        MeshletBuilder::Options meshlets;
+        LODChainBuilder::Options lodChain;  // maxLevels 不超过 1 时不生成离散 LOD
+        VertexFormat vertexFormat = VertexFormat::Quantized;  // 瓦片网格在 GPU 上的顶点格式
+        Mesh::Residency residency = Mesh::Residency::PositionsOnly;  // 上传后 CPU 副本的保留策略
+    };
+
+    using MeshData = B3DMLoader::MeshData;
+    using LoadedCallback = std::function<void(const TileNode&, std::shared_ptr<Mesh>)>;
+    using FailedCallback = std::function<void(const TileNode&, const std::string&)>;
+    using ExpandedCallback = std::function<void(const TileNode&, std::shared_ptr<TileNode>)>;
+
+    TileContentLoader() : TileContentLoader(Options{}) {}
+    explicit TileContentLoader(const Options& options);
+    ~TileContentLoader();
+
+    TileContentLoader(const TileContentLoader&) = delete;
+    TileContentLoader& operator=(const TileContentLoader&) = delete;
+
+    /**
+     * @brief 提交加载请求（线程安全）
+     * @param priority 优先级，数值越小越先解码
+     * @return 该节点已在队列中或正在加载时返回 false（仍在排队的请求会更新优先级）
+     */
+    bool Request(const TileNode& tile, double priority = 0.0);
+
+    /**
+     * @brief 撤销尚未开始解码的请求
+     * @param shouldCancel 对排队中的节点返回 true 则撤销
+     * @return 撤销的请求数
+     */
+    size_t CancelQueued(const std::function<bool(const TileNode&)>& shouldCancel);
+
+    /**
+     * @brief 撤销排队中优先级最低、且比给定优先级更低的一个请求，为更重要的请求腾出名额
+     * @return 是否撤销了请求
+     */
+    bool PreemptQueued(double priority);
+
+    /// 节点是否已提交但尚未交付
+    bool IsPending(const TileNode& tile) const;
+    /// 节点是否仍在排队（尚未被工作线程取走）
+    bool IsQueued(const TileNode& tile) const;
+
+    /**
+     * @brief 在 GL 线程上传已完成的结果
+     * @param budgetMs 本帧允许花费的时间（毫秒），至少处理一个结果
+     * @param onExpanded 外部 tileset 解析完成，由调用方挂接子树
+     * @return 本次处理的结果数
+     */
+    size_t ProcessCompleted(double budgetMs, const LoadedCallback& onLoaded, const FailedCallback& onFailed,
+                            const ExpandedCallback& onExpanded = {});
+
+    size_t GetPendingCount() const;
+    size_t GetQueuedCount() const;
+    size_t GetCompletedCount() const;
+
+private:
+    struct Job {
+        const TileNode* tile = nullptr;
+        std::string path;
+        double priority = 0.0;
+        bool external = false;  // 外部 tileset 占位节点
+    };
+
+    struct Result {
+        const TileNode* tile = nullptr;
+        std::string path;
+        MeshData data;
+        std::vector<Mesh::LODLevel> lods;
+        std::vector<Mesh::Meshlet> meshlets;
+        std::shared_ptr<TileNode> subtree;
+        std::string error;
+    };
+
+    void WorkerLoop();
+    /// 解码并预处理网格：工作线程与网格重建共用，保证两次结果一致
+    static void PrepareMesh(const std::string& path, const Options& options, Result& result);
+
+    Options options;
+    std::shared_ptr<const Options> meshOptions;  // 由各网格的 Reloader 共享，与首次加载的选项相同
+    std::vector<std::thread> workers;
+
+    mutable std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable resultSpace;
+    std::deque<Job> jobs;
+    std::deque<Result> completed;
+    std::unordered_set<const TileNode*> pending;  // 已提交、尚未被 GL 线程取走（含排队、解码中、待上传）
+    bool stopping = false;
+};
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cctype>
 #include <glm/glm.hpp>
 
 struct TileNode {
@@ -11,11 +12,27 @@ struct TileNode {
     double geometricError = 0.0;  // <== 新增
     
     // 新增字段
-    glm::mat4 transform = glm::mat4(1.0f);  // 变换矩阵
+    glm::dmat4 transform = glm::dmat4(1.0);  // 变换矩阵（相对父节点，列主序）
+    enum class VolumeType { None, Box, Region, Sphere };
     struct {
-        glm::vec3 center = glm::vec3(0.0f);  // 包围盒中心
-        glm::vec3 halfSize = glm::vec3(0.0f); // 包围盒半尺寸
+        VolumeType type = VolumeType::None;
+
+        glm::dvec3 center = glm::dvec3(0.0);   // 包围盒中心 / 球心
+        glm::dvec3 halfSize = glm::dvec3(0.0); // 包围盒半尺寸（各半轴长度）
+
+        glm::dmat3 halfAxes = glm::dmat3(0.0);   // box：三个半轴（列向量）
+        double region[6] = { 0, 0, 0, 0, 0, 0 }; // region：west, south, east, north（弧度）, minH, maxH（米）
+        double radius = 0.0;                      // sphere：半径
     } boundingVolume;
+
+    // 累积父节点变换后的世界坐标（tileset 坐标系，Z 轴向上）
+    glm::dmat4 worldTransform = glm::dmat4(1.0);
+    struct {
+        bool valid = false;
+        glm::dvec3 center = glm::dvec3(0.0);     // 有向包围盒中心 / 包围球球心
+        glm::dmat3 halfAxes = glm::dmat3(0.0);   // 有向包围盒半轴
+        double radius = 0.0;                     // 包围球半径
+    } worldBounds;
     
     struct {
         double minimumPixelSize = 0.0;      // 最小像素尺寸
@@ -30,6 +47,29 @@ struct TileNode {
     } content;
     
     std::vector<std::shared_ptr<TileNode>> children;
+
+    // 外部 tileset（content 指向 .json）：解析时只保留占位节点，遍历到时再展开为子节点
+    enum class ExternalState { None, Unexpanded, Expanded, Failed };
+    ExternalState external = ExternalState::None;
+
+    bool IsExternalTileset() const { return external != ExternalState::None; }
+
+    // 是否带有可渲染的内容（b3dm / glb），外部 tileset（.json）不算
+    bool HasRenderableContent() const {
+        if (content.uri.empty()) return false;
+        std::string ext = content.uri.substr(content.uri.find_last_of('.') + 1);
+        for (auto& c : ext) c = static_cast<char>(::tolower(static_cast<unsigned char>(c)));
+        return ext == "b3dm" || ext == "glb";
+    }
+    
+    /**
+     * @brief 由父节点的世界变换计算本节点的世界变换与世界包围体
+     * @param parentWorld 父节点的世界变换（根节点传单位矩阵）
+     */
+    void UpdateWorldBounds(const glm::dmat4& parentWorld);
+
+    /// 相机到世界包围体的最近距离（相机在包围体内时为 0）
+    double DistanceTo(const glm::dvec3& point) const;
     
     // 辅助函数：获取格式化的路径（处理过长的路径）
     std::string GetFormattedPath() const {
@@ -0,0 +1,84 @@
+﻿// TileRequestScheduler.h
+#pragma once
+#include <vector>
+#include <functional>
+#include <unordered_set>
+#include "TileNode.h"
+#include "TileSelector.h"
+#include "TileContentLoader.h"
+
+/**
+ * @class TileRequestScheduler
+ * @brief 瓦片加载请求调度：按优先级排序、限制在途数量、撤销过期请求
+ *
+ * 优先级由三项归一化后加权得到（数值越小越优先）：
+ *  - 屏幕空间误差：误差越大越需要尽快细化；
+ *  - 到相机的距离：近处瓦片优先；
+ *  - 视锥位置：靠近视线中心的瓦片优先。
+ * 每帧只保留本帧仍被请求的任务，离开视野且尚未开始解码的请求会被撤销，
+ * 快速移动相机时 I/O 不会浪费在已经不需要的瓦片上。
+ */
+class TileRequestScheduler {
+public:
+    struct Options {
+        size_t maxInFlight = 8;        // 同时在途（排队 + 解码 + 待上传）的请求上限
+        double sseWeight = 1.0;        // 屏幕空间误差权重
+        double distanceWeight = 0.5;   // 距离权重
+        double centerWeight = 0.5;     // 偏离视线中心的权重
+        bool   cancelStale = true;     // 撤销本帧不再需要的排队请求
+    };
+
+    struct Statistics {
+        size_t candidates = 0;  // 本帧待加载的节点
+        size_t submitted = 0;   // 本帧新提交
+        size_t deferred = 0;    // 因在途上限推迟到后续帧
+        size_t cancelled = 0;   // 本帧撤销
+        size_t inFlight = 0;    // 调度结束后的在途数量
+        size_t totalCancelled = 0;
+    };
+
+    /// 节点是否应跳过（例如加载失败过）
+    using SkipPredicate = std::function<bool(const TileNode&)>;
+
+    TileRequestScheduler() = default;
+    explicit TileRequestScheduler(const Options& options) : options(options) {}
+
+    /**
+     * @brief 调度本帧的加载请求
+     * @param requests 选择器给出的待加载节点
+     * @param frame 帧状态
+     * @param loader 加载服务
+     * @param shouldSkip 可为空
+     */
+    void Schedule(const std::vector<TileSelector::Request>& requests,
+                  const TileSelector::FrameState& frame,
+                  TileContentLoader& loader,
+                  const SkipPredicate& shouldSkip = {});
+
+    /**
+     * @brief 计算单个请求的优先级（数值越小越优先）
+     * @param maxScreenSpaceError / maxDistance 本帧候选中的最大值，用于归一化
+     */
+    double ComputePriority(const TileSelector::Request& request,
+                           const TileSelector::FrameState& frame,
+                           double maxScreenSpaceError,
+                           double maxDistance) const;
+
+    const Statistics& GetStatistics() const { return stats; }
+
+    Options& GetOptions() { return options; }
+    const Options& GetOptions() const { return options; }
+
+private:
+    struct Candidate {
+        const TileNode* tile = nullptr;
+        double priority = 0.0;
+    };
+
+    Options options;
+    Statistics stats;
+
+    // 帧间复用，避免每帧分配
+    std::vector<Candidate> candidates;
+    std::unordered_set<const TileNode*> wanted;
+};
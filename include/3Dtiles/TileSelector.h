@@ -0,0 +1,100 @@
+﻿// TileSelector.h
+#pragma once
+#include <vector>
+#include <functional>
+#include <glm/glm.hpp>
+#include "TileNode.h"
+#include "Render/Frustum.h"
+
+/**
+ * @class TileSelector
+ * @brief 基于屏幕空间误差（SSE）的 TileNode 树逐帧遍历
+ *
+ * 每帧从根节点开始遍历：视锥外的节点直接剔除；
+ * SSE 不超过阈值的节点停止细化并被选中渲染；
+ * 否则按 refine 模式细化 —— REPLACE 由子节点替换自身，ADD 在自身之上叠加子节点。
+ * REPLACE 细化时若子节点内容尚未就绪，则继续渲染父节点，避免出现空洞。
+ * 未展开的外部 tileset 节点与缺少内容的节点一样出现在请求列表中。
+ */
+class TileSelector {
+public:
+    struct Options {
+        double maximumScreenSpaceError = 16.0;  // 允许的最大屏幕空间误差（像素）
+        bool   frustumCulling = true;           // 是否进行视锥剔除
+    };
+
+    /// 每帧的相机参数（tileset 世界坐标系，双精度）
+    struct FrameState {
+        glm::dvec3 cameraPosition{0.0};
+        glm::dvec3 cameraDirection{0.0, 0.0, -1.0};  // 视线方向（单位向量）
+        DFrustum   frustum;
+        double     sseDenominator = 1.0;  // 2 * tan(fovy / 2) / 视口高度
+
+        /**
+         * @brief 由视图矩阵与投影矩阵构造帧状态
+         * @param view 世界到相机的视图矩阵
+         * @param projection 透视投影矩阵
+         * @param viewportHeight 视口高度（像素）
+         */
+        static FrameState Create(const glm::dmat4& view, const glm::dmat4& projection, int viewportHeight);
+    };
+
+    /// 需要加载内容的节点
+    struct Request {
+        const TileNode* tile = nullptr;
+        double screenSpaceError = 0.0;
+        double distance = 0.0;
+    };
+
+    struct Statistics {
+        size_t visited = 0;
+        size_t culled = 0;
+        size_t selected = 0;
+        size_t requested = 0;
+    };
+
+    /// 查询节点内容是否已加载到可渲染状态
+    using ReadyPredicate = std::function<bool(const TileNode&)>;
+
+    TileSelector() = default;
+    explicit TileSelector(const Options& options) : options(options) {}
+
+    /**
+     * @brief 遍历 TileNode 树，选出本帧需要渲染的节点
+     * @param root 根节点
+     * @param frame 帧状态
+     * @param isReady 内容就绪查询
+     * @return 本帧渲染列表（下一次 Select 前有效）
+     */
+    const std::vector<const TileNode*>& Select(const TileNode& root,
+                                               const FrameState& frame,
+                                               const ReadyPredicate& isReady);
+
+    /**
+     * @brief 计算节点在当前视角下的屏幕空间误差（像素）
+     */
+    double ComputeScreenSpaceError(const TileNode& tile, const FrameState& frame, double distance) const;
+
+    const std::vector<const TileNode*>& GetSelected() const { return selected; }
+    const std::vector<Request>& GetRequests() const { return requests; }
+    const Statistics& GetStatistics() const { return stats; }
+
+    Options& GetOptions() { return options; }
+    const Options& GetOptions() const { return options; }
+
+private:
+    /**
+     * @brief 递归遍历
+     * @return 该子树选中的内容是否全部就绪
+     */
+    bool Traverse(const TileNode& tile);
+    bool IsReady(const TileNode& tile);
+
+    Options options;
+    const FrameState* frame = nullptr;
+    const ReadyPredicate* readyPredicate = nullptr;
+
+    std::vector<const TileNode*> selected;
+    std::vector<Request> requests;
+    Statistics stats;
+};
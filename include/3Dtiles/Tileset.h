@@ -0,0 +1,89 @@
+﻿// Tileset.h
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_set>
+#include <glm/glm.hpp>
+#include "TileNode.h"
+#include "TileSelector.h"
+#include "TileContentLoader.h"
+#include "TileRequestScheduler.h"
+#include "TileCache.h"
+#include "TilesetParser.h"
+#include "Render/Entity.h"
+
+/**
+ * @class Tileset
+ * @brief 3D Tiles 运行时：持有 TileNode 树，按相机逐帧选择并异步加载瓦片内容，
+ *        已加载内容由 TileCache 按内存预算卸载；外部 tileset 在遍历到时才异步解析并挂接
+ *
+ * 渲染坐标系取根节点的局部坐标系（glTF 的 Y 轴向上），
+ * 这样单个模型的显示与直接加载 glb 时保持一致；
+ * 瓦片选择则在 tileset 的世界坐标系（Z 轴向上）中以双精度进行。
+ */
+class Tileset {
+public:
+    struct Options {
+        TileSelector::Options selector;
+        TileContentLoader::Options loader;
+        TileRequestScheduler::Options scheduler;
+        TileCache::Options cache;
+        TilesetParser::Options parser;
+        double uploadBudgetMs = 4.0;  // 每帧创建 GPU 资源的时间预算（毫秒）
+    };
+
+    struct Statistics {
+        TileSelector::Statistics selection;
+        TileRequestScheduler::Statistics scheduling;
+        TileCache::Statistics cache;
+        size_t loadedTiles = 0;
+        size_t pendingTiles = 0;
+        size_t failedTiles = 0;
+        size_t uploadedThisFrame = 0;
+        size_t expandedTilesets = 0;  // 已展开的外部 tileset
+    };
+
+    explicit Tileset(const std::string& tilesetPath) : Tileset(tilesetPath, Options{}) {}
+    Tileset(const std::string& tilesetPath, const Options& options);
+
+    /**
+     * @brief 逐帧更新：上传已解码的瓦片，选择本帧瓦片并提交缺失内容的加载请求
+     * @param view 渲染坐标系下的视图矩阵
+     * @param projection 投影矩阵
+     * @param viewportHeight 视口高度（像素）
+     */
+    void Update(const glm::mat4& view, const glm::mat4& projection, int viewportHeight);
+
+    /// 本帧需要渲染的实体
+    const std::vector<std::shared_ptr<Entity>>& GetRenderEntities() const { return renderEntities; }
+
+    std::shared_ptr<TileNode> GetRoot() const { return root; }
+    const Statistics& GetStatistics() const { return stats; }
+    Options& GetOptions() { return options; }
+
+    /// 新建实体时使用的颜色
+    void SetDefaultColor(const glm::vec3& color) { defaultColor = color; }
+
+private:
+    bool IsContentReady(const TileNode& tile) const;
+    std::shared_ptr<Entity> CreateEntity(const TileNode& tile, std::shared_ptr<Mesh> mesh) const;
+
+    std::shared_ptr<TileNode> root;
+    Options options;
+    TileSelector selector;
+    TileRequestScheduler scheduler;
+    TileCache cache;
+    Statistics stats;
+
+    // 渲染坐标系 <- tileset 世界坐标系
+    glm::dmat4 renderFromWorld{1.0};
+
+    std::unordered_set<const TileNode*> failed;
+    std::unordered_set<std::string> expandedFiles;
+    std::vector<std::shared_ptr<Entity>> renderEntities;
+    glm::vec3 defaultColor{1.0f};
+
+    // 最后声明，析构时最先停止工作线程
+    std::unique_ptr<TileContentLoader> loader;
+};
@@ -12,26 +12,68 @@ namespace fs = std::filesystem;
 
 class TilesetParser {
 public:
+    struct Options {
+        bool streaming = true;     // SAX 流式解析，直接构建 TileNode，不生成 JSON DOM
+        bool lazyExternal = true;  // 外部 tileset 保留为占位节点，由 ExpandExternal 按需展开
+    };
+
     static std::vector<std::string> GetB3DMPaths(const std::string& rootTilesetPath);
 
     // 新增接口：构建 TileNode 树
-    static std::shared_ptr<TileNode> BuildTileTree(const std::string& rootTilesetPath);
+    static std::shared_ptr<TileNode> BuildTileTree(const std::string& rootTilesetPath) {
+        return BuildTileTree(rootTilesetPath, Options{});
+    }
+    static std::shared_ptr<TileNode> BuildTileTree(const std::string& rootTilesetPath, const Options& options);
+
+    /**
+     * @brief 展开外部 tileset 占位节点：解析其 json 并把根节点挂为子节点
+     * @param expandedFiles 已展开的文件（规范化路径），重复引用视为失败以避免循环
+     * @return 是否成功展开
+     */
+    static bool ExpandExternal(TileNode& tile, const Options& options,
+                               std::unordered_set<std::string>& expandedFiles);
+
+    /**
+     * @brief 解析外部 tileset 为独立子树（不修改 tile，可在工作线程调用）
+     *
+     * 没有 root 键时把整个文档当作根瓦片。
+     * @throws std::runtime_error 文件无法打开或解析失败
+     */
+    static std::shared_ptr<TileNode> LoadExternal(const TileNode& tile, const Options& options);
+
+    /**
+     * @brief 将 LoadExternal 得到的子树挂到占位节点下（须在遍历树的线程调用）
+     * @return 是否成功挂接；重复引用的文件会被拒绝并标记为失败
+     */
+    static bool AttachExternal(TileNode& tile, std::shared_ptr<TileNode> subtree,
+                               std::unordered_set<std::string>& expandedFiles);
 
 private:
-    static void ParseNode(const nlohmann::json& node, 
-                        const fs::path& basePath,
-                        std::vector<std::string>& result,
-                        std::unordered_set<std::string>& processedFiles);
-
-    static void ProcessContentUrl(const nlohmann::json& content,
-                                const fs::path& basePath,
-                                std::vector<std::string>& result,
-                                std::unordered_set<std::string>& processedFiles);
-
-    // 新增函数：用于构建树
-    static std::shared_ptr<TileNode> ParseTreeRecursive(
-        const nlohmann::json& node,
-        const fs::path& basePath,
-        std::unordered_set<std::string>& processedFiles
-    );
+    // 解析单个 tileset 文件的 root 节点（不处理外部引用、不计算世界包围体）；
+    // documentAsRoot 时缺少 root 键的文档整体作为根瓦片，否则返回空
+    static std::shared_ptr<TileNode> ParseTilesetFile(const fs::path& path, bool streaming, bool documentAsRoot = false);
+    static std::shared_ptr<TileNode> ParseTilesetStreaming(const fs::path& path, bool documentAsRoot);
+    static std::shared_ptr<TileNode> ParseTilesetDOM(const fs::path& path, bool documentAsRoot);
+
+    /**
+     * @brief 解析完成后的统一处理：路径、refine 继承、世界包围体、外部 tileset 标记
+     *
+     * SAX 解析时子节点可能先于父节点的 transform 出现，因此放在整棵树解析完后进行。
+     */
+    static void FinalizeTree(TileNode& tile, const fs::path& basePath, const TileNode* parent);
+    static void ExpandAll(TileNode& tile, const Options& options, std::unordered_set<std::string>& expandedFiles);
+
+    // 新增函数：用于构建树（DOM 模式）
+    static std::shared_ptr<TileNode> ParseTreeRecursive(const nlohmann::json& node);
+
+    // 解析 boundingVolume（box / region / sphere）
+    static void ParseBoundingVolume(const nlohmann::json& volume, TileNode& tile);
+    // 解析 4x4 列主序 transform
+    static void ParseTransform(const nlohmann::json& transform, TileNode& tile);
+
+    class SaxBuilder;  // 流式解析的 SAX 处理器，定义见 TilesetParser.cpp
+    // 由数值数组设置包围体 / 变换（DOM 与 SAX 共用）
+    static void ApplyBoundingVolume(const std::string& key, const std::vector<double>& values, TileNode& tile);
+    static void ApplyTransform(const std::vector<double>& values, TileNode& tile);
+    static void ApplyRefine(std::string refine, TileNode& tile);
 };
@@ -0,0 +1,54 @@
+﻿// MappedFile.h
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <string>
+
+namespace Mirror {
+namespace Core {
+
+    /**
+     * @class MappedFile
+     * @brief 只读内存映射文件
+     *
+     * 将整个文件映射到进程地址空间，解析器直接以 span 访问文件内容，
+     * 不再经过中间缓冲区；页面由操作系统按需换入，读取后可随时回收。
+     * 映射在对象析构时解除，从中取得的 span 不得超出对象生命周期。
+     */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+
+        /**
+         * @brief 打开并映射文件
+         * @throws std::runtime_error 文件无法打开或映射失败
+         */
+        explicit MappedFile(const std::string& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        const uint8_t* Data() const noexcept { return data; }
+        size_t Size() const noexcept { return size; }
+        const std::string& GetPath() const noexcept { return path; }
+
+        std::span<const uint8_t> Bytes() const noexcept { return { data, size }; }
+
+    private:
+        void Close() noexcept;
+
+        std::string path;
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+#if defined(_WIN32)
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#endif
+    };
+
+} // namespace Core
+} // namespace Mirror
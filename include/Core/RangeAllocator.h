@@ -0,0 +1,79 @@
+﻿// RangeAllocator.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Mirror {
+namespace Core {
+
+    /**
+     * @class RangeAllocator
+     * @brief 线性地址空间 [0, capacity) 上的子分配器（空闲链表，最佳适配）
+     *
+     * 只管理偏移量，不持有内存，用于在大块 GPU 缓冲中划分区域。
+     * 空闲块按偏移与大小各建一份有序索引：分配取能容纳请求的最小空闲块，
+     * 释放时与相邻空闲块合并。碎片过多时由调用方执行 Compact 并按返回的移动表搬运数据。
+     */
+    class RangeAllocator {
+    public:
+        static constexpr size_t InvalidOffset = SIZE_MAX;
+
+        /// 一次整理中某个分配的搬运
+        struct Move {
+            size_t from;
+            size_t to;
+            size_t size;
+        };
+
+        explicit RangeAllocator(size_t capacity = 0);
+
+        /**
+         * @brief 分配 size 个单位，起始偏移按 alignment 对齐
+         * @return 偏移；空间不足时返回 InvalidOffset
+         */
+        size_t Allocate(size_t size, size_t alignment = 1);
+
+        /**
+         * @brief 释放 Allocate 返回的偏移
+         * @throws std::out_of_range 偏移不是当前有效的分配
+         */
+        void Free(size_t offset);
+
+        /// 扩大地址空间，新增部分成为空闲块
+        void Grow(size_t newCapacity);
+
+        /**
+         * @brief 把所有分配按偏移顺序紧凑排列到地址空间开头（保持对齐）
+         * @return 位置发生变化的分配，按原偏移升序
+         */
+        std::vector<Move> Compact(size_t alignment = 1);
+
+        size_t Capacity() const noexcept { return capacity; }
+        size_t UsedSize() const noexcept { return used; }
+        size_t FreeSize() const noexcept { return capacity - used; }
+        size_t AllocationCount() const noexcept { return allocations.size(); }
+        size_t LargestFreeBlock() const noexcept { return bySize.empty() ? 0 : bySize.rbegin()->first; }
+        /// 最后一个分配的结束位置（末尾空闲块之前），Grow 之后新空间从这里开始连续
+        size_t UsedExtent() const noexcept;
+
+        /// 碎片率：1 - 最大空闲块 / 总空闲，空闲空间连续时为 0
+        float Fragmentation() const noexcept;
+
+    private:
+        void InsertFree(size_t offset, size_t size);
+        void EraseFree(std::map<size_t, size_t>::iterator it);
+
+        size_t capacity = 0;
+        size_t used = 0;
+        std::map<size_t, size_t> byOffset;               // 空闲块：偏移 -> 大小
+        std::set<std::pair<size_t, size_t>> bySize;      // 空闲块：(大小, 偏移)
+        std::unordered_map<size_t, size_t> allocations;  // 已分配：偏移 -> 大小
+    };
+
+} // namespace Core
+} // namespace Mirror
@@ -0,0 +1,70 @@
+﻿// ThreadPool.h
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Mirror {
+namespace Core {
+
+    /**
+     * @class ThreadPool
+     * @brief 固定线程数的 CPU 任务池
+     *
+     * Submit 提交独立任务并通过 future 取回结果；ParallelFor 把区间切块并行处理。
+     * ParallelFor 的调用线程自己也领取块，只等待已被领取的块完成，
+     * 因此可以在池内任务中嵌套调用，不会因工作线程全部阻塞而死锁。
+     */
+    class ThreadPool {
+    public:
+        /// @param threadCount 工作线程数，0 表示硬件线程数减一（留一个核心给渲染线程）
+        explicit ThreadPool(size_t threadCount = 0);
+
+        /// 丢弃尚未开始的任务（其 future 得到 broken_promise），等待执行中的任务结束
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// 进程共享的任务池，首次使用时创建
+        static ThreadPool& Shared();
+
+        size_t ThreadCount() const noexcept { return workers.size(); }
+
+        template <typename F>
+        auto Submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>&>> {
+            using R = std::invoke_result_t<std::decay_t<F>&>;
+            auto packaged = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+            auto future = packaged->get_future();
+            Enqueue([packaged]() { (*packaged)(); });
+            return future;
+        }
+
+        /**
+         * @brief 把 [0, count) 切成不小于 grain 的块，并行执行 body(begin, end)
+         *
+         * 不足两块时直接在调用线程执行。
+         * 任一块抛出的异常会在所有已领取的块结束后于调用线程重新抛出。
+         */
+        void ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+    private:
+        void Enqueue(std::function<void()> job);
+        void WorkerLoop();
+
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable jobAvailable;
+        std::deque<std::function<void()>> jobs;
+        bool stopping = false;
+    };
+
+} // namespace Core
+} // namespace Mirror
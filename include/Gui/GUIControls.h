@@ -16,6 +16,7 @@
 #include <GLFW/glfw3.h>
 #include "imgui/imgui.h"
 #include "3Dtiles/TileNode.h"  
+#include "3Dtiles/Tileset.h"
 
 #if defined(__cpp_char8_t)
     #define U8(str) reinterpret_cast<const char*>(u8##str)
@@ -33,7 +34,7 @@ public:
     // LOD Controller
     std::shared_ptr<ProgressiveLOD> lodController;
     ProgressiveLOD::Parameters lodParams;
-    float lodRatio = 1.0f;
+    float lodRatio = 0.0f;
 
     // Colors and material
     glm::vec3 triangleColor = glm::vec3(1.0f);
@@ -63,9 +64,13 @@ public:
     // Main render UI
     void Render();
 
+    // Per-frame tile selection, call before SceneManager::RenderScene
+    void UpdateTileset(const glm::mat4& view, const glm::mat4& projection, int viewportHeight);
+
 private:
     SceneManager* sceneManager = nullptr;
     std::weak_ptr<Entity> targetEntity;
+    std::unique_ptr<Tileset> tileset;
     Light* currentLight = nullptr;
     std::function<void()> onCameraReset;
     ImGuiFileDialog fileDialog;
@@ -0,0 +1,135 @@
+﻿// BoundingVolumeHierarchy.h
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Frustum.h"
+
+/**
+ * @class BoundingVolumeHierarchy
+ * @brief 动态包围盒层次结构（每个叶节点一个对象），用于层次视锥剔除、射线与范围查询
+ *
+ *  - 叶节点保存对象的实际包围盒及按比例加宽的"胖"盒，内部节点包住子节点的胖盒；
+ *  - 对象移动后仍在胖盒内时只更新实际包围盒，超出时才摘下叶节点重新插入；
+ *  - 增量插入按表面积代价选择兄弟节点，沿途做 AVL 式旋转保持平衡；
+ *  - Rebuild 按分箱 SAH 自顶向下重建全部内部节点，用于批量插入后或质量下降时；
+ *  - 叶节点序号（ProxyId）在对象的生命周期内不变，重建不会改变它。
+ * 只做 CPU 计算，与 GL 无关。
+ */
+class BoundingVolumeHierarchy {
+public:
+    using ProxyId = uint32_t;
+    static constexpr ProxyId InvalidProxy = ~0u;
+
+    struct AABB {
+        glm::vec3 min{0.0f};
+        glm::vec3 max{0.0f};
+
+        static AABB Union(const AABB& a, const AABB& b) { return { glm::min(a.min, b.min), glm::max(a.max, b.max) }; }
+        /// 表面积的一半（SAH 只比较相对大小）
+        float HalfArea() const {
+            const glm::vec3 d = max - min;
+            return d.x * d.y + d.y * d.z + d.z * d.x;
+        }
+        bool Contains(const AABB& other) const {
+            return glm::all(glm::lessThanEqual(min, other.min)) && glm::all(glm::greaterThanEqual(max, other.max));
+        }
+        bool Overlaps(const AABB& other) const {
+            return glm::all(glm::lessThanEqual(min, other.max)) && glm::all(glm::greaterThanEqual(max, other.min));
+        }
+    };
+
+    struct Options {
+        float fatMargin = 0.1f;  // 胖盒每侧按尺寸加宽的比例
+    };
+
+    struct Statistics {
+        size_t leaves = 0;
+        size_t nodes = 0;
+        int height = 0;            // 根节点高度（叶为 0）
+        float areaRatio = 0.0f;    // 内部节点表面积之和 / 根节点表面积，越小越好
+    };
+
+    /**
+     * @brief 射线查询回调
+     * @param item 包围盒被射线穿过的对象
+     * @param maxDistance 当前最近命中的距离，只需报告更近的命中
+     * @return 命中距离；未命中返回负数
+     */
+    using RayCallback = std::function<float(uint32_t item, float maxDistance)>;
+
+    BoundingVolumeHierarchy() : BoundingVolumeHierarchy(Options{}) {}
+    explicit BoundingVolumeHierarchy(const Options& options) : options(options) {}
+
+    /// 插入对象，item 为调用方的对象标识，查询时原样返回
+    ProxyId Insert(const AABB& bounds, uint32_t item);
+    void Remove(ProxyId proxy);
+    /**
+     * @brief 更新对象的包围盒
+     * @return 是否重新插入了叶节点（超出胖盒）
+     */
+    bool Move(ProxyId proxy, const AABB& bounds);
+    void Clear();
+
+    /// 按分箱 SAH 重建全部内部节点
+    void Rebuild();
+
+    uint32_t GetItem(ProxyId proxy) const { return nodes[proxy].item; }
+    const AABB& GetBounds(ProxyId proxy) const { return nodes[proxy].tight; }
+    size_t Size() const { return leafCount; }
+
+    /// 输出与视锥相交的对象；完全在视锥内的子树不再逐个测试
+    void Cull(const Frustum& frustum, std::vector<uint32_t>& items) const;
+    /// 输出包围盒与 range 相交的对象
+    void Query(const AABB& range, std::vector<uint32_t>& items) const;
+    /**
+     * @brief 由近及远遍历射线穿过的包围盒，由回调做精确求交
+     * @param direction 无需归一化，距离以其长度为单位
+     * @param item 最近命中的对象
+     * @param distance 输入为最大距离，命中时写入最近距离
+     * @return 是否命中
+     */
+    bool Raycast(const glm::vec3& origin, const glm::vec3& direction, const RayCallback& callback,
+                 uint32_t& item, float& distance) const;
+
+    Statistics GetStatistics() const;
+
+private:
+    static constexpr uint32_t Null = ~0u;
+    static constexpr int SahBins = 16;
+
+    struct Node {
+        AABB box;      // 叶节点为胖盒，内部节点为子节点胖盒的并
+        AABB tight;    // 叶节点的实际包围盒
+        uint32_t parent = Null;   // 空闲节点用作空闲链表的后继
+        uint32_t child1 = Null;
+        uint32_t child2 = Null;
+        int32_t height = -1;      // 叶为 0，空闲为 -1
+        uint32_t item = 0;
+
+        bool IsLeaf() const { return child1 == Null; }
+    };
+
+    // 重建时连续存放的叶节点副本，避免分割过程中随机访问节点池
+    struct BuildItem {
+        AABB box;
+        glm::vec3 centroid;
+        uint32_t leaf;
+    };
+
+    uint32_t AllocateNode();
+    void FreeNode(uint32_t index);
+    AABB Fatten(const AABB& bounds) const;
+    void InsertLeaf(uint32_t leaf);
+    void RemoveLeaf(uint32_t leaf);
+    uint32_t Balance(uint32_t index);
+    void FixUpwards(uint32_t index);
+    uint32_t BuildRange(std::vector<BuildItem>& leaves, size_t begin, size_t end);
+
+    Options options;
+    std::vector<Node> nodes;
+    uint32_t root = Null;
+    uint32_t freeList = Null;
+    size_t leafCount = 0;
+};
@@ -1,6 +1,8 @@
 ﻿#pragma once
+#include <algorithm>
 #include "Transform.h"
 #include "Mesh.h"
+#include "MeshletBuilder.h"
 #include "Render/Material/Material.h"
 #include "ProgressiveLOD.h"
 
@@ -11,24 +13,81 @@ public:
     std::shared_ptr<Mesh> mesh;
     std::shared_ptr<Material> material;
     std::shared_ptr<ProgressiveLOD> lodController;  // 新增LOD控制器指针
+    float lodPixelError = 1.0f;  // 离散 LOD 允许的屏幕空间误差（像素）
+    bool meshletConeCulling = true;  // 逐簇剔除时按法线锥剔除背向相机的簇（仅对单面材质生效）
 
-    void Render(const glm::mat4& view, const glm::mat4& projection) const {
+    void Render(const glm::mat4& view, const glm::mat4& projection, float viewportHeight) const {
+        Render(transform->GetGlobalMatrix(), view, projection, viewportHeight);
+    }
+
+    /// model 为调用方本帧已算好的世界矩阵（如 SceneManager 的逐帧缓存）
+    void Render(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection, float viewportHeight) const {
         if (!IsRenderable()) return;
 
-        // 计算模型矩阵
-        const glm::mat4 model = transform->GetGlobalMatrix();
+        // 最精细一级带有簇表时逐簇剔除，全部不可见则跳过绘制
+        const size_t lod = SelectLOD(model, view, projection, viewportHeight);
+        const bool useMeshlets = lod == 0 && !mesh->GetMeshlets().empty();
+        if (useMeshlets) {
+            const glm::mat4 modelView = view * model;
+            const glm::vec3 camera(glm::inverse(modelView)[3]);
+            MeshletCuller::Cull(mesh->GetMeshlets(), Frustum(projection * modelView), camera,
+                                meshletConeCulling && !material->IsDoubleSided(), visibleRanges);
+            if (visibleRanges.empty()) return;
+        }
         
         // 设置材质参数
         material->SetMatrix4("uModel", model);
         material->SetMatrix4("uView", view);
         material->SetMatrix4("uProjection", projection);
+        // 量化顶点的反量化参数（Float32 网格为恒等变换）
+        material->SetVector3("uPositionOffset", mesh->GetPositionOffset());
+        material->SetVector3("uPositionScale", mesh->GetPositionScale());
+        material->SetFloat("uOctahedralNormals", mesh->GetVertexFormat() == VertexFormat::Quantized ? 1.0f : 0.0f);
         
         // 可选：传递世界位置
         //material->SetVector3("u_WorldPos", transform->position);
 
-        // 应用材质并绘制
+        // 应用材质并绘制；背面剔除由材质的单双面决定，各 LOD 与逐簇路径一致
         material->Apply();
-        mesh->Draw();
+        if (useMeshlets) mesh->DrawRanges(visibleRanges);
+        else mesh->Draw(lod);
+    }
+
+    /**
+     * @brief 按投影大小选择离散 LOD：取包围球最近点的视距估算模型单位的像素大小，
+     *        选误差不超过 lodPixelError 的最粗级别
+     */
+    size_t SelectLOD(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection,
+                     float viewportHeight) const {
+        if (mesh->GetLODLevels().size() <= 1) return 0;
+
+        const float scale = std::max({ glm::length(glm::vec3(model[0])),
+                                       glm::length(glm::vec3(model[1])),
+                                       glm::length(glm::vec3(model[2])) });
+        const glm::vec4 center = view * model * glm::vec4(mesh->GetBoundsCenter(), 1.0f);
+        const float distance = -center.z - mesh->GetBoundsRadius() * scale;
+        if (distance <= 0.0f) return 0;  // 相机位于包围球内
+
+        const float pixelsPerUnit = scale * projection[1][1] * 0.5f * viewportHeight / distance;
+        return mesh->SelectLOD(pixelsPerUnit, lodPixelError);
+    }
+
+    /**
+     * @brief 世界空间包围球：网格包围球经模型矩阵变换，半径按最大轴缩放放大
+     * @return 没有网格时返回 false
+     */
+    bool GetWorldBounds(glm::vec3& center, float& radius) const {
+        return GetWorldBounds(transform->GetGlobalMatrix(), center, radius);
+    }
+
+    bool GetWorldBounds(const glm::mat4& model, glm::vec3& center, float& radius) const {
+        if (!mesh) return false;
+        const float scale = std::max({ glm::length(glm::vec3(model[0])),
+                                       glm::length(glm::vec3(model[1])),
+                                       glm::length(glm::vec3(model[2])) });
+        center = glm::vec3(model * glm::vec4(mesh->GetBoundsCenter(), 1.0f));
+        radius = mesh->GetBoundsRadius() * scale;
+        return true;
     }
 
     bool IsRenderable() const {
@@ -56,6 +115,8 @@ public:
 
 
 private:
+    mutable std::vector<Mesh::IndexRange> visibleRanges;  // 逐簇剔除结果，逐帧复用
+
     // 保持与你的材质类参数命名一致
     static constexpr const char* MODEL_MATRIX = "uModel";
     static constexpr const char* VIEW_PROJ_MATRIX = "uProjection";
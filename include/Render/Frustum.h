@@ -0,0 +1,99 @@
+﻿/**
+ * @file Frustum.h
+ * @brief 视锥体平面提取与包围体可见性测试
+ * @author MirrorEngine Team
+ * @date 2024
+ */
+#pragma once
+#include <array>
+#include <glm/glm.hpp>
+
+/**
+ * @class BasicFrustum
+ * @brief 由 视图投影矩阵 提取的六个裁剪平面
+ *
+ * 平面法线指向视锥体内部，并已归一化，
+ * 因此 dot(n, p) + d 即为点到平面的有符号距离。
+ * 3D Tiles 的 ECEF 坐标需要双精度，渲染侧使用单精度即可。
+ */
+template<typename T>
+class BasicFrustum {
+public:
+    using vec3 = glm::vec<3, T, glm::defaultp>;
+    using vec4 = glm::vec<4, T, glm::defaultp>;
+    using mat3 = glm::mat<3, 3, T, glm::defaultp>;
+    using mat4 = glm::mat<4, 4, T, glm::defaultp>;
+
+    enum Plane { Left = 0, Right, Bottom, Top, Near, Far, Count };
+
+    BasicFrustum() = default;
+
+    /**
+     * @brief 从视图投影矩阵构造视锥体（Gribb-Hartmann 方法）
+     * @param viewProjection projection * view
+     */
+    explicit BasicFrustum(const mat4& viewProjection) {
+        const mat4& m = viewProjection;
+        for (int i = 0; i < 3; ++i) {
+            planes[i * 2]     = Row(m, 3) + Row(m, i);
+            planes[i * 2 + 1] = Row(m, 3) - Row(m, i);
+        }
+        for (auto& p : planes) {
+            const T len = glm::length(vec3(p));
+            if (len > T(0)) p /= len;
+        }
+    }
+
+    /**
+     * @brief 包围球与视锥体是否相交
+     */
+    bool IntersectsSphere(const vec3& center, T radius) const {
+        for (const auto& p : planes) {
+            if (glm::dot(vec3(p), center) + p.w < -radius) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 轴对齐包围盒与视锥体是否相交（保守测试）
+     */
+    bool IntersectsAABB(const vec3& minCorner, const vec3& maxCorner) const {
+        for (const auto& p : planes) {
+            // 取沿平面法线方向最远的顶点
+            const vec3 positive(p.x >= T(0) ? maxCorner.x : minCorner.x,
+                                p.y >= T(0) ? maxCorner.y : minCorner.y,
+                                p.z >= T(0) ? maxCorner.z : minCorner.z);
+            if (glm::dot(vec3(p), positive) + p.w < T(0)) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 有向包围盒与视锥体是否相交（保守测试）
+     * @param center 盒中心
+     * @param halfAxes 三个半轴（列向量）
+     */
+    bool IntersectsOrientedBox(const vec3& center, const mat3& halfAxes) const {
+        for (const auto& p : planes) {
+            const vec3 n(p);
+            const T extent = glm::abs(glm::dot(n, halfAxes[0]))
+                           + glm::abs(glm::dot(n, halfAxes[1]))
+                           + glm::abs(glm::dot(n, halfAxes[2]));
+            if (glm::dot(n, center) + p.w < -extent) return false;
+        }
+        return true;
+    }
+
+    const vec4& GetPlane(int index) const { return planes[index]; }
+    const std::array<vec4, Count>& GetPlanes() const { return planes; }
+
+private:
+    static vec4 Row(const mat4& m, int r) {
+        return vec4(m[0][r], m[1][r], m[2][r], m[3][r]);
+    }
+
+    std::array<vec4, Count> planes{};
+};
+
+using Frustum  = BasicFrustum<float>;
+using DFrustum = BasicFrustum<double>;
@@ -0,0 +1,57 @@
+﻿// FrustumCuller.h
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Frustum.h"
+
+/**
+ * @class FrustumCuller
+ * @brief 大量包围球的批量视锥剔除
+ *
+ * 世界空间包围球按结构数组（SoA）存放：中心 x / y / z 与半径各占一个连续数组，
+ * 长度补齐到 8 的倍数，SIMD 路径每次装载 4 个（SSE）或 8 个（AVX）球对六个平面求距离。
+ * AVX 在运行时检测 CPU 支持后才使用，非 x86 平台只有标量路径。
+ * 半径为负的条目视为不可见，可用于占位或暂时隐藏。只做 CPU 计算，与 GL 无关。
+ */
+class FrustumCuller {
+public:
+    enum class Backend : uint8_t { Scalar, SSE, AVX };
+
+    /// 调整条目数；新增条目不可见，直到 SetSphere 设置
+    void Resize(size_t count);
+    void Clear() { Resize(0); }
+    size_t Size() const { return count; }
+
+    void SetSphere(size_t index, const glm::vec3& center, float radius) {
+        centerX[index] = center.x;
+        centerY[index] = center.y;
+        centerZ[index] = center.z;
+        radii[index] = radius >= 0.0f ? radius : HiddenRadius;
+    }
+
+    /**
+     * @brief 输出与视锥相交的条目序号（升序），使用当前平台最快的实现
+     * @param visible 输出（先清空）
+     * @return 可见条目数
+     */
+    size_t Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const {
+        return Cull(frustum, visible, BestBackend());
+    }
+    /// 指定实现；不支持的实现退回标量路径
+    size_t Cull(const Frustum& frustum, std::vector<uint32_t>& visible, Backend backend) const;
+
+    static bool IsSupported(Backend backend);
+    static Backend BestBackend();
+    static const char* BackendName(Backend backend);
+
+private:
+    static constexpr size_t Lanes = 8;  // 补齐粒度，AVX 一次处理的条目数
+    // 不可见条目：-radius 为最大浮点数，任何平面都会把它判为在外侧（不产生 NaN），
+    // SIMD 路径因此可以直接处理补齐后的整组而不必单独处理尾部
+    static constexpr float HiddenRadius = std::numeric_limits<float>::lowest();
+
+    std::vector<float> centerX, centerY, centerZ, radii;
+    size_t count = 0;
+};
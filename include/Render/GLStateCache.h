@@ -0,0 +1,103 @@
+﻿// GLStateCache.h
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <glad/glad.h>
+
+/**
+ * @class GLStateCache
+ * @brief GL 绑定与固定管线状态的影子副本，跳过与当前值相同的调用
+ *
+ * 记录当前程序、VAO、活动纹理单元与各单元的 2D 纹理、深度测试/写入/比较函数、混合开关与混合函数、
+ * 背面剔除开关；值未变化时不发出 GL 调用，并按类别统计每帧实际发出与跳过的次数。
+ * 只有经由本类修改的状态才会被跟踪：绕过本类改动这些状态的代码（如 ImGui 后端）之后需调用 Invalidate，
+ * 删除纹理、程序或 VAO 前调用对应的 Forget，避免名字被复用后误判为已绑定。
+ * 单一 GL 上下文，只能在 GL 线程调用。
+ */
+class GLStateCache {
+public:
+    enum class Call : uint8_t {
+        Program,
+        VertexArray,
+        ActiveTexture,
+        Texture,
+        Capability,   // glEnable / glDisable
+        DepthMask,
+        DepthFunc,
+        BlendFunc,
+        Uniform,      // 由 Shader 按值比较后上报
+        Draw,         // 绘制调用只计数，不可跳过
+        Count
+    };
+
+    struct Statistics {
+        std::array<uint32_t, static_cast<size_t>(Call::Count)> issued{};
+        std::array<uint32_t, static_cast<size_t>(Call::Count)> skipped{};
+
+        uint32_t Issued(Call call) const { return issued[static_cast<size_t>(call)]; }
+        uint32_t Skipped(Call call) const { return skipped[static_cast<size_t>(call)]; }
+        uint32_t TotalIssued() const;
+        uint32_t TotalSkipped() const;
+    };
+
+    static constexpr unsigned TrackedTextureUnits = 16;  // 更高的纹理单元不做跟踪，每次都发出调用
+
+    /// 新的一帧：清零统计并使影子状态失效（帧间可能有未经本类的 GL 调用）
+    static void BeginFrame();
+    /// 忘记所有已知状态，之后每种状态的第一次设置必定发出调用
+    static void Invalidate();
+
+    static void UseProgram(GLuint program);
+    static void BindVertexArray(GLuint vao);
+    /// 把 2D 纹理绑定到指定单元（需要时切换活动单元）
+    static void BindTexture(unsigned unit, GLuint texture);
+
+    static void SetDepthTest(bool enabled);
+    static void SetDepthMask(bool enabled);
+    static void SetDepthFunc(GLenum func);
+    static void SetBlend(bool enabled);
+    static void SetBlendFunc(GLenum source, GLenum destination);
+    static void SetCullFace(bool enabled);
+
+    /// 对象删除前调用：若正被绑定则清除对应的影子状态
+    static void ForgetProgram(GLuint program);
+    static void ForgetVertexArray(GLuint vao);
+    static void ForgetTexture(GLuint texture);
+
+    /// 记录一次由调用方自行判断是否冗余的调用
+    static void Record(Call call, bool issued) {
+        auto& counters = issued ? stats.issued : stats.skipped;
+        ++counters[static_cast<size_t>(call)];
+    }
+
+    static const Statistics& GetStatistics() { return stats; }
+    static const char* CallName(Call call);
+
+private:
+    static constexpr GLuint UnknownName = ~0u;
+    static constexpr GLenum UnknownEnum = ~0u;
+    static constexpr int8_t Unknown = -1;
+
+    struct State {
+        GLuint program = UnknownName;
+        GLuint vertexArray = UnknownName;
+        unsigned activeUnit = ~0u;
+        std::array<GLuint, TrackedTextureUnits> textures;
+        int8_t depthTest = Unknown;
+        int8_t depthMask = Unknown;
+        GLenum depthFunc = UnknownEnum;
+        int8_t blend = Unknown;
+        GLenum blendSource = UnknownEnum;
+        GLenum blendDestination = UnknownEnum;
+        int8_t cullFace = Unknown;
+
+        State() { textures.fill(UnknownName); }
+    };
+
+    static void SetCapability(GLenum capability, int8_t& shadow, bool enabled);
+    static void ActivateUnit(unsigned unit);
+
+    static State state;
+    static Statistics stats;
+};
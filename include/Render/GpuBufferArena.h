@@ -0,0 +1,94 @@
+﻿// GpuBufferArena.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+#include "Core/RangeAllocator.h"
+#include "VertexFormat.h"
+
+/**
+ * @class GpuBufferArena
+ * @brief 按顶点格式共享的 GPU 顶点/索引缓冲池
+ *
+ * 每种顶点格式一个池：一个大顶点缓冲（按顶点划分）、一个大索引缓冲（按字节划分，4 字节对齐）
+ * 和一个配置好属性的 VAO。Mesh 只持有池中的块句柄，绘制时用 base vertex 定位顶点，
+ * 同一格式的网格共用 VAO，相邻绘制之间无需切换顶点状态，也可以合并为多重绘制。
+ * 空间不足时先尝试整理碎片，仍不足再扩容；两者都在 GPU 上用 glCopyBufferSubData 搬运，
+ * 块句柄不变，偏移随之更新。所有接口只能在 GL 线程调用。
+ */
+class GpuBufferArena {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle InvalidHandle = ~0u;
+
+    /// 一个网格占用的区域
+    struct Block {
+        size_t baseVertex = 0;    // 顶点缓冲中的起始顶点
+        size_t vertexCount = 0;
+        size_t indexOffset = 0;   // 索引缓冲中的起始字节
+        size_t indexBytes = 0;
+    };
+
+    struct Statistics {
+        size_t blocks = 0;
+        size_t vertexBytes = 0;          // 已分配
+        size_t vertexCapacityBytes = 0;
+        size_t indexBytes = 0;
+        size_t indexCapacityBytes = 0;
+        float vertexFragmentation = 0.0f;
+        float indexFragmentation = 0.0f;
+        size_t defragmentations = 0;     // 累计整理次数
+        size_t growths = 0;              // 累计扩容次数
+    };
+
+    explicit GpuBufferArena(VertexFormat format);
+    ~GpuBufferArena();
+
+    GpuBufferArena(const GpuBufferArena&) = delete;
+    GpuBufferArena& operator=(const GpuBufferArena&) = delete;
+
+    /// 指定顶点格式的共享池，首次使用时创建（需要有效的 GL 上下文）
+    static GpuBufferArena& ForFormat(VertexFormat format);
+
+    /**
+     * @brief 分配一个块
+     * @throws std::runtime_error 扩容失败（显存不足）
+     */
+    Handle Allocate(size_t vertexCount, size_t indexBytes);
+    void Free(Handle handle);
+
+    const Block& GetBlock(Handle handle) const { return blocks[handle]; }
+
+    /// 写入块的顶点数据（bytes 不超过块的顶点容量）
+    void UploadVertices(Handle handle, const void* data, size_t bytes);
+    /// 写入块内从 offset 字节开始的索引数据
+    void UploadIndices(Handle handle, size_t offset, const void* data, size_t bytes);
+
+    /// 绑定共享 VAO（已包含索引缓冲）
+    void Bind() const;
+
+    /// 把所有块紧凑排列到缓冲开头，消除空洞
+    void Defragment();
+
+    VertexFormat GetFormat() const { return format; }
+    Statistics GetStatistics() const;
+
+private:
+    // 换用按当前容量新建的缓冲并搬运旧内容；moves 非空时为整理后的块移动表
+    void ReallocateVertexBuffer(size_t oldCapacity, const std::vector<Mirror::Core::RangeAllocator::Move>* moves);
+    void ReallocateIndexBuffer(size_t oldCapacity, const std::vector<Mirror::Core::RangeAllocator::Move>* moves);
+    void SetupVertexArray();
+
+    VertexFormat format;
+    size_t stride;
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    GLuint ebo = 0;
+    Mirror::Core::RangeAllocator vertexSpace;  // 单位：顶点
+    Mirror::Core::RangeAllocator indexSpace;   // 单位：字节
+    std::vector<Block> blocks;                 // 按句柄索引
+    std::vector<Handle> freeHandles;
+    size_t defragmentations = 0;
+    size_t growths = 0;
+};
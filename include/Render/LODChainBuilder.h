@@ -0,0 +1,41 @@
+﻿// LODChainBuilder.h
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Mesh.h"
+#include "Vertex.h"
+
+/**
+ * @class LODChainBuilder
+ * @brief 生成网格的离散 LOD 链（加载时或离线）
+ *
+ * 用同一个二次误差简化器逐级简化，每级保留上一级一定比例的顶点；
+ * 各级索引依次追加在原始索引之后，与原网格共用顶点缓冲，
+ * 上传后由 Mesh::Draw(lod) 只切换绘制范围。简化后的各级按顶点缓存重新排序三角形。
+ * 只做 CPU 计算，可在工作线程调用。
+ */
+class LODChainBuilder {
+public:
+    struct Options {
+        size_t maxLevels = 4;       // 含原始网格在内的最多级数，不超过 1 时不生成
+        float reduction = 0.5f;     // 每级相对上一级保留的顶点比例
+        size_t minTriangles = 256;  // 三角形少于该值时不再继续简化
+        float minSavings = 0.2f;    // 新一级的三角形至少比上一级少该比例，否则停止
+        size_t cacheSize = 16;      // 各级三角形重排时模拟的顶点缓存大小，0 表示不重排
+    };
+
+    static std::vector<Mesh::LODLevel> Build(std::span<const Vertex> vertices, std::vector<uint32_t>& indices) {
+        return Build(vertices, indices, Options{});
+    }
+
+    /**
+     * @brief 生成 LOD 链
+     * @param vertices 顶点（不修改）
+     * @param indices  原始索引，各级简化结果依次追加在其后
+     * @return 各级的索引范围与误差，第 0 级为原始索引；网格过小时只有第 0 级
+     * @throws std::runtime_error 索引数量或范围非法
+     */
+    static std::vector<Mesh::LODLevel> Build(std::span<const Vertex> vertices, std::vector<uint32_t>& indices,
+                                             const Options& options);
+};
@@ -17,9 +17,8 @@ public:
         m_ColorCache = value;
         
         // 复用基类逻辑（参考你的现有代码结构）
-        // ↓↓↓ 与SetVector3相同的存储和标记方式 ↓↓↓
+        // ↓↓↓ 与SetVector3相同的存储方式 ↓↓↓
         vec3Params[COLOR_PARAM_NAME] = value;
-        dirty = true;
         
         // 或者直接调用基类方法（如果继承可见性允许）
         // Material::SetVector3(COLOR_PARAM_NAME, value);
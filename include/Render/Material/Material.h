@@ -12,6 +12,10 @@ public:
     int GetRenderQueue() const { return renderQueue; }
     bool IsTransparent() const { return renderQueue > 2500; }
     void SetRenderQueue(int queue) { renderQueue = queue; }
+
+    /// 双面材质不做背面剔除；单面材质在每条绘制路径上都开启背面剔除
+    bool IsDoubleSided() const { return doubleSided; }
+    void SetDoubleSided(bool value) { doubleSided = value; }
     
     explicit Material(std::shared_ptr<Shader> shader);
     virtual ~Material() = default;
@@ -20,38 +24,45 @@ public:
     Material(const Material&) = default;
     Material& operator=(const Material&) = default;
 
+    const std::shared_ptr<Shader>& GetShader() const { return shader; }
+
     bool IsValid() const { 
         return shader != nullptr && shader->IsValid(); 
     }
     
+    /**
+     * @brief 绑定着色器、设置渲染状态并上传全部参数与纹理
+     *
+     * 着色器可能被多个材质共用，每次都完整提交；程序、纹理、状态与 uniform 的冗余调用
+     * 由 GLStateCache 与 Shader 的值缓存跳过。
+     */
     virtual void Apply();
 
+    /// 透明材质开启 alpha 混合并关闭深度写入，不透明材质相反；单面材质开启背面剔除
+    void ApplyRenderState() const;
+
     // 参数设置接口
     void SetFloat(const std::string& name, float value) { 
         floatParams[name] = value; 
-        dirty = true;
     }
     
     void SetVector3(const std::string& name, const glm::vec3& value) { 
         vec3Params[name] = value;
-        dirty = true;
     }
     
     void SetMatrix4(const std::string& name, const glm::mat4& value) { 
         mat4Params[name] = value;
-        dirty = true;
     }
     
     void SetTexture(const std::string& uniformName,
                    const std::shared_ptr<Texture>& texture) {
         textureSlots[uniformName] = texture;
-        dirty = true;
     }
 
 protected:
     std::shared_ptr<Shader> shader;
-    bool dirty = true; // 优化标记
     int renderQueue = 2000;
+    bool doubleSided = true;  // 默认双面，与不做背面剔除的原有绘制一致
     
     // 参数存储
     std::unordered_map<std::string, float> floatParams;
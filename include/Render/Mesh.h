@@ -10,8 +10,12 @@
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <memory>
+#include <span>
+#include <functional>
 #include "ProgressiveLOD.h" // 新增关键包含
 #include "Vertex.h"
+#include "VertexFormat.h"
+#include "GpuBufferArena.h"
 
 
 class ProgressiveLOD; // 前向声明
@@ -21,17 +25,67 @@ class ProgressiveLOD; // 前向声明
  * @brief 表示一个3D网格模型，管理顶点数据和渲染状态
  * 
  * 该类负责管理网格的顶点数据、索引数据，以及相关的GPU资源。
+ * GPU 数据存放在按顶点格式共享的 GpuBufferArena 中，Mesh 只持有块句柄，
+ * 同一格式的网格共用 VAO，绘制时用 base vertex 定位顶点。
+ * CPU 侧索引始终为 32 位；上传时顶点数不超过 65536 则 GPU 索引使用 16 位。
+ * 上传后 CPU 副本按 Residency 策略保留、释放或压缩为只含位置的拾取副本，
+ * 设置了 Reloader 的网格可在需要时（如渐进简化）从源数据重建完整副本。
  * 支持移动语义但禁止拷贝，以优化性能和资源管理。
  */
 class Mesh {
 public:
+    /**
+     * @brief 离散 LOD 级别
+     *
+     * 各级共用同一个顶点缓冲，索引依次存放在同一个索引缓冲中；
+     * 切换级别只改变绘制范围，不需要 CPU 计算或上传。
+     */
+    struct LODLevel {
+        uint32_t firstIndex = 0;  // 在索引缓冲中的起始位置
+        uint32_t indexCount = 0;
+        float error = 0.0f;       // 相对原始网格的几何误差（模型单位）
+    };
+
+    /// 索引缓冲中的一段
+    struct IndexRange {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+    };
+
+    /**
+     * @brief 第 0 级网格中连续的一小簇三角形及其剔除数据（模型空间）
+     *
+     * 法线锥：簇内所有三角形法线与 coneAxis 的夹角不超过 α，coneCutoff = sin α；
+     * coneCutoff 为 1 表示法线过于分散，不做背面剔除。
+     */
+    struct Meshlet {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        glm::vec3 center{0.0f};
+        float radius = 0.0f;
+        glm::vec3 coneAxis{0.0f};
+        float coneCutoff = 1.0f;
+    };
+
+    /// 上传后 CPU 侧副本的保留策略
+    enum class Residency : uint8_t {
+        Keep,           // 保留完整的顶点/索引
+        Discard,        // 全部释放，只剩 GPU 缓冲
+        PositionsOnly,  // 只保留位置与第 0 级索引，供拾取与遮挡剔除
+    };
+
+    /// 从源数据重新生成完整的顶点/索引，结果必须与上传时的数据一致
+    using Reloader = std::function<void(std::vector<Vertex>&, std::vector<unsigned int>&)>;
+
     /**
      * @brief 构造一个新的网格对象
      * @param vertices 顶点数据数组
      * @param indices 索引数据数组
+     * @param format GPU 顶点缓冲的存储格式（CPU 侧始终为 Vertex）
      */
     Mesh(std::vector<Vertex>&& vertices, 
-        std::vector<unsigned int>&& indices);
+        std::vector<unsigned int>&& indices,
+        VertexFormat format = VertexFormat::Float32);
     
     ~Mesh();
     
@@ -45,18 +99,156 @@ public:
      * @brief 检查网格是否已准备好进行渲染
      * @return 如果GPU资源已初始化则返回true
      */
-    bool IsReady() const { return VAO != 0; } // 根据实际渲染资源初始化状态判断
+    bool IsReady() const { return arenaBlock != GpuBufferArena::InvalidHandle; }
 
     /**
      * @brief 渲染网格
      */
     void Draw() const;
 
+    /**
+     * @brief 渲染指定的离散 LOD 级别（超出范围时取最粗的一级；没有 LOD 时等同 Draw()）
+     */
+    void Draw(size_t lod) const;
+
+    /**
+     * @brief 设置离散 LOD 级别表，索引缓冲中必须已包含各级索引
+     *
+     * 第 0 级为原始网格，Draw() 与绘制数量都以它为准。
+     */
+    void SetLODLevels(std::vector<LODLevel> levels);
+    /// 丢弃第 0 级以外的 LOD 索引（CPU 数据仍驻留时才能截断）
+    void ClearLODLevels();
+    const std::vector<LODLevel>& GetLODLevels() const { return lodLevels; }
+
+    /**
+     * @brief 选择误差不超过限制的最粗级别
+     * @param pixelsPerUnit 模型单位投影到屏幕上的像素数
+     * @param maxPixelError 允许的屏幕空间误差（像素）
+     */
+    size_t SelectLOD(float pixelsPerUnit, float maxPixelError) const;
+
+    /**
+     * @brief 设置第 0 级的簇表（索引缓冲中已按簇排列），供逐簇剔除
+     * @throws std::out_of_range 簇超出第 0 级的索引范围
+     */
+    void SetMeshlets(std::vector<Meshlet> clusters);
+    /// 丢弃簇表（索引被重新排列后簇不再有效）
+    void ClearMeshlets() { meshlets.clear(); }
+
+    /**
+     * @brief 用新的第 0 级索引替换整个索引缓冲并重新上传，离散 LOD 与簇表随之丢弃
+     *
+     * 需要完整的顶点副本；绘制数量重置为全部索引。
+     */
+    void ReplaceIndices(std::vector<unsigned int> newIndices);
+    const std::vector<Meshlet>& GetMeshlets() const { return meshlets; }
+
+    /**
+     * @brief 只绘制索引缓冲中的若干段（多段时用一次 glMultiDrawElements）
+     */
+    void DrawRanges(std::span<const IndexRange> ranges) const;
+
+    VertexFormat GetVertexFormat() const { return vertexFormat; }
+    /// GPU 索引缓冲的元素类型（GL_UNSIGNED_SHORT 或 GL_UNSIGNED_INT），每次完整上传时确定
+    GLenum GetIndexType() const { return indexType; }
+    /// 数据所在的共享缓冲池（未上传时为空）
+    GpuBufferArena* GetArena() const { return arena; }
+    /// 位置反量化参数：模型空间位置 = offset + scale * 顶点属性（Float32 格式下为 0 与 1）
+    const glm::vec3& GetPositionOffset() const { return positionOffset; }
+    const glm::vec3& GetPositionScale() const { return positionScale; }
+
+    /// 模型空间包围球（构造时由顶点计算，释放 CPU 数据后仍有效）
+    const glm::vec3& GetBoundsCenter() const { return boundsCenter; }
+    float GetBoundsRadius() const { return boundsRadius; }
+    /// 模型空间轴对齐包围盒
+    const glm::vec3& GetBoundsMin() const { return boundsMin; }
+    const glm::vec3& GetBoundsMax() const { return boundsMax; }
+
     /**
      * @brief 显式释放GPU资源
      */
     void Destroy(); // 显式释放资源
     
+    /**
+     * @brief 释放 CPU 侧的顶点/索引副本，仅保留 GPU 缓冲
+     *
+     * 释放后仍可正常 Draw，但依赖 CPU 数据的操作（法线计算、LOD 简化、重新上传）不再可用，
+     * 除非通过 RestoreCPUData 重建。策略为 PositionsOnly 时保留拾取副本。
+     */
+    void ReleaseCPUData();
+
+    /**
+     * @brief 设置 CPU 副本的保留策略；已上传的网格立即按新策略释放
+     *
+     * Keep 不会找回已释放的数据，需要时调用 RestoreCPUData。
+     */
+    void SetResidency(Residency policy);
+    Residency GetResidency() const { return residency; }
+
+    /// 设置重建完整 CPU 副本的回调（通常重新解码源文件）
+    void SetReloader(Reloader callback) { reloader = std::move(callback); }
+    /// Reloader 只依赖源数据，可复制到工作线程调用
+    const Reloader& GetReloader() const { return reloader; }
+    bool CanRestoreCPUData() const { return HasCPUData() || static_cast<bool>(reloader); }
+
+    /**
+     * @brief 完整 CPU 副本已释放时通过 Reloader 重建，不重新上传 GPU 数据
+     * @return 完整副本是否可用
+     * @throws std::runtime_error 重建结果与已上传的数据规模不一致
+     */
+    bool RestoreCPUData();
+
+    /**
+     * @brief 装回在别处（如工作线程上经 Reloader）重建的顶点，索引由调用方随后替换
+     * @throws std::runtime_error 顶点数与已上传的数据不一致
+     */
+    void RestoreVertices(std::vector<Vertex> restored);
+
+    /// 完整的 CPU 侧数据是否仍然驻留
+    bool HasCPUData() const { return !vertices.empty() || !indices.empty(); }
+
+    /// 是否有可用于拾取的 CPU 几何（完整副本或位置副本）
+    bool HasPickingData() const { return HasCPUData() || !pickPositions.empty(); }
+
+    /// 软件遮挡剔除用的几何，位置按 stride 字节跨距读取
+    struct OccluderGeometry {
+        const float* positions = nullptr;
+        size_t stride = 0;
+        size_t vertexCount = 0;
+        const unsigned int* indices = nullptr;
+        size_t indexCount = 0;
+    };
+
+    /**
+     * @brief 取遮挡体几何：第 0 级当前绘制的三角形（含渐进简化结果）；
+     *        QEM 简化出的粗级别可能凸出原表面，不能作为遮挡体
+     * @return 没有 CPU 侧几何（完整副本或拾取副本）时返回 false
+     */
+    bool GetOccluderGeometry(OccluderGeometry& geometry) const;
+
+    /**
+     * @brief 模型空间射线与当前绘制的三角形求交
+     * @param direction 射线方向（无需归一化，distance 以其长度为单位）
+     * @param distance 命中时写入最近交点的参数 t
+     * @return 是否命中；没有拾取数据时返回 false
+     */
+    bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float& distance) const;
+
+    /// CPU 侧顶点/索引（含拾取副本）占用的字节数（按容量计）
+    size_t GetCPUMemoryBytes() const {
+        return vertices.capacity() * sizeof(Vertex) + indices.capacity() * sizeof(unsigned int)
+             + pickPositions.capacity() * sizeof(glm::vec3)
+             + pickIndices.capacity() * sizeof(unsigned int);
+    }
+
+    /// 已上传到 GPU 的缓冲字节数
+    size_t GetGPUMemoryBytes() const { return isUploaded ? gpuVertexBytes + gpuIndexBytes : 0; }
+
+    /// 上传到 GPU 的顶点/索引数量（释放 CPU 数据后仍然有效）
+    size_t GetVertexCount() const { return vertexCount; }
+    size_t GetIndexCount() const { return indexCount; }
+
     /**
      * @brief 计算网格的法线数据
      */
@@ -66,6 +258,19 @@ public:
      * @brief 将数据更新到GPU
      */
     void UpdateGPUData();
+
+    /**
+     * @brief 只上传索引缓冲中的一段
+     *
+     * CPU 侧 indices 已在该范围内修改且总长度未变；用于渐进网格的局部更新。
+     * @param first 起始索引位置
+     * @param count 索引个数
+     */
+    void UpdateIndexRange(size_t first, size_t count);
+
+    /// 绘制时只使用索引缓冲的前 count 个索引（不超过已上传数量）
+    void SetDrawIndexCount(size_t count);
+    size_t GetDrawIndexCount() const { return drawIndexCount; }
     
     // Getters
     const std::vector<Vertex>& GetVertices() const { return vertices; }
@@ -76,8 +281,15 @@ public:
 private:
     ProgressiveLOD& GetLODController(); 
     void SetupBuffers();
+    void UploadVertexBuffer();
+    void UploadIndexBuffer();
+    GLenum SelectIndexType() const;
+    size_t IndexSize() const { return indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t); }
     void ClearGPUResources();
     void CheckGLError(int line);
+    void RecordUploadSize();
+    void ComputeBounds();
+    void ApplyResidency();
 
     /**
      * @brief 将偏移量转换为指针
@@ -90,10 +302,34 @@ private:
 
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
+    std::vector<LODLevel> lodLevels;
+    // PositionsOnly 策略下的拾取副本（完整副本释放后才存在）
+    std::vector<glm::vec3> pickPositions;
+    std::vector<unsigned int> pickIndices;
+    Residency residency = Residency::Keep;
+    Reloader reloader;
+    std::vector<Meshlet> meshlets;
+    // DrawRanges 的参数缓冲，逐帧复用
+    mutable std::vector<GLsizei> multiDrawCounts;
+    mutable std::vector<const void*> multiDrawOffsets;
+    mutable std::vector<GLint> multiDrawBaseVertices;
+    VertexFormat vertexFormat = VertexFormat::Float32;
+    GLenum indexType = GL_UNSIGNED_INT;
     std::unique_ptr<ProgressiveLOD> lod_controller;
-    // OpenGL对象
-    GLuint VAO = 0;
-    GLuint VBO = 0;
-    GLuint EBO = 0;
+    // 共享缓冲池中的块
+    GpuBufferArena* arena = nullptr;
+    GpuBufferArena::Handle arenaBlock = GpuBufferArena::InvalidHandle;
     bool isUploaded = false;
+    // 最近一次上传的数据规模
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    size_t drawIndexCount = 0;
+    size_t gpuVertexBytes = 0;
+    size_t gpuIndexBytes = 0;
+    glm::vec3 positionOffset{0.0f};
+    glm::vec3 positionScale{1.0f};
+    glm::vec3 boundsCenter{0.0f};
+    float boundsRadius = 0.0f;
+    glm::vec3 boundsMin{0.0f};
+    glm::vec3 boundsMax{0.0f};
 };
@@ -0,0 +1,64 @@
+﻿// MeshOptimizer.h
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Vertex.h"
+
+/**
+ * @class MeshOptimizer
+ * @brief 加载时的网格顺序优化（只重排，不改变几何）
+ *
+ *  - 顶点缓存：Tipsify（Sander 等 2007）按扇形输出三角形，提高后变换缓存命中率；
+ *  - 过度绘制：把 Tipsify 的死路处切成簇，合并到冷缓存 ACMR 不超过阈值，
+ *    再按簇朝外程度从大到小排序，先画遮挡者；
+ *  - 顶点读取：按首次引用顺序重排顶点并重映射索引，未被引用的顶点被丢弃。
+ * 只做 CPU 计算，在创建 Mesh（上传 GPU）之前调用，可在工作线程执行。
+ */
+class MeshOptimizer {
+public:
+    struct Options {
+        size_t cacheSize = 16;            // 模拟的 FIFO 顶点缓存大小
+        float overdrawThreshold = 1.05f;  // 过度绘制排序允许 ACMR 变差的倍数，小于 1 时不排序
+        bool optimizeVertexFetch = true;
+    };
+
+    /// 后变换顶点缓存统计（FIFO 模拟）
+    struct CacheStatistics {
+        float acmr = 0.0f;  // 每个三角形的平均缓存未命中数，理想值约 0.5
+        float atvr = 0.0f;  // 未命中数 / 被引用顶点数，1 为最优
+    };
+
+    struct Report {
+        CacheStatistics before;
+        CacheStatistics after;
+    };
+
+    static Report Optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        return Optimize(vertices, indices, Options{});
+    }
+
+    /**
+     * @brief 依次做顶点缓存、过度绘制与顶点读取优化
+     * @throws std::runtime_error 索引数量不是 3 的倍数或索引越界
+     */
+    static Report Optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const Options& options);
+
+    /**
+     * @brief Tipsify 顶点缓存优化
+     * @param clusters 非空时输出各簇（死路处切分）起始的三角形序号，第一个为 0
+     * @return 重排后的索引
+     */
+    static std::vector<uint32_t> OptimizeVertexCache(std::span<const uint32_t> indices, size_t vertexCount,
+                                                     size_t cacheSize, std::vector<uint32_t>* clusters = nullptr);
+
+    /// 按簇排序降低过度绘制；clusters 为 OptimizeVertexCache 输出的簇起点
+    static void OptimizeOverdraw(std::span<const Vertex> vertices, std::vector<uint32_t>& indices,
+                                 std::span<const uint32_t> clusters, size_t cacheSize, float threshold);
+
+    /// 按首次引用顺序重排顶点并重映射索引，丢弃未被引用的顶点
+    static void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::span<uint32_t> indices);
+
+    static CacheStatistics AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount,
+                                              size_t cacheSize = 16);
+};
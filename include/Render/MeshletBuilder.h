@@ -0,0 +1,62 @@
+﻿// MeshletBuilder.h
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Frustum.h"
+#include "Mesh.h"
+#include "Vertex.h"
+
+/**
+ * @class MeshletBuilder
+ * @brief 把网格切分为小簇（meshlet），供 CPU 逐簇剔除（加载时或离线）
+ *
+ * 贪心生长：从未分配的三角形出发，每次加入与簇共享顶点最多、离簇中心最近的相邻三角形，
+ * 直到顶点数或三角形数达到上限。三角形按簇重新排列，使每个簇是索引缓冲中连续的一段，
+ * 簇内再按顶点缓存重排。每个簇记录包围球与法线锥。只做 CPU 计算，可在工作线程调用。
+ */
+class MeshletBuilder {
+public:
+    struct Options {
+        size_t maxVertices = 96;          // 每簇最多引用的顶点数
+        size_t maxTriangles = 128;        // 每簇最多三角形数
+        size_t minMeshTriangles = 4096;   // 三角形少于该值的网格不切分，整体绘制
+        size_t cacheSize = 16;            // 簇内三角形重排时模拟的顶点缓存大小，0 表示不重排
+    };
+
+    static std::vector<Mesh::Meshlet> Build(std::span<const Vertex> vertices, std::span<uint32_t> indices) {
+        return Build(vertices, indices, Options{});
+    }
+
+    /**
+     * @brief 切分网格
+     * @param indices 三角形索引，按簇重新排列（三角形集合不变）
+     * @return 按索引位置排列的簇；网格过小时为空
+     * @throws std::runtime_error 索引数量不是 3 的倍数或索引越界
+     */
+    static std::vector<Mesh::Meshlet> Build(std::span<const Vertex> vertices, std::span<uint32_t> indices,
+                                            const Options& options);
+};
+
+/**
+ * @class MeshletCuller
+ * @brief 逐簇视锥与背面剔除（模型空间，纯 CPU）
+ */
+class MeshletCuller {
+public:
+    struct Statistics {
+        size_t visible = 0;
+        size_t frustumCulled = 0;
+        size_t backfaceCulled = 0;
+    };
+
+    /**
+     * @brief 剔除不可见的簇，相邻的可见簇合并为一个绘制范围
+     * @param frustum 模型空间视锥（由 projection * view * model 构造）
+     * @param camera 模型空间相机位置
+     * @param coneCulling 是否按法线锥剔除整簇背向相机的簇（相当于开启背面剔除）
+     * @param ranges 输出的绘制范围（先清空）
+     */
+    static Statistics Cull(std::span<const Mesh::Meshlet> meshlets, const Frustum& frustum, const glm::vec3& camera,
+                           bool coneCulling, std::vector<Mesh::IndexRange>& ranges);
+};
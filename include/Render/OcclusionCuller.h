@@ -0,0 +1,103 @@
+﻿// OcclusionCuller.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @class OcclusionCuller
+ * @brief CPU 软件光栅化的层次 Z（Hi-Z）遮挡剔除
+ *
+ * 每帧先把少量遮挡体（低 LOD 的三角形）光栅化到低分辨率深度缓冲，再逐级取最远深度生成 Hi-Z 金字塔，
+ * 然后把被测物体的包围盒投影到屏幕，选一个覆盖不超过 4×4 纹素的层级比较最近深度。
+ * 深度缓冲保存 1/w（与视距成反比，屏幕空间内线性插值，越大越近，清空为 0），
+ * 远处不会像 z/w 那样挤在 1 附近。光栅化是内侧保守的：只写入被三角形完全覆盖的像素，
+ * 写入值取像素范围内最远的深度；SSE 路径每次处理同一行的 4 个像素，与标量路径的运算顺序一致，结果逐位相同。
+ * 与近平面相交、投影出屏幕或覆盖未写入像素的包围盒都视为可见，因此测试只会漏剔，不会误剔；
+ * 代价是共享边两侧的像素不写入，细碎的遮挡体在低分辨率下几乎不起作用。只做 CPU 计算，与 GL 无关。
+ */
+class OcclusionCuller {
+public:
+    enum class Backend : uint8_t { Scalar, SSE };
+
+    struct Statistics {
+        size_t occluders = 0;           // 本帧光栅化的遮挡体
+        size_t triangles = 0;           // 提交的遮挡三角形
+        size_t rasterizedTriangles = 0; // 裁剪、退化剔除后实际光栅化的三角形（近平面裁剪可能一分为二）
+        size_t tests = 0;
+        size_t occluded = 0;
+    };
+
+    explicit OcclusionCuller(int width = 256, int height = 128) { Resize(width, height); }
+
+    /// 设置深度缓冲分辨率（宽高至少为 1）
+    void Resize(int width, int height);
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+
+    /// 开始新的一帧：清空深度缓冲与统计
+    void Begin(const glm::mat4& viewProjection);
+
+    /**
+     * @brief 光栅化一个遮挡体（不做背面剔除）
+     * @param model 模型矩阵
+     * @param positions 第一个顶点位置（3 个 float）
+     * @param stride 相邻顶点位置之间的字节跨距
+     * @param indices 三角形列表，越界索引的三角形被跳过
+     */
+    void RasterizeOccluder(const glm::mat4& model, const float* positions, size_t stride, size_t vertexCount,
+                           const uint32_t* indices, size_t indexCount) {
+        RasterizeOccluder(model, positions, stride, vertexCount, indices, indexCount, BestBackend());
+    }
+    void RasterizeOccluder(const glm::mat4& model, const float* positions, size_t stride, size_t vertexCount,
+                           const uint32_t* indices, size_t indexCount, Backend backend);
+
+    /// 由深度缓冲生成 Hi-Z 金字塔，光栅化完所有遮挡体后、测试之前调用
+    void BuildHiZ();
+
+    /**
+     * @brief 模型空间包围盒是否可能可见
+     * @return false 表示被已光栅化的遮挡体完全挡住
+     */
+    bool IsVisible(const glm::mat4& model, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+    /// 世界空间包围盒是否可能可见
+    bool IsVisible(const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+        return IsVisible(glm::mat4(1.0f), boundsMin, boundsMax);
+    }
+
+    /// 第 0 级深度（1/w），行主序，每行 GetWidth() 个
+    std::vector<float> GetDepth() const;
+    const Statistics& GetStatistics() const { return stats; }
+
+    static bool IsSupported(Backend backend);
+    static Backend BestBackend();
+    static const char* BackendName(Backend backend);
+
+private:
+    /// 屏幕空间顶点：像素坐标与 1/w
+    struct ScreenVertex {
+        float x, y, invW;
+    };
+
+    struct Level {
+        int width = 0;
+        int height = 0;
+        std::vector<float> depth;
+    };
+
+    void RasterizeClipped(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c, Backend backend);
+    void RasterizeTriangle(const ScreenVertex& v0, const ScreenVertex& v1, const ScreenVertex& v2, Backend backend);
+
+    static constexpr int Lanes = 4;             // 每行补齐到 4 的倍数，SSE 可整组读写
+    static constexpr float DepthBias = 1e-5f;   // 被测物体需比遮挡深度远出该比例才判为遮挡
+
+    int width = 0;
+    int height = 0;
+    int pitch = 0;                // 深度缓冲每行的元素数
+    std::vector<float> depth;     // 第 0 级，pitch × height
+    std::vector<Level> pyramid;   // 第 1 级起
+    glm::mat4 viewProjection{1.0f};
+    bool hizReady = false;        // 金字塔与当前深度缓冲一致，未生成时测试一律返回可见
+    Statistics stats;
+};
@@ -1,30 +1,56 @@
 ﻿#pragma once
 #include "Vertex.h"
-#include <queue>
+#include "QuadricSimplifier.h"
+#include <functional>
+#include <future>
+#include <optional>
+#include <span>
 #include <vector>
-#include <unordered_map>
 #include <stdexcept>
 #include <glm/glm.hpp>
 
 class Mesh; // 前向声明
+namespace Mirror { namespace Core { class ThreadPool; } }
 
+/**
+ * @class ProgressiveLOD
+ * @brief 网格的连续 LOD 控制（Hoppe 渐进网格）
+ *
+ * 预计算时用二次误差简化器一直简化到底，记录每次半边折叠改写的角点与删除的三角形。
+ * 三角形按删除先后倒序排列，任一细节级别的可见三角形都是索引缓冲的前缀；
+ * 调整比例时只正向重放（折叠）或反向恢复（顶点分裂）两级之间的记录，
+ * 上传改动过的索引区间并修改绘制数量，开销与变化量成正比。顶点缓冲始终不变。
+ * 预计算只涉及 CPU 数据，可交给任务池异步执行，完成后在 GL 线程上应用；
+ * 已释放 CPU 副本的网格在任务中通过 Reloader 重建源数据，不占用 GL 线程。
+ * 重排索引会让离散 LOD 与簇表失效，因此预计算结果先保留，直到第一次请求大于 0 的比例时才写入网格；
+ * 在此之前网格保持原样，离散 LOD 与逐簇剔除照常工作。
+ */
 class ProgressiveLOD {
 public:
     struct Parameters {
-        float geometry_weight = 0.7f;
-        float normal_weight   = 0.2f;
-        float uv_weight       = 0.1f;
-        bool  preserve_topology     = true;
-        int   max_collapses_per_frame = 50;
+        float geometry_weight = 1.0f;    // 几何误差权重
+        float normal_weight   = 0.05f;   // 法线误差权重
+        float uv_weight       = 0.05f;   // 纹理坐标误差权重
+        bool  preserve_topology = true;  // 保持边界与流形结构
     };
 
     explicit ProgressiveLOD(Mesh& mesh);
 
-    /// 预先计算所有边的 collapse 候选和优先队列
+    /// 记录完整的折叠序列；有进行中的异步预计算时等待其完成
     void Precompute();
-    /// 按给定 ratio（[0,1]）进行可逆简化
+    /**
+     * @brief 在任务池上异步预计算：快照网格数据（或复制其 Reloader）后立即返回
+     *
+     * 结果在之后的 Poll / SimplifyTo 中于调用线程（GL 线程）应用，
+     * 其间请求的比例在完成后生效。快照独立于网格，网格可在计算期间销毁。
+     */
+    void PrecomputeAsync(Mirror::Core::ThreadPool& pool);
+    /// 异步预计算完成时接收结果，返回预计算是否已可用
+    bool Poll();
+    bool IsReady() const { return is_precomputed; }
+    /// 切换到给定 ratio（[0,1]，0 为原始网格），可双向调整
     void SimplifyTo(float ratio);
-    /// 更新参数（geometry/normal/uv 权重、拓扑保持、每帧最大折叠数）
+    /// 更新参数（geometry/normal/uv 权重、拓扑保持），按当前比例重新简化
     void UpdateParameters(const Parameters& new_params);
 
     size_t GetCurrentVertices() const { return current_vertex_count; }
@@ -32,28 +58,42 @@ public:
     const Parameters& GetParameters() const { return active_params; }
 
 private:
-    // 一条边的 collapse 候选
-    struct EdgeCollapse {
-        size_t v1, v2;
-        float  collapse_cost;
-        std::vector<size_t> affected_triangles;
+    // 取得顶点与第 0 级索引，签名与 Mesh::Reloader 相同
+    using SourceLoader = std::function<void(std::vector<Vertex>&, std::vector<unsigned int>&)>;
+
+    // 预计算结果：只含 CPU 数据，可在工作线程生成
+    struct Build {
+        QuadricSimplifier::CollapseHistory history;
+        std::vector<uint32_t> indices;  // 按删除先后重排后的索引
+        size_t source_vertex_count = 0;
+        std::vector<Vertex> vertices;          // 构建所用的顶点，网格已释放 CPU 副本时直接装回
+        std::vector<uint32_t> source_indices;  // 第 0 级的原始索引
     };
 
-    // —— 内部方法 —— 
-    float ComputeCollapseCost(size_t v1, size_t v2) const;
-    void  ApplyEdgeCollapse(const EdgeCollapse& collapse);
-    void  RemoveDegenerateTriangles();
-    void  RebuildPriorityQueue();
-    void  ResetToOriginal();
+    static Build BuildProgressiveMesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+                                      const Parameters& params);
+    /// 取源数据并构建，可在工作线程执行
+    static Build BuildFromSource(const SourceLoader& source, const Parameters& params);
+    SourceLoader SnapshotSource() const;
+    void   ReceiveBuild(Build&& build);
+    bool   ApplyBuild();
+    void   InstallBuild(Build&& build);
+    size_t TargetStep(float ratio) const;
+    void   ApplyStep(size_t step, bool forward);
+    void   UploadChanges();
 
-    // 原始网格数据快照
-    std::vector<Vertex>   original_vertices;
+    // 已写入网格的构建所用的第 0 级原始索引：参数变化时从它重新构建
     std::vector<uint32_t> original_indices;
-
-    // 当前有效性与候选列表
-    std::vector<bool>           vertex_validity;
-    std::vector<EdgeCollapse>   collapse_candidates;
-    std::priority_queue<std::pair<float, size_t>> collapse_queue;
+    std::future<Build> pending_build;  // 进行中的异步预计算
+    std::optional<Build> unapplied;    // 已完成、尚未写入网格的预计算结果
+    bool is_applied = false;           // 网格索引已按折叠序列重排
+    bool build_failed = false;
+    // 折叠记录，角点已换算为重排后的索引位置
+    QuadricSimplifier::CollapseHistory history;
+    size_t source_vertex_count = 0;
+    size_t triangle_count      = 0;  // 重排后的三角形总数
+    size_t current_step        = 0;  // 已执行的折叠数
+    std::vector<uint32_t> changed_indices;  // 本次切换改动的索引位置
 
     Mesh&              target_mesh;
     Parameters         active_params;
@@ -61,6 +101,6 @@ private:
     float              current_error   = 0.0f;
     bool               is_precomputed  = false;
 
-    // 用于可逆控制
-    float last_ratio = 0.0f;
+    float last_ratio = 0.0f;       // 当前已应用的比例
+    float requested_ratio = 0.0f;  // 最近一次请求的比例
 };
@@ -0,0 +1,200 @@
+﻿// QuadricSimplifier.h
+#pragma once
+#include <span>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Vertex.h"
+
+/**
+ * @class QuadricSimplifier
+ * @brief 基于二次误差度量（Garland-Heckbert QEM）的网格简化
+ *
+ *  - 半边折叠：顶点只会并入相邻的已有顶点，顶点缓冲保持不变，简化结果只体现在索引上；
+ *  - 几何误差为到原始三角形平面的面积加权距离平方，法线与纹理坐标按三角形内的属性梯度
+ *    （Hoppe 1999）计入同一个二次型；
+ *  - 位置相同的顶点（法线/UV 接缝处的拷贝）焊接后参与拓扑判断，接缝两侧一起折叠；
+ *  - 维护顶点到三角形的邻接表，折叠只触及相关三角形；
+ *  - 每个顶点缓存其最佳折叠，只有邻域被改动过的顶点才重新计算（惰性更新）。每一轮把缓存的
+ *    候选按代价排序后依次执行，执行前重新检查拓扑；代价超过本轮目标附近的误差时进入下一轮。
+ * 误差在包围盒归一化到单位立方体的坐标下计算，与模型尺度无关；GetError 换算回模型单位。
+ * 构造时的误差二次型与顶点分类按顶点区间在共享任务池上并行（Options::parallelSetup 可关闭），
+ * 折叠过程本身是串行的。
+ */
+class QuadricSimplifier {
+public:
+    struct Options {
+        float geometryWeight = 1.0f;    // 几何误差权重
+        float normalWeight = 0.05f;     // 法线误差权重（法线各分量乘以该值后参与误差）
+        float uvWeight = 0.05f;         // 纹理坐标误差权重
+        bool  preserveTopology = true;  // 非流形顶点不动、边界顶点只沿边界折叠，并检查连接条件
+        bool  parallelSetup = true;     // 构造时的预处理允许在共享任务池上并行（结果与串行逐位相同）
+    };
+
+    /// 一个三角形角点的改写：corner = 3 * 三角形序号 + 角，顶点为原始顶点索引
+    struct CornerChange {
+        uint32_t corner;
+        uint32_t oldVertex;
+        uint32_t newVertex;
+    };
+    /// 一次折叠在历史数组中的范围（CSR 结束位置）及折叠后的状态
+    struct CollapseStep {
+        uint32_t changeEnd;
+        uint32_t removedEnd;
+        uint32_t vertexCount;
+        float error;  // 折叠后的 GetError()
+    };
+    /**
+     * @brief 折叠历史：按执行顺序记录每次折叠改写的角点与删除的三角形
+     *
+     * 三角形序号即构造后首次 GetIndices() 返回的三角形顺序。
+     * 正向重放改写并删除三角形即为简化，反向恢复即为顶点分裂（Hoppe 渐进网格）。
+     */
+    struct CollapseHistory {
+        std::vector<CollapseStep> steps;
+        std::vector<CornerChange> changes;
+        std::vector<uint32_t> removedTriangles;
+    };
+
+    QuadricSimplifier(std::span<const Vertex> vertices, std::span<const uint32_t> indices)
+        : QuadricSimplifier(vertices, indices, Options{}) {}
+    QuadricSimplifier(std::span<const Vertex> vertices, std::span<const uint32_t> indices, const Options& options);
+
+    /**
+     * @brief 按代价从小到大折叠，直到剩余顶点数不超过目标或无法继续
+     * @return 剩余顶点数
+     */
+    size_t SimplifyTo(size_t targetVertexCount);
+
+    /// 记录此后执行的每次折叠；传入 nullptr 停止记录
+    void RecordHistory(CollapseHistory* target) { history = target; }
+
+    /// 被三角形引用的原始顶点数
+    size_t GetSourceVertexCount() const { return sourceVertexCount; }
+    size_t GetVertexCount() const { return vertexCount; }
+    size_t GetTriangleCount() const { return triangleCount; }
+
+    /// 已执行折叠中的最大误差（模型单位，近似为到原表面的距离）
+    float GetError() const;
+
+    /// 当前的三角形索引（引用原始顶点缓冲）
+    std::vector<uint32_t> GetIndices() const;
+
+private:
+    static constexpr int AttributeCount = 5;  // 法线 xyz + uv
+    static constexpr uint32_t Invalid = ~0u;
+    static constexpr size_t ParallelGrain = 16384;    // 并行预处理时每块的最少顶点数
+    static constexpr size_t MinParallelThreads = 4;   // 按组重复计算三角形项，线程少于该值时串行更快
+
+    // 对称 4x4 二次型（上三角部分）及累计权重。
+    // 以所属顶点为原点的局部坐标表示，求值时各项量级接近误差本身，避免 float 相消
+    struct Quadric {
+        float a00 = 0, a11 = 0, a22 = 0;
+        float a10 = 0, a20 = 0, a21 = 0;
+        float b0 = 0, b1 = 0, b2 = 0;
+        float c = 0;
+        float w = 0;
+
+        void Add(const Quadric& other);
+        /// 累加平面 n·x + d = 0 的距离平方项
+        void AddPlane(const glm::vec3& n, float d, float weight);
+        /// 原点平移 t 后的二次型：Q'(x) = Q(x + t)
+        Quadric Translated(const glm::vec3& t) const;
+        float Evaluate(const glm::vec3& x) const;
+    };
+    // 单个属性在三角形平面内的梯度项
+    struct QuadricGrad {
+        float gx = 0, gy = 0, gz = 0, gw = 0;
+    };
+
+    // 单个三角形对各角误差二次型的贡献（与所属角无关的部分）
+    struct TriangleTerms {
+        glm::vec3 normal;
+        float area;
+        glm::vec3 gradients[AttributeCount];  // 属性梯度，已乘面积
+        Quadric gradientTerms;
+    };
+
+    enum class VertexKind : uint8_t { Manifold, Border, Locked };
+
+    struct Candidate {
+        float cost = 0.0f;
+        uint32_t from = Invalid;  // 被移除的顶点（焊接后的位置组）
+        uint32_t to = Invalid;    // 保留的顶点
+    };
+
+    void Weld(std::span<const Vertex> vertices, std::span<const uint32_t> indices);
+    void BuildAdjacency();
+    void ClassifyVertices();
+    void BuildQuadrics();
+    bool ComputeTriangleTerms(uint32_t t, TriangleTerms& terms) const;
+    void AddTriangleTerms(const TriangleTerms& terms, uint32_t t, int k);
+    void AddBorderPlane(uint32_t g, uint32_t n);
+    Candidate FindBestCollapse(uint32_t group, bool validate);
+    bool IsValidCollapse(uint32_t from, uint32_t to);
+
+    bool CanMove(uint32_t from, uint32_t to) const;
+    size_t SharedTriangles(uint32_t a, uint32_t b) const;
+    bool PassesLinkCondition(uint32_t from, uint32_t to, size_t shared);
+    bool HasFlippedTriangles(uint32_t from, uint32_t to) const;
+    uint32_t MatchWedge(uint32_t wedge, uint32_t group) const;
+    float AttributeError(uint32_t wedge, const glm::vec3& offset, const float* target) const;
+    float CollapseCost(uint32_t from, uint32_t to) const;
+    void Collapse(uint32_t from, uint32_t to, float cost);
+
+    std::span<const uint32_t> Triangles(uint32_t group) const {
+        return { adjacency.data() + adjacencyOffset[group], adjacencyCount[group] };
+    }
+    std::span<const uint32_t> Wedges(uint32_t group) const {
+        return { wedges.data() + wedgeOffset[group], wedgeOffset[group + 1] - wedgeOffset[group] };
+    }
+    const float* Attributes(uint32_t wedge) const { return attributes.data() + size_t(wedge) * AttributeCount; }
+
+    Options options;
+    float scale = 1.0f;  // 归一化坐标到模型单位
+
+    // 焊接后的位置组：拓扑意义上的"顶点"
+    std::vector<glm::vec3> positions;    // 归一化位置
+    std::vector<uint32_t> wedgeOffset;   // 每组包含的原始顶点（CSR）
+    std::vector<uint32_t> wedges;
+    std::vector<VertexKind> kinds;
+    std::vector<uint8_t> groupAlive;
+
+    // 每个原始顶点的加权属性
+    std::vector<float> attributes;
+
+    // 三角形：组与原始顶点两套索引，折叠时同步改写
+    std::vector<uint32_t> triangleGroups;
+    std::vector<uint32_t> triangleWedges;
+    std::vector<uint8_t> triangleAlive;
+
+    // 顶点到三角形的邻接：折叠后的新列表追加到池尾
+    std::vector<uint32_t> adjacencyOffset;
+    std::vector<uint32_t> adjacencyCount;
+    std::vector<uint32_t> adjacency;
+
+    std::vector<Quadric> geometryQuadrics;    // 每组
+    std::vector<Quadric> attributeQuadrics;   // 每个原始顶点
+    std::vector<QuadricGrad> attributeGrads;  // 每个原始顶点 × AttributeCount
+
+    std::vector<Candidate> bestCollapse;  // 每组缓存的最佳折叠
+    // 缓存状态：Stale 需要重新计算，NeedsValidation 上次的最佳折叠执行时未通过拓扑检查
+    static constexpr uint8_t Clean = 0, Stale = 1, NeedsValidation = 2;
+    std::vector<uint8_t> dirty;
+    std::vector<Candidate> candidates;    // 本轮候选
+    std::vector<uint32_t> updatedPass;    // 误差二次型最近一次改变的轮次
+    uint32_t pass = 0;
+    CollapseHistory* history = nullptr;
+
+    size_t sourceVertexCount = 0;
+    size_t vertexCount = 0;
+    size_t triangleCount = 0;
+    float maxError = 0.0f;
+
+    // 邻域遍历的标记数组，按 stamp 区分，避免每次清零
+    std::vector<uint32_t> markA, markB;
+    uint32_t stamp = 0;
+    std::vector<uint32_t> scratch;
+    std::vector<std::pair<float, uint32_t>> neighborCosts;
+};
@@ -0,0 +1,94 @@
+﻿// RenderQueue.h
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class RenderQueue
+ * @brief 按排序键排列的绘制列表
+ *
+ * 每个绘制项压成一个 64 位整数：高 44 位为排序键，低 20 位为调用方的序号。
+ * Sort 只对键所在的 44 位做 LSD 基数排序（每趟 11 位，共 4 趟，所有项在某一位段上相同时跳过该趟），
+ * 键相同的项按序号排列，等同稳定排序。键由高到低为：
+ *   不透明：渲染队列(12) | 着色器(6) | 材质(8) | 网格(8) | 由近到远的深度(10)
+ *   透明：  渲染队列(12) | 由远到近的深度(20) | 着色器(4) | 材质(4) | 网格(4)
+ * 不透明物体按状态分组、组内大致由近到远以利于提前深度测试；透明物体严格由远到近。
+ * 着色器、材质与网格取指针的散列，冲突只会让分组变差，不影响正确性。
+ * 序号超出 20 位（超过 MaxItems 个绘制项）时改用键与序号分开存放的 16 字节项，并退回比较排序。
+ * 深度为视线方向距离，按浮点位模式截取高位量化（单调，相对精度固定），负值视为 0。
+ */
+class RenderQueue {
+public:
+    static constexpr int KeyBits = 44;
+    static constexpr int IndexBits = 64 - KeyBits;
+    static constexpr uint32_t MaxItems = 1u << IndexBits;
+
+    void Clear() {
+        entries.clear();
+        wideEntries.clear();
+    }
+    void Reserve(size_t count) {
+        if (count <= MaxItems) entries.reserve(count);
+        else wideEntries.reserve(count);
+    }
+
+    /// key 只取低 44 位
+    void Push(uint64_t key, uint32_t index) {
+        key &= (uint64_t(1) << KeyBits) - 1;
+        if (index >= MaxItems && wideEntries.empty()) Widen();
+        if (!wideEntries.empty()) wideEntries.push_back({ key, index });
+        else entries.push_back(key << IndexBits | index);
+    }
+
+    size_t Size() const { return wideEntries.empty() ? entries.size() : wideEntries.size(); }
+    uint64_t GetKey(size_t position) const {
+        return wideEntries.empty() ? entries[position] >> IndexBits : wideEntries[position].key;
+    }
+    uint32_t GetIndex(size_t position) const {
+        return wideEntries.empty() ? static_cast<uint32_t>(entries[position] & (MaxItems - 1))
+                                   : wideEntries[position].index;
+    }
+
+    /// 按键升序排序，键相同时按序号
+    void Sort();
+
+    static uint64_t OpaqueKey(int queue, const void* shader, const void* material, const void* mesh, float depth) {
+        return QueueBits(queue) << 32 | Hash(shader, 6) << 26 | Hash(material, 8) << 18 | Hash(mesh, 8) << 10
+             | DepthBits(depth, 10);
+    }
+
+    static uint64_t TransparentKey(int queue, const void* shader, const void* material, const void* mesh, float depth) {
+        return QueueBits(queue) << 32 | (DepthBits(depth, 20) ^ 0xFFFFFu) << 12 | Hash(shader, 4) << 8
+             | Hash(material, 4) << 4 | Hash(mesh, 4);
+    }
+
+private:
+    struct WideEntry {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    /// 把已压入的项转为 16 字节项，之后的 Push 都写入 wideEntries
+    void Widen();
+
+    static uint64_t QueueBits(int queue) { return static_cast<uint64_t>(std::clamp(queue, 0, (1 << 12) - 1)); }
+
+    /// 指针的乘法散列，取高 bits 位
+    static uint64_t Hash(const void* pointer, int bits) {
+        const uint64_t value = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer));
+        return (value * 0x9E3779B97F4A7C15ull) >> (64 - bits);
+    }
+
+    /// 正浮点数的位模式（去掉符号位）随数值单调递增，截取高 bits 位即为对数式量化
+    static uint64_t DepthBits(float depth, int bits) {
+        if (!(depth > 0.0f)) return 0;
+        return static_cast<uint64_t>((std::bit_cast<uint32_t>(depth) << 1) >> (32 - bits));
+    }
+
+    std::vector<uint64_t> entries;
+    std::vector<WideEntry> wideEntries;  // 非空时取代 entries
+    std::vector<uint64_t> scratch;
+    std::vector<uint32_t> histograms;  // 每趟一个 2048 桶的直方图，逐帧复用
+};
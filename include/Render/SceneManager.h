@@ -2,8 +2,16 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <limits>
+#include <unordered_map>
 #include "Render/Light/Light.h"
 #include "Entity.h"
+#include "Frustum.h"
+#include "FrustumCuller.h"
+#include "GLStateCache.h"
+#include "BoundingVolumeHierarchy.h"
+#include "OcclusionCuller.h"
+#include "RenderQueue.h"
 
 class SceneManager {
 public:
@@ -18,6 +26,61 @@ public:
 
     Light light; // << 新增成员变量
 
+    /// 提交前的视锥剔除方式
+    enum class CullingMode {
+        None,  // 不剔除
+        Flat,  // 逐帧重写全部包围球，SIMD 线性扫描
+        BVH,   // 动态 BVH：只更新变换或网格变化的实体，层次遍历
+    };
+    CullingMode culling = CullingMode::BVH;
+
+    /// 视锥剔除之后的软件遮挡剔除：屏幕上最大的不透明实体作为遮挡体（默认关闭）
+    struct OcclusionOptions {
+        bool enabled = false;
+        size_t maxOccluders = 32;
+        size_t maxTriangles = 32768;  // 每帧光栅化的遮挡三角形上限
+        float minOccluderSize = 0.1f; // 包围球半径 / 距离低于该值的实体不作为遮挡体
+    };
+    OcclusionOptions occlusion;
+
+    struct CullStatistics {
+        size_t entities = 0;
+        size_t visible = 0;
+        size_t bvhMoved = 0;     // 本帧包围盒更新的实体
+        size_t bvhInserted = 0;  // 本帧新加入的实体
+        size_t bvhRemoved = 0;   // 本帧移出场景的实体
+        size_t occluders = 0;
+        size_t occluderTriangles = 0;
+        size_t occluded = 0;     // 通过视锥剔除但被遮挡的实体
+    };
+    const CullStatistics& GetCullStatistics() const { return cullStats; }
+    const BoundingVolumeHierarchy& GetBVH() const { return bvh; }
+    const OcclusionCuller& GetOcclusionCuller() const { return occlusionCuller; }
+
+    /**
+     * @brief 拾取：世界空间射线经 BVH 粗筛后与网格三角形求交（需网格保留拾取数据）
+     * @param direction 无需归一化，distance 以其长度为单位
+     * @return 最近命中的实体；BVH 反映最近一次 RenderScene 时的场景
+     */
+    std::shared_ptr<Entity> Pick(const glm::vec3& origin, const glm::vec3& direction, float* distance = nullptr) const {
+        uint32_t item = 0;
+        float nearest = std::numeric_limits<float>::max();
+        const bool hit = bvh.Raycast(origin, direction, [&](uint32_t slot, float maxDistance) {
+            const Entity& entity = *bvhRecords[slot].entity;
+            if (!entity.mesh || !entity.mesh->HasPickingData()) return -1.0f;
+            // 仿射变换下射线参数 t 不变，在模型空间求交即可
+            const glm::mat4 inverseModel = glm::inverse(entity.transform->GetGlobalMatrix());
+            float t = 0.0f;
+            if (!entity.mesh->Raycast(glm::vec3(inverseModel * glm::vec4(origin, 1.0f)),
+                                      glm::vec3(inverseModel * glm::vec4(direction, 0.0f)), t) || t > maxDistance)
+                return -1.0f;
+            return t;
+        }, item, nearest);
+        if (!hit) return nullptr;
+        if (distance) *distance = nearest;
+        return bvhRecords[item].entity;
+    }
+
     // 实现ClearEntities (与声明严格一致)
     void ClearEntities(){ // [!++ 新增实现]
         entities.clear();
@@ -25,42 +88,268 @@ public:
     }
 
     
-    void RenderScene(const glm::mat4& view, const glm::mat4& projection) {
+    void RenderScene(const glm::mat4& view, const glm::mat4& projection, float viewportHeight) {
         // 计算公共矩阵
         //const glm::mat4 viewProj = projection * view;
-        
+
+        // 视锥剔除，只对可见实体排序与提交
+        CollectVisible(Frustum(projection * view));
+        CacheTransforms(view);
+        cullStats.occluders = cullStats.occluderTriangles = cullStats.occluded = 0;
+        if (occlusion.enabled && renderList.size() > 1) CullOccluded(view, projection);
+        cullStats.entities = entities.size();
+        cullStats.visible = renderList.size();
+
         // 排序优化
-        SortEntities(view);
-        
+        SortEntities();
+
         // 统一渲染流程
-        for(const auto& entity : entities) {
-            if(entity->IsRenderable()) {
-                // 增加这三个参数设置步骤 ▶ 核心添加部分
-                entity->material->SetVector3("lightColor", light.color);
-                entity->material->SetVector3("lightDir", light.direction);
-                entity->material->SetFloat("lightIntensity", light.intensity);
-                entity->Render(view,projection);
-            }
+        for (size_t i = 0; i < renderList.size(); ++i) {
+            Entity* entity = renderList[i];
+            // 增加这三个参数设置步骤 ▶ 核心添加部分
+            entity->material->SetVector3("lightColor", light.color);
+            entity->material->SetVector3("lightDir", light.direction);
+            entity->material->SetFloat("lightIntensity", light.intensity);
+            entity->Render(worldMatrices[i], view, projection, viewportHeight);
         }
+        // 恢复默认状态：深度写入关闭时下一帧的 glClear 清不掉深度缓冲
+        GLStateCache::SetDepthMask(true);
+        GLStateCache::SetBlend(false);
+        GLStateCache::SetCullFace(false);
     }
 
 private:
+    // BVH 中的一个实体；持有引用，移出场景后在下一次同步时释放
+    struct BVHRecord {
+        std::shared_ptr<Entity> entity;
+        BoundingVolumeHierarchy::ProxyId proxy = BoundingVolumeHierarchy::InvalidProxy;
+        uint64_t transformVersion = 0;
+        const Mesh* mesh = nullptr;
+        uint64_t frame = 0;  // 最近一次出现在场景中的帧
+    };
+    // 单帧新增实体超过 BVH 规模的该比例时按 SAH 整体重建，增量插入的树质量较差
+    static constexpr size_t RebuildDivisor = 4;
+
     std::vector<std::shared_ptr<Entity>> entities;
+    std::vector<Entity*> renderList;  // 本帧可见、排序后的实体
+    // 与 renderList 一一对应：每帧对每个可见实体只计算一次世界矩阵与包围球中心的视距
+    std::vector<glm::mat4> worldMatrices;
+    std::vector<float> viewDepths;  // 只在排序前使用，排序后不再随 renderList 重排
+    std::vector<Entity*> sortedList;
+    std::vector<glm::mat4> sortedMatrices;
+    RenderQueue drawQueue;
+    FrustumCuller culler;
+    std::vector<uint32_t> visibleEntities;
+    BoundingVolumeHierarchy bvh;
+    std::vector<BVHRecord> bvhRecords;  // 以 BVH item 为下标
+    std::vector<uint32_t> freeRecords;
+    std::unordered_map<const Entity*, uint32_t> recordOf;
+    uint64_t bvhFrame = 0;
+    OcclusionCuller occlusionCuller;
+    std::vector<std::pair<float, size_t>> occluderCandidates;  // (视角大小, renderList 下标)
+    std::vector<const Entity*> occluders;
+    CullStatistics cullStats;
+
+    void CollectVisible(const Frustum& frustum) {
+        renderList.clear();
+        switch (culling) {
+        case CullingMode::None:
+            for (const auto& entity : entities) {
+                if (entity->IsRenderable()) renderList.push_back(entity.get());
+            }
+            break;
+        case CullingMode::Flat:
+            UpdateBounds();
+            culler.Cull(frustum, visibleEntities);
+            for (uint32_t index : visibleEntities) renderList.push_back(entities[index].get());
+            break;
+        case CullingMode::BVH:
+            SyncBVH();
+            bvh.Cull(frustum, visibleEntities);
+            for (uint32_t slot : visibleEntities) renderList.push_back(bvhRecords[slot].entity.get());
+            break;
+        }
+    }
+
+    /// 可见实体的世界矩阵与视距，遮挡剔除、排序与绘制共用（Transform 每次取全局矩阵都要沿父链重新相乘）
+    void CacheTransforms(const glm::mat4& view) {
+        worldMatrices.resize(renderList.size());
+        viewDepths.resize(renderList.size());
+        for (size_t i = 0; i < renderList.size(); ++i) {
+            const Entity* entity = renderList[i];
+            worldMatrices[i] = entity->transform->GetGlobalMatrix();
+            viewDepths[i] = -(view * (worldMatrices[i] * glm::vec4(entity->mesh->GetBoundsCenter(), 1.0f))).z;
+        }
+    }
+
+    /// 光栅化最大的若干遮挡体并生成 Hi-Z，再从可见列表中去掉被完全挡住的实体
+    void CullOccluded(const glm::mat4& view, const glm::mat4& projection) {
+        // 按包围球的视角大小（半径 / 距离）挑选遮挡体，相机在球内的排在最前
+        const glm::vec3 eye(glm::inverse(view)[3]);
+        occluderCandidates.clear();
+        for (size_t i = 0; i < renderList.size(); ++i) {
+            const Entity* entity = renderList[i];
+            if (entity->IsTransparent()) continue;
+            glm::vec3 center;
+            float radius = 0.0f;
+            if (!entity->GetWorldBounds(worldMatrices[i], center, radius)) continue;
+            const float distance = glm::length(center - eye);
+            const float size = distance > radius ? radius / distance : std::numeric_limits<float>::max();
+            if (size >= occlusion.minOccluderSize) occluderCandidates.emplace_back(size, i);
+        }
+        if (occluderCandidates.empty()) return;
+        std::sort(occluderCandidates.begin(), occluderCandidates.end(),
+                  [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        occlusionCuller.Begin(projection * view);
+        occluders.clear();
+        size_t triangles = 0;
+        for (const auto& [size, index] : occluderCandidates) {
+            if (occluders.size() >= occlusion.maxOccluders) break;
+            const Entity* entity = renderList[index];
+            Mesh::OccluderGeometry geometry;
+            if (!entity->mesh->GetOccluderGeometry(geometry)) continue;
+            if (triangles + geometry.indexCount / 3 > occlusion.maxTriangles) continue;
+            triangles += geometry.indexCount / 3;
+            occlusionCuller.RasterizeOccluder(worldMatrices[index], geometry.positions, geometry.stride,
+                                              geometry.vertexCount, geometry.indices, geometry.indexCount);
+            occluders.push_back(entity);
+        }
+        cullStats.occluders = occluders.size();
+        cullStats.occluderTriangles = triangles;
+        if (occluders.empty()) return;
+        occlusionCuller.BuildHiZ();
+
+        // 遮挡体本身不测试，避免与自身的深度比较
+        const size_t before = renderList.size();
+        size_t kept = 0;
+        for (size_t i = 0; i < before; ++i) {
+            Entity* entity = renderList[i];
+            if (std::find(occluders.begin(), occluders.end(), entity) == occluders.end()
+                && !occlusionCuller.IsVisible(worldMatrices[i], entity->mesh->GetBoundsMin(), entity->mesh->GetBoundsMax()))
+                continue;
+            renderList[kept] = entity;
+            worldMatrices[kept] = worldMatrices[i];
+            viewDepths[kept] = viewDepths[i];
+            ++kept;
+        }
+        renderList.resize(kept);
+        worldMatrices.resize(kept);
+        viewDepths.resize(kept);
+        cullStats.occluded = before - kept;
+    }
+
+    static bool WorldBox(const Entity& entity, BoundingVolumeHierarchy::AABB& box) {
+        glm::vec3 center;
+        float radius = 0.0f;
+        if (!entity.GetWorldBounds(center, radius)) return false;
+        box = { center - radius, center + radius };
+        return true;
+    }
+
+    /// 按本帧的实体列表增删 BVH 条目；变换版本或网格未变的实体不重新计算包围盒
+    void SyncBVH() {
+        ++bvhFrame;
+        cullStats.bvhMoved = cullStats.bvhInserted = cullStats.bvhRemoved = 0;
+        size_t seen = 0;
+        BoundingVolumeHierarchy::AABB box;
+        for (const auto& entity : entities) {
+            if (!entity->IsRenderable()) continue;
+            ++seen;
+            const uint64_t version = entity->transform->GetGlobalVersion();
+            auto [it, inserted] = recordOf.try_emplace(entity.get(), 0u);
+            if (inserted) {
+                // 没有包围体的实体与 Flat 路径一样视为不可见
+                if (!WorldBox(*entity, box)) {
+                    recordOf.erase(it);
+                    --seen;
+                    continue;
+                }
+                uint32_t slot;
+                if (freeRecords.empty()) {
+                    slot = static_cast<uint32_t>(bvhRecords.size());
+                    bvhRecords.emplace_back();
+                } else {
+                    slot = freeRecords.back();
+                    freeRecords.pop_back();
+                }
+                it->second = slot;
+                bvhRecords[slot] = { entity, bvh.Insert(box, slot), version, entity->mesh.get(), bvhFrame };
+                ++cullStats.bvhInserted;
+                continue;
+            }
+            BVHRecord& record = bvhRecords[it->second];
+            if (record.frame == bvhFrame) {  // 同一实体重复加入
+                --seen;
+                continue;
+            }
+            if (record.transformVersion != version || record.mesh != entity->mesh.get()) {
+                if (!WorldBox(*entity, box)) {
+                    --seen;  // 留给下面的清理移除
+                    continue;
+                }
+                record.transformVersion = version;
+                record.mesh = entity->mesh.get();
+                bvh.Move(record.proxy, box);
+                ++cullStats.bvhMoved;
+            }
+            record.frame = bvhFrame;
+        }
+
+        // 本帧未出现（或已不可渲染）的实体移出 BVH；全部出现时不必遍历
+        for (auto it = recordOf.begin(); seen != recordOf.size() && it != recordOf.end();) {
+            BVHRecord& record = bvhRecords[it->second];
+            if (record.frame == bvhFrame) {
+                ++it;
+                continue;
+            }
+            bvh.Remove(record.proxy);
+            record = BVHRecord{};
+            freeRecords.push_back(it->second);
+            it = recordOf.erase(it);
+            ++cullStats.bvhRemoved;
+        }
+
+        if (cullStats.bvhInserted > 0 && cullStats.bvhInserted * RebuildDivisor >= bvh.Size()) bvh.Rebuild();
+    }
+
+    void UpdateBounds() {
+        culler.Resize(entities.size());
+        glm::vec3 center;
+        float radius;
+        for (size_t i = 0; i < entities.size(); ++i) {
+            // 不可渲染的实体写入负半径，剔除阶段直接排除（不必逐个再判断）
+            if (entities[i]->IsRenderable() && entities[i]->GetWorldBounds(center, radius))
+                culler.SetSphere(i, center, radius);
+            else
+                culler.SetSphere(i, glm::vec3(0.0f), -1.0f);
+        }
+    }
     
-    void SortEntities(const glm::mat4& view) {
-        // 按渲染队列排序（不透明物体优先）
-        std::sort(entities.begin(), entities.end(),
-            [](const auto& a, const auto& b) {
-                return a->GetRenderQueue() < b->GetRenderQueue();
-            });
-
-        // 透明物体按深度排序（从后到前）
-        auto transparentStart = std::partition(entities.begin(), entities.end(),
-            [](const auto& e) { return !e->IsTransparent(); });
-        
-        std::sort(transparentStart, entities.end(),
-            [&view](const auto& a, const auto& b) {
-                return a->GetDepth(view) > b->GetDepth(view);
-            });
+    /// 按排序键（渲染队列、状态、视距）对可见列表做基数排序，视距取本帧缓存的值
+    void SortEntities() {
+        drawQueue.Clear();
+        drawQueue.Reserve(renderList.size());
+        for (size_t i = 0; i < renderList.size(); ++i) {
+            const Entity* entity = renderList[i];
+            const Material* material = entity->material.get();
+            const uint64_t key = material->IsTransparent()
+                ? RenderQueue::TransparentKey(material->GetRenderQueue(), material->GetShader().get(), material,
+                                              entity->mesh.get(), viewDepths[i])
+                : RenderQueue::OpaqueKey(material->GetRenderQueue(), material->GetShader().get(), material,
+                                         entity->mesh.get(), viewDepths[i]);
+            drawQueue.Push(key, static_cast<uint32_t>(i));
+        }
+        drawQueue.Sort();
+
+        sortedList.clear();
+        sortedMatrices.clear();
+        for (size_t i = 0; i < drawQueue.Size(); ++i) {
+            const uint32_t index = drawQueue.GetIndex(i);
+            sortedList.push_back(renderList[index]);
+            sortedMatrices.push_back(worldMatrices[index]);
+        }
+        renderList.swap(sortedList);
+        worldMatrices.swap(sortedMatrices);
     }
 };
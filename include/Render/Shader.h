@@ -7,6 +7,8 @@
 #pragma once
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <type_traits>
@@ -17,6 +19,8 @@
  * 
  * 提供着色器程序的创建、编译、链接和uniform变量设置等功能。
  * 支持类型安全的uniform设置，并实现uniform位置的缓存优化。
+ * 同时记录每个uniform最近一次上传的值（GL 中 uniform 属于程序对象，跨绑定保持），
+ * 值按位相同时跳过上传。uniform 只应通过本类设置，设置前需先 Use()。
  */
 class Shader {
 public:
@@ -68,8 +72,15 @@ public:
     }
 
 private:
+    /// 一个uniform的位置与最近上传的值（按 32 位字保存，最多一个 mat4）
+    struct Uniform {
+        GLint location = -1;
+        uint8_t words = 0;  // 0 表示尚未上传
+        std::array<uint32_t, 16> value{};
+    };
+
     GLuint ID{0};  // 着色器程序ID
-    mutable std::unordered_map<std::string, GLint> uniformCache;  // uniform位置缓存
+    mutable std::unordered_map<std::string, Uniform> uniformCache;  // uniform位置与值缓存
 
     /**
      * @brief 设置bool类型的uniform变量
@@ -97,11 +108,16 @@ private:
     void SetMat4(const std::string& name, const glm::mat4& value) const;
     
     /**
-     * @brief 获取uniform变量的位置
+     * @brief 获取uniform变量的缓存项，首次访问时查询位置
      * @param name uniform变量的名称
-     * @return uniform变量的位置
      */
-    GLint GetLocation(const std::string& name) const;
+    Uniform& GetUniform(const std::string& name) const;
+
+    /**
+     * @brief 与上次上传的值比较并记录新值
+     * @return 需要发出 glUniform 调用时返回 true
+     */
+    static bool UpdateValue(Uniform& uniform, const void* data, size_t words);
 
     /**
      * @brief 检查着色器编译错误
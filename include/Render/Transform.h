@@ -8,6 +8,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <vector>
+#include <cstdint>
 #include <algorithm> // 用于 std::remove
 
 /**
@@ -75,6 +76,7 @@ public:
      * 会递归标记所有子节点的变换状态为脏。
      */
     void MarkDirty() {
+        version = ++versionCounter;
         if (!dirty) {
             dirty = true;
             for (auto& child : children) {
@@ -83,6 +85,17 @@ public:
         }
     }
 
+    /**
+     * @brief 全局变换的版本号：自身或任一祖先调用 MarkDirty 后增大
+     *
+     * 只比较是否相等即可判断全局矩阵是否可能变化（如空间索引决定是否更新包围盒）。
+     */
+    uint64_t GetGlobalVersion() const {
+        uint64_t result = version;
+        for (const Transform* node = parent; node; node = node->parent) result = std::max(result, node->version);
+        return result;
+    }
+
     /**
      * @brief 添加子节点
      * @param child 要添加的子节点
@@ -115,6 +128,8 @@ public:
 
 private:
     mutable bool dirty = true;
+    inline static uint64_t versionCounter = 0;  // 全局递增，版本号不会在不同变换之间重复
+    uint64_t version = ++versionCounter;
     mutable glm::mat4 cachedMatrix = glm::mat4(1.0f); // 显式初始化
     std::vector<Transform*> children;
 };
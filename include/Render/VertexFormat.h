@@ -0,0 +1,61 @@
+﻿// VertexFormat.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Vertex.h"
+
+/**
+ * @brief 顶点在 GPU 缓冲中的存储格式
+ *
+ * CPU 侧始终保存 Vertex（float），格式只决定上传时的编码与顶点属性配置；
+ * 简化、法线计算等 CPU 处理不受影响。
+ */
+enum class VertexFormat : uint8_t {
+    Float32,    ///< Vertex 原样上传：float 位置/法线/UV，32 字节
+    Quantized,  ///< QuantizedVertex：16 位位置 + 八面体法线 + 半精度 UV，16 字节
+};
+
+/**
+ * @struct QuantizedVertex
+ * @brief 量化顶点布局
+ *
+ * 位置相对网格包围盒归一化为 unorm16，着色器中按 uPositionOffset + uPositionScale * p 还原；
+ * 法线按八面体映射编码为两个 snorm16；UV 为半精度浮点。各属性 4 字节对齐。
+ */
+struct QuantizedVertex {
+    uint16_t position[4];   ///< unorm16 xyz，w 为对齐填充
+    int16_t  normal[2];     ///< 八面体编码的 snorm16
+    uint16_t texCoords[2];  ///< 半精度浮点
+};
+static_assert(sizeof(QuantizedVertex) == 16, "QuantizedVertex 应为 16 字节");
+
+namespace VertexCodec {
+
+    /// 格式对应的每顶点字节数
+    constexpr size_t Stride(VertexFormat format) {
+        return format == VertexFormat::Quantized ? sizeof(QuantizedVertex) : sizeof(Vertex);
+    }
+
+    /// 单位向量的八面体编码，两个分量都在 [-1, 1] 内；零向量编码为 +Z
+    glm::vec2 EncodeOctahedral(const glm::vec3& n);
+    glm::vec3 DecodeOctahedral(const glm::vec2& e);
+
+    /**
+     * @brief 量化整个顶点数组
+     * @param offset   包围盒最小点，解码时的 uPositionOffset
+     * @param scale    包围盒尺寸（各分量大于 0），解码时的 uPositionScale
+     */
+    std::vector<QuantizedVertex> Quantize(std::span<const Vertex> vertices,
+                                          const glm::vec3& offset, const glm::vec3& scale);
+
+    /**
+     * @brief 计算量化用的包围盒：offset 为最小点，scale 为各轴尺寸
+     *
+     * 退化的轴（尺寸为 0）取 1，避免除零；空数组得到单位盒。
+     */
+    void ComputeQuantizationBox(std::span<const Vertex> vertices, glm::vec3& offset, glm::vec3& scale);
+
+} // namespace VertexCodec
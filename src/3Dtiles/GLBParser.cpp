@@ -4,21 +4,309 @@
 #include "Core/EndianUtils.h"
 #include "GLBParser.h"
 #include <iostream>
-#include <iostream>
 #include <stdexcept>
+#include <algorithm>
+#include <cstring>
 
 namespace Mirror
 {
     namespace GLTF
     {
 
-Mesh GLBParser::GLBData::ToMesh() const {
+Mesh GLBParser::GLBData::ToMesh() const & {
     return Mesh(
         std::vector<Vertex>(vertices), // ƥƶ캯
         std::vector<unsigned int>(indices)
     );
 }
-GLBParser::GLBData GLBParser::Parse(const std::vector<uint8_t>& glbData) {
+Mesh GLBParser::GLBData::ToMesh() && {
+    return Mesh(std::move(vertices), std::move(indices));
+}
+// ---------------------------------------------------------------------------
+//  glTF 2.0 ȡֱ GLB  BIN Ͻ accessor
+// ---------------------------------------------------------------------------
+namespace {
+    using Json = nlohmann::json;
+
+    constexpr uint32_t kChunkJSON = 0x4E4F534A;  // "JSON"
+    constexpr uint32_t kChunkBIN  = 0x004E4942;  // "BIN\0"
+
+    constexpr int kFloat         = 5126;
+    constexpr int kUnsignedByte  = 5121;
+    constexpr int kUnsignedShort = 5123;
+    constexpr int kUnsignedInt   = 5125;
+
+    uint32_t ReadU32(const uint8_t* p) {
+        return Mirror::Core::EndianUtils::ReadLittleEndian<uint32_t>(p);
+    }
+
+    size_t ComponentSize(int componentType) {
+        switch (componentType) {
+            case 5120: case kUnsignedByte:  return 1;
+            case 5122: case kUnsignedShort: return 2;
+            case kUnsignedInt: case kFloat: return 4;
+            default: throw std::runtime_error("δ֪ accessor : " + std::to_string(componentType));
+        }
+    }
+
+    size_t ComponentCount(const std::string& type) {
+        if (type == "SCALAR") return 1;
+        if (type == "VEC2")   return 2;
+        if (type == "VEC3")   return 3;
+        if (type == "VEC4")   return 4;
+        if (type == "MAT4")   return 16;
+        throw std::runtime_error("ֵ֧ accessor : " + type);
+    }
+
+    /// accessor Ԫ base + i * stride 
+    struct AccessorView {
+        const uint8_t* base = nullptr;  // Ϊձʾû bufferView淶ȫΪ 0
+        size_t count = 0;
+        size_t stride = 0;
+        int componentType = 0;
+        size_t components = 0;
+        bool normalized = false;
+    };
+
+    class LeanGLBReader {
+    public:
+        explicit LeanGLBReader(std::span<const uint8_t> glb) {
+            if (glb.size() < 20) throw std::runtime_error("GLBݹ");
+            if (std::memcmp(glb.data(), "glTF", 4) != 0) throw std::runtime_error("Ч GLB ħ");
+            const uint32_t version = ReadU32(glb.data() + 4);
+            if (version != 2) throw std::runtime_error("ֵ֧GLB汾: " + std::to_string(version));
+            const size_t length = std::min<size_t>(ReadU32(glb.data() + 8), glb.size());
+
+            // ζȡ chunkһ JSONBIN ѡ
+            size_t offset = 12;
+            std::span<const uint8_t> jsonChunk;
+            while (offset + 8 <= length) {
+                const uint32_t chunkLength = ReadU32(glb.data() + offset);
+                const uint32_t chunkType = ReadU32(glb.data() + offset + 4);
+                offset += 8;
+                if (offset + chunkLength > length) throw std::runtime_error("GLB chunk Խ");
+                const auto chunk = glb.subspan(offset, chunkLength);
+                if (chunkType == kChunkJSON && jsonChunk.empty()) jsonChunk = chunk;
+                else if (chunkType == kChunkBIN && bin.empty()) bin = chunk;
+                offset += (chunkLength + 3) & ~size_t(3);
+            }
+            if (jsonChunk.empty()) throw std::runtime_error("GLB ȱ JSON chunk");
+
+            // ֻҪĶֶΣࣨʡͼƬڽʱֱӶ
+            const Json::parser_callback_t keepNeeded = [](int depth, Json::parse_event_t event, Json& parsed) {
+                if (depth != 1 || event != Json::parse_event_t::key) return true;
+                const auto& key = parsed.get_ref<const std::string&>();
+                return key == "accessors" || key == "bufferViews" || key == "buffers"
+                    || key == "meshes" || key == "nodes";
+            };
+            const char* text = reinterpret_cast<const char*>(jsonChunk.data());
+            root = Json::parse(text, text + jsonChunk.size(), keepNeeded);
+        }
+
+        GLBParser::GLBData Read() {
+            GLBParser::GLBData result;
+            const Json& meshes = Field("meshes");
+
+            // ͳһԷ
+            size_t totalVertices = 0, totalIndices = 0;
+            for (const auto& mesh : meshes) {
+                for (const auto& primitive : mesh.value("primitives", Json::array())) {
+                    if (!IsTriangles(primitive)) continue;
+                    const size_t vertexCount = AccessorCount(primitive.at("attributes").at("POSITION").get<int>());
+                    totalVertices += vertexCount;
+                    totalIndices += primitive.contains("indices")
+                        ? AccessorCount(primitive["indices"].get<int>()) : vertexCount;
+                }
+            }
+            result.vertices.reserve(totalVertices);
+            result.indices.reserve(totalIndices);
+
+            for (const auto& mesh : meshes) {
+                for (const auto& primitive : mesh.value("primitives", Json::array())) {
+                    if (IsTriangles(primitive)) ReadPrimitive(primitive, result);
+                }
+            }
+
+            const Json& nodes = Field("nodes");
+            if (!nodes.empty() && nodes[0].contains("matrix")) {
+                const Json& matrix = nodes[0]["matrix"];
+                if (matrix.size() == 16) {
+                    float* dst = glm::value_ptr(result.transform);
+                    for (int i = 0; i < 16; ++i) dst[i] = matrix[i].get<float>();
+                }
+            }
+            return result;
+        }
+
+    private:
+        const Json& Field(const char* name) const {
+            static const Json empty = Json::array();
+            auto it = root.find(name);
+            return it != root.end() ? *it : empty;
+        }
+
+        static bool IsTriangles(const Json& primitive) {
+            return primitive.value("mode", 4) == 4;
+        }
+
+        size_t AccessorCount(int index) const {
+            return Field("accessors").at(index).at("count").get<size_t>();
+        }
+
+        AccessorView ResolveAccessor(int index) const {
+            const Json& accessor = Field("accessors").at(index);
+            if (accessor.contains("sparse")) throw std::runtime_error("֧ϡ accessor");
+
+            AccessorView view;
+            view.count = accessor.at("count").get<size_t>();
+            view.componentType = accessor.at("componentType").get<int>();
+            view.components = ComponentCount(accessor.at("type").get_ref<const std::string&>());
+            view.normalized = accessor.value("normalized", false);
+            const size_t elementSize = ComponentSize(view.componentType) * view.components;
+            view.stride = elementSize;
+            if (!accessor.contains("bufferView")) return view;
+
+            const Json& bufferView = Field("bufferViews").at(accessor["bufferView"].get<int>());
+            if (bufferView.value("buffer", 0) != 0 || Field("buffers").empty() || Field("buffers")[0].contains("uri"))
+                throw std::runtime_error("֧ GLB Ƕ BIN  bufferView");
+
+            const size_t viewOffset = bufferView.value("byteOffset", size_t(0));
+            const size_t viewLength = bufferView.at("byteLength").get<size_t>();
+            view.stride = bufferView.value("byteStride", size_t(0));
+            if (view.stride == 0) view.stride = elementSize;
+
+            const size_t accessorOffset = accessor.value("byteOffset", size_t(0));
+            const size_t required = view.count == 0 ? 0 : view.stride * (view.count - 1) + elementSize;
+            if (viewOffset + viewLength > bin.size() || accessorOffset + required > viewLength)
+                throw std::runtime_error("accessor  BIN 鷶Χ");
+
+            view.base = bin.data() + viewOffset + accessorOffset;
+            return view;
+        }
+
+        /// ȡ i Ԫصĵ c  glTF תΪ float
+        static float ReadComponent(const AccessorView& view, size_t i, size_t c) {
+            const uint8_t* p = view.base + i * view.stride;
+            switch (view.componentType) {
+                case kFloat: {
+                    float v;
+                    std::memcpy(&v, p + c * 4, 4);
+                    return v;
+                }
+                case kUnsignedByte: {
+                    const float v = p[c];
+                    return view.normalized ? v / 255.0f : v;
+                }
+                case kUnsignedShort: {
+                    uint16_t v;
+                    std::memcpy(&v, p + c * 2, 2);
+                    return view.normalized ? v / 65535.0f : float(v);
+                }
+                default:
+                    throw std::runtime_error("ֵ֧ĶԷ: " + std::to_string(view.componentType));
+            }
+        }
+
+        ///  accessor дÿ Vertex ָԱfloat  memcpy ·
+        template <size_t N>
+        static void WriteAttribute(const AccessorView& view, Vertex* dst, glm::vec<N, float> Vertex::* member) {
+            if (!view.base) return;  //  bufferView 0
+            if (view.components < N) throw std::runtime_error("Է");
+            if (view.componentType == kFloat) {
+                for (size_t i = 0; i < view.count; ++i)
+                    std::memcpy(&(dst[i].*member), view.base + i * view.stride, sizeof(float) * N);
+                return;
+            }
+            for (size_t i = 0; i < view.count; ++i) {
+                auto& out = dst[i].*member;
+                for (size_t c = 0; c < N; ++c) out[c] = ReadComponent(view, i, c);
+            }
+        }
+
+        template <typename T>
+        static void AppendIndices(const AccessorView& view, size_t vertexCount, uint32_t baseVertex,
+                                  std::vector<unsigned int>& out) {
+            const size_t first = out.size();
+            out.resize(first + view.count);
+            unsigned int* dst = out.data() + first;
+            // Խϲѭ⣬ѭ屣޷֧
+            T maxIndex = 0;
+            for (size_t i = 0; i < view.count; ++i) {
+                T v;
+                std::memcpy(&v, view.base + i * view.stride, sizeof(T));
+                maxIndex = std::max(maxIndex, v);
+                dst[i] = baseVertex + static_cast<uint32_t>(v);
+            }
+            if (view.count != 0 && maxIndex >= vertexCount)
+                throw std::runtime_error("Խ: " + std::to_string(maxIndex));
+        }
+
+        void ReadPrimitive(const Json& primitive, GLBParser::GLBData& result) const {
+            const Json& attributes = primitive.at("attributes");
+            const AccessorView positions = ResolveAccessor(attributes.at("POSITION").get<int>());
+            if (positions.componentType != kFloat || positions.components != 3)
+                throw std::runtime_error("POSITION Ϊ float VEC3");
+
+            const size_t baseVertex = result.vertices.size();
+            const size_t vertexCount = positions.count;
+            result.vertices.resize(baseVertex + vertexCount, Vertex{ glm::vec3(0.0f), glm::vec3(0.0f), glm::vec2(0.0f) });
+            Vertex* dst = result.vertices.data() + baseVertex;
+
+            WriteAttribute<3>(positions, dst, &Vertex::Position);
+
+            const bool hasNormals = attributes.contains("NORMAL");
+            if (hasNormals) {
+                const AccessorView normals = ResolveAccessor(attributes["NORMAL"].get<int>());
+                if (normals.count != vertexCount) throw std::runtime_error("NORMAL  POSITION һ");
+                WriteAttribute<3>(normals, dst, &Vertex::Normal);
+            }
+            if (attributes.contains("TEXCOORD_0")) {
+                const AccessorView uvs = ResolveAccessor(attributes["TEXCOORD_0"].get<int>());
+                if (uvs.count != vertexCount) throw std::runtime_error("TEXCOORD_0  POSITION һ");
+                WriteAttribute<2>(uvs, dst, &Vertex::TexCoords);
+            }
+
+            const size_t firstIndex = result.indices.size();
+            const auto base32 = static_cast<uint32_t>(baseVertex);
+            if (primitive.contains("indices")) {
+                const AccessorView indices = ResolveAccessor(primitive["indices"].get<int>());
+                if (!indices.base) throw std::runtime_error(" accessor ȱ bufferView");
+                switch (indices.componentType) {
+                    case kUnsignedInt:   AppendIndices<uint32_t>(indices, vertexCount, base32, result.indices); break;
+                    case kUnsignedShort: AppendIndices<uint16_t>(indices, vertexCount, base32, result.indices); break;
+                    case kUnsignedByte:  AppendIndices<uint8_t>(indices, vertexCount, base32, result.indices); break;
+                    default: throw std::runtime_error("ֵ֧");
+                }
+            } else {
+                for (size_t i = 0; i < vertexCount; ++i) result.indices.push_back(base32 + static_cast<uint32_t>(i));
+            }
+
+            // ȱٷʱ淨ۼ
+            if (!hasNormals) {
+                for (size_t i = firstIndex; i + 2 < result.indices.size(); i += 3) {
+                    Vertex& a = result.vertices[result.indices[i]];
+                    Vertex& b = result.vertices[result.indices[i + 1]];
+                    Vertex& c = result.vertices[result.indices[i + 2]];
+                    const glm::vec3 n = glm::cross(b.Position - a.Position, c.Position - a.Position);
+                    a.Normal += n; b.Normal += n; c.Normal += n;
+                }
+                for (size_t i = 0; i < vertexCount; ++i) {
+                    const float len = glm::length(dst[i].Normal);
+                    if (len > 0.0f) dst[i].Normal /= len;
+                }
+            }
+        }
+
+        Json root;
+        std::span<const uint8_t> bin;
+    };
+}
+
+GLBParser::GLBData GLBParser::Parse(std::span<const uint8_t> glbData) {
+    return LeanGLBReader(glbData).Read();
+}
+
+GLBParser::GLBData GLBParser::ParseWithTinyGLTF(std::span<const uint8_t> glbData) {
     tinygltf::Model model;
     tinygltf::TinyGLTF loader;
     std::string err, warn;
@@ -60,10 +348,11 @@ void GLBParser::ProcessModel(const tinygltf::Model& model, GLBData& result) {
             ProcessPrimitive(model, primitive, result);
         }
     }
-    if (!model.nodes.empty() && !model.nodes[0].matrix.empty()) {
-        memcpy(glm::value_ptr(result.transform), 
-             model.nodes[0].matrix.data(),
-             sizeof(float) * 16);
+    // tinygltf ľΪ doubleתܰ float ֱӿ
+    if (!model.nodes.empty() && model.nodes[0].matrix.size() == 16) {
+        float* dst = glm::value_ptr(result.transform);
+        for (int i = 0; i < 16; ++i)
+            dst[i] = static_cast<float>(model.nodes[0].matrix[i]);
     }
 }
 void GLBParser::ProcessPrimitive(const tinygltf::Model& model,
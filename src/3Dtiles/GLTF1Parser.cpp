@@ -9,7 +9,7 @@
 using namespace Mirror::GLTF;
 
 void GLTF1Parser::ValidateGLBHeader(const GLBHeader& header,
-                                     const std::vector<uint8_t>& data,
+                                     std::span<const uint8_t> data,
                                      size_t baseOffset)
 {
     if (std::memcmp(header.magic, "glTF", 4) != 0)
@@ -22,7 +22,7 @@ void GLTF1Parser::ValidateGLBHeader(const GLBHeader& header,
         throw std::runtime_error("GLB length mismatch");
 }
 
-GLTF1Parser::MeshData GLTF1Parser::ParseImpl(const std::vector<uint8_t>& data) {
+GLTF1Parser::MeshData GLTF1Parser::ParseImpl(std::span<const uint8_t> data) {
     size_t offset = 0;
     if (data.size() < sizeof(GLBHeader))
         throw std::runtime_error("Data too small for GLB header");
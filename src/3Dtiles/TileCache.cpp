@@ -0,0 +1,82 @@
+// TileCache.cpp
+#include "TileCache.h"
+
+void TileCache::Insert(const TileNode& tile, std::shared_ptr<Entity> entity) {
+    auto it = entries.find(&tile);
+    if (it != entries.end()) {
+        Entry& old = *it->second;
+        stats.cpuBytes -= old.cpuBytes;
+        stats.gpuBytes -= old.gpuBytes;
+        lru.erase(it->second);
+        entries.erase(it);
+    }
+
+    lru.push_front({ &tile, std::move(entity), 0, 0, frame });
+    entries[&tile] = lru.begin();
+    Measure(lru.front());
+}
+
+std::shared_ptr<Entity> TileCache::Touch(const TileNode& tile) {
+    auto it = entries.find(&tile);
+    if (it == entries.end()) return nullptr;  // δڷʱ RecordMisses 
+
+    ++stats.hits;
+    Entry& entry = *it->second;
+    entry.lastUsedFrame = frame;
+    lru.splice(lru.begin(), lru, it->second);
+    // ܱ LOD ޸Ĺ˳ˢռ
+    Measure(entry);
+    return entry.entity;
+}
+
+void TileCache::Measure(Entry& entry) {
+    stats.cpuBytes -= entry.cpuBytes;
+    stats.gpuBytes -= entry.gpuBytes;
+    const Mesh* mesh = entry.entity ? entry.entity->mesh.get() : nullptr;
+    entry.cpuBytes = mesh ? mesh->GetCPUMemoryBytes() : 0;
+    entry.gpuBytes = mesh ? mesh->GetGPUMemoryBytes() : 0;
+    stats.cpuBytes += entry.cpuBytes;
+    stats.gpuBytes += entry.gpuBytes;
+}
+
+void TileCache::Trim() {
+    // GPUδʹõһжأʹùƬֹͣ£
+    for (auto it = lru.end(); stats.gpuBytes > options.gpuBudgetBytes && it != lru.begin();) {
+        --it;
+        if (!IsIdle(*it)) break;
+        stats.cpuBytes -= it->cpuBytes;
+        stats.gpuBytes -= it->gpuBytes;
+        entries.erase(it->tile);
+        it = lru.erase(it);
+        ++stats.gpuEvictions;
+    }
+
+    // CPUȾֻҪ GPU 壬˽ʹõƬҲͷ CPU 
+    //  LOD ʵڱ༭Ҫ
+    for (auto it = lru.rbegin(); stats.cpuBytes > options.cpuBudgetBytes && it != lru.rend(); ++it) {
+        if (!it->entity || !it->entity->mesh || !it->entity->mesh->HasCPUData() || it->entity->lodController) continue;
+        it->entity->mesh->ReleaseCPUData();
+        Measure(*it);
+        ++stats.cpuEvictions;
+    }
+    // ԳԤʱʰȡҲҪͷţ˻Ϊ DiscardӦƬٲʰȡڵ޳
+    for (auto it = lru.rbegin(); stats.cpuBytes > options.cpuBudgetBytes && it != lru.rend(); ++it) {
+        if (it->cpuBytes == 0 || it->entity->lodController) continue;
+        it->entity->mesh->SetResidency(Mesh::Residency::Discard);
+        Measure(*it);
+        ++stats.cpuEvictions;
+    }
+
+    stats.residentTiles = lru.size();
+    stats.cpuResidentTiles = 0;
+    for (const auto& entry : lru) {
+        if (entry.cpuBytes != 0) ++stats.cpuResidentTiles;
+    }
+}
+
+void TileCache::Clear() {
+    lru.clear();
+    entries.clear();
+    stats.residentTiles = stats.cpuResidentTiles = 0;
+    stats.cpuBytes = stats.gpuBytes = 0;
+}
@@ -0,0 +1,200 @@
+// TileContentLoader.cpp
+#include "TileContentLoader.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+TileContentLoader::TileContentLoader(const Options& opts)
+    : options(opts)
+{
+    unsigned count = options.workerCount;
+    if (count == 0) {
+        const unsigned hw = std::thread::hardware_concurrency();
+        count = hw > 1 ? hw - 1 : 1;  // һĸȾ߳
+    }
+    options.maxCompletedResults = std::max<size_t>(options.maxCompletedResults, 1);
+    meshOptions = std::make_shared<const Options>(options);
+
+    workers.reserve(count);
+    for (unsigned i = 0; i < count; ++i)
+        workers.emplace_back(&TileContentLoader::WorkerLoop, this);
+}
+
+TileContentLoader::~TileContentLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        jobs.clear();
+    }
+    jobAvailable.notify_all();
+    resultSpace.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+bool TileContentLoader::Request(const TileNode& tile, double priority) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) return false;
+        if (!pending.insert(&tile).second) {
+            auto it = std::find_if(jobs.begin(), jobs.end(), [&](const Job& job) { return job.tile == &tile; });
+            if (it != jobs.end()) it->priority = priority;
+            return false;
+        }
+        jobs.push_back({ &tile, tile.path, priority, tile.external == TileNode::ExternalState::Unexpanded });
+    }
+    jobAvailable.notify_one();
+    return true;
+}
+
+size_t TileContentLoader::CancelQueued(const std::function<bool(const TileNode&)>& shouldCancel) {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t cancelled = 0;
+    auto it = std::remove_if(jobs.begin(), jobs.end(), [&](const Job& job) {
+        if (!shouldCancel(*job.tile)) return false;
+        pending.erase(job.tile);
+        ++cancelled;
+        return true;
+    });
+    jobs.erase(it, jobs.end());
+    return cancelled;
+}
+
+bool TileContentLoader::PreemptQueued(double priority) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto worst = std::max_element(jobs.begin(), jobs.end(),
+        [](const Job& a, const Job& b) { return a.priority < b.priority; });
+    if (worst == jobs.end() || worst->priority <= priority) return false;
+    pending.erase(worst->tile);
+    jobs.erase(worst);
+    return true;
+}
+
+bool TileContentLoader::IsPending(const TileNode& tile) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending.count(&tile) != 0;
+}
+
+bool TileContentLoader::IsQueued(const TileNode& tile) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::any_of(jobs.begin(), jobs.end(), [&](const Job& job) { return job.tile == &tile; });
+}
+
+size_t TileContentLoader::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending.size();
+}
+
+size_t TileContentLoader::GetQueuedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return jobs.size();
+}
+
+size_t TileContentLoader::GetCompletedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return completed.size();
+}
+
+void TileContentLoader::WorkerLoop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) return;
+            // ȡȼߵ񣻶гܵƣԲҼ
+            auto best = std::min_element(jobs.begin(), jobs.end(),
+                [](const Job& a, const Job& b) { return a.priority < b.priority; });
+            job = std::move(*best);
+            jobs.erase(best);
+        }
+
+        // ļȡ
+        Result result;
+        result.tile = job.tile;
+        result.path = job.path;
+        try {
+            if (job.external) result.subtree = TilesetParser::LoadExternal(*job.tile, options.tileset);
+            else PrepareMesh(job.path, options, result);
+        } catch (const std::exception& e) {
+            result.error = e.what();
+            if (result.error.empty()) result.error = "unknown error";
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        resultSpace.wait(lock, [this] { return stopping || completed.size() < options.maxCompletedResults; });
+        if (stopping) return;
+        completed.push_back(std::move(result));
+    }
+}
+
+void TileContentLoader::PrepareMesh(const std::string& path, const Options& options, Result& result) {
+    result.data = B3DMLoader::Decode(path);
+    if (options.optimizeMeshes)
+        MeshOptimizer::Optimize(result.data.vertices, result.data.indices, options.meshOptimizer);
+    // ֻԭʼ LOD ׷Ӹ֮ǰ
+    if (options.buildMeshlets)
+        result.meshlets = MeshletBuilder::Build(result.data.vertices, result.data.indices, options.meshlets);
+    result.lods = LODChainBuilder::Build(result.data.vertices, result.data.indices, options.lodChain);
+}
+
+size_t TileContentLoader::ProcessCompleted(double budgetMs,
+                                           const LoadedCallback& onLoaded,
+                                           const FailedCallback& onFailed,
+                                           const ExpandedCallback& onExpanded) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    size_t processed = 0;
+
+    for (;;) {
+        // ٴһ֮ʱԤض
+        if (processed > 0) {
+            const double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if (elapsed >= budgetMs) break;
+        }
+
+        Result result;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (completed.empty()) break;
+            result = std::move(completed.front());
+            completed.pop_front();
+        }
+        resultSpace.notify_one();
+
+        if (result.error.empty() && result.subtree) {
+            if (onExpanded) onExpanded(*result.tile, std::move(result.subtree));
+        } else if (result.error.empty()) {
+            try {
+                // ڹз䲢ϴ/ GL ߳
+                auto mesh = std::make_shared<Mesh>(std::move(result.data.vertices), std::move(result.data.indices),
+                                                   options.vertexFormat);
+                if (result.lods.size() > 1) mesh->SetLODLevels(std::move(result.lods));
+                if (!result.meshlets.empty()) mesh->SetMeshlets(std::move(result.meshlets));
+                // 趼ȷԵģͬѡһ鼴ɵõϴʱһµݡ
+                // зֻ͵LOD ˳˴Ҫɣֻǽ
+                mesh->SetReloader([path = std::move(result.path), pipeline = meshOptions](
+                                      std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+                    Result restored;
+                    PrepareMesh(path, *pipeline, restored);
+                    vertices = std::move(restored.data.vertices);
+                    indices = std::move(restored.data.indices);
+                });
+                mesh->SetResidency(options.residency);
+                if (onLoaded) onLoaded(*result.tile, std::move(mesh));
+            } catch (const std::exception& e) {
+                if (onFailed) onFailed(*result.tile, e.what());
+            }
+        } else if (onFailed) {
+            onFailed(*result.tile, result.error);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.erase(result.tile);
+        }
+        ++processed;
+    }
+    return processed;
+}
@@ -0,0 +1,126 @@
+// TileNode.cpp
+#include "TileNode.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glm/gtc/constants.hpp>
+
+namespace {
+    // WGS84 
+    constexpr double kWgs84A  = 6378137.0;
+    constexpr double kWgs84E2 = 0.006694379990141316;
+
+    glm::dvec3 GeodeticToEcef(double lon, double lat, double height) {
+        const double sinLat = std::sin(lat), cosLat = std::cos(lat);
+        const double n = kWgs84A / std::sqrt(1.0 - kWgs84E2 * sinLat * sinLat);
+        return glm::dvec3((n + height) * cosLat * std::cos(lon),
+                          (n + height) * cosLat * std::sin(lon),
+                          (n * (1.0 - kWgs84E2) + height) * sinLat);
+    }
+
+    // ΧתΪ ENU ϵΧ
+    void RegionToOrientedBox(const double region[6], glm::dvec3& center, glm::dmat3& halfAxes) {
+        const double west = region[0], south = region[1], north = region[3];
+        double east = region[2];
+        if (east < west) east += 2.0 * glm::pi<double>();  // Խ 180 
+
+        const double lonC = 0.5 * (west + east);
+        const double latC = 0.5 * (south + north);
+        const double hC   = 0.5 * (region[4] + region[5]);
+        const glm::dvec3 origin = GeodeticToEcef(lonC, latC, hC);
+
+        const glm::dvec3 eastDir(-std::sin(lonC), std::cos(lonC), 0.0);
+        const glm::dvec3 northDir(-std::sin(latC) * std::cos(lonC),
+                                  -std::sin(latC) * std::sin(lonC),
+                                   std::cos(latC));
+        const glm::dvec3 upDir(std::cos(latC) * std::cos(lonC),
+                               std::cos(latC) * std::sin(lonC),
+                               std::sin(latC));
+
+        // 3x3 γ  ߶ȣ¡
+        glm::dvec3 minP(std::numeric_limits<double>::max());
+        glm::dvec3 maxP(std::numeric_limits<double>::lowest());
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                const double lon = west + (east - west) * 0.5 * i;
+                const double lat = south + (north - south) * 0.5 * j;
+                for (double h : { region[4], region[5] }) {
+                    const glm::dvec3 d = GeodeticToEcef(lon, lat, h) - origin;
+                    const glm::dvec3 local(glm::dot(d, eastDir), glm::dot(d, northDir), glm::dot(d, upDir));
+                    minP = glm::min(minP, local);
+                    maxP = glm::max(maxP, local);
+                }
+            }
+        }
+
+        const glm::dvec3 mid  = 0.5 * (minP + maxP);
+        const glm::dvec3 half = 0.5 * (maxP - minP);
+        center   = origin + eastDir * mid.x + northDir * mid.y + upDir * mid.z;
+        halfAxes = glm::dmat3(eastDir * half.x, northDir * half.y, upDir * half.z);
+    }
+
+    double MaxScale(const glm::dmat4& m) {
+        return std::max({ glm::length(glm::dvec3(m[0])),
+                          glm::length(glm::dvec3(m[1])),
+                          glm::length(glm::dvec3(m[2])) });
+    }
+}
+
+void TileNode::UpdateWorldBounds(const glm::dmat4& parentWorld) {
+    worldTransform = parentWorld * transform;
+
+    const auto& bv = boundingVolume;
+    worldBounds.valid = true;
+    switch (bv.type) {
+    case VolumeType::Box:
+        worldBounds.center   = glm::dvec3(worldTransform * glm::dvec4(glm::dvec3(bv.center), 1.0));
+        worldBounds.halfAxes = glm::dmat3(worldTransform) * bv.halfAxes;
+        break;
+    case VolumeType::Sphere: {
+        worldBounds.center = glm::dvec3(worldTransform * glm::dvec4(glm::dvec3(bv.center), 1.0));
+        const double r = bv.radius * MaxScale(worldTransform);
+        worldBounds.halfAxes = glm::dmat3(r);
+        break;
+    }
+    case VolumeType::Region:
+        // region ʼλ EPSG:4979 transform Ӱ
+        RegionToOrientedBox(bv.region, worldBounds.center, worldBounds.halfAxes);
+        break;
+    default:
+        worldBounds = {};
+        worldBounds.center = glm::dvec3(worldTransform[3]);
+        return;
+    }
+
+    const auto& a = worldBounds.halfAxes;
+    worldBounds.radius = bv.type == VolumeType::Sphere
+        ? a[0][0]
+        : std::sqrt(glm::dot(a[0], a[0]) + glm::dot(a[1], a[1]) + glm::dot(a[2], a[2]));
+}
+
+double TileNode::DistanceTo(const glm::dvec3& point) const {
+    if (!worldBounds.valid) return glm::length(point - worldBounds.center);
+    if (boundingVolume.type == VolumeType::Sphere)
+        return std::max(glm::length(point - worldBounds.center) - worldBounds.radius, 0.0);
+
+    // ΧУͶӰϣۼӳ
+    const glm::dvec3 d = point - worldBounds.center;
+    const auto& a = worldBounds.halfAxes;
+    double distSq = 0.0;
+    for (int i = 0; i < 3; ++i) {
+        const double len = glm::length(a[i]);
+        glm::dvec3 axis;
+        if (len > 0.0) {
+            axis = a[i] / len;
+        } else {
+            // ˻ΪƽĺӣĲΪ
+            const glm::dvec3 n = glm::cross(a[(i + 1) % 3], a[(i + 2) % 3]);
+            const double nLen = glm::length(n);
+            if (nLen == 0.0) continue;
+            axis = n / nLen;
+        }
+        const double excess = std::abs(glm::dot(d, axis)) - len;
+        if (excess > 0.0) distSq += excess * excess;
+    }
+    return std::sqrt(distSq);
+}
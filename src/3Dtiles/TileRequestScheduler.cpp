@@ -0,0 +1,87 @@
+// TileRequestScheduler.cpp
+#include "TileRequestScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+double TileRequestScheduler::ComputePriority(const TileSelector::Request& request,
+                                             const TileSelector::FrameState& frame,
+                                             double maxScreenSpaceError,
+                                             double maxDistance) const {
+    const TileNode& tile = *request.tile;
+
+    // ԽԽȣȡ 1 - sse / maxλڰΧڣΪ
+    double sseTerm = 0.0;
+    if (std::isfinite(request.screenSpaceError) && maxScreenSpaceError > 0.0 && std::isfinite(maxScreenSpaceError))
+        sseTerm = 1.0 - std::min(request.screenSpaceError / maxScreenSpaceError, 1.0);
+
+    const double distanceTerm = maxDistance > 0.0 ? std::min(request.distance / maxDistance, 1.0) : 0.0;
+
+    // ƬķļнǣǰΪ 0Ϊ 1
+    double centerTerm = 0.0;
+    const glm::dvec3 toTile = tile.worldBounds.center - frame.cameraPosition;
+    const double len = glm::length(toTile);
+    if (len > 0.0 && request.distance > 0.0)
+        centerTerm = 0.5 * (1.0 - glm::dot(toTile / len, frame.cameraDirection));
+
+    return options.sseWeight * sseTerm
+         + options.distanceWeight * distanceTerm
+         + options.centerWeight * centerTerm;
+}
+
+void TileRequestScheduler::Schedule(const std::vector<TileSelector::Request>& requests,
+                                    const TileSelector::FrameState& frame,
+                                    TileContentLoader& loader,
+                                    const SkipPredicate& shouldSkip) {
+    const size_t totalCancelled = stats.totalCancelled;
+    stats = Statistics{};
+    stats.totalCancelled = totalCancelled;
+
+    double maxSse = 0.0, maxDistance = 0.0;
+    for (const auto& request : requests) {
+        if (std::isfinite(request.screenSpaceError)) maxSse = std::max(maxSse, request.screenSpaceError);
+        maxDistance = std::max(maxDistance, request.distance);
+    }
+
+    candidates.clear();
+    wanted.clear();
+    for (const auto& request : requests) {
+        if (shouldSkip && shouldSkip(*request.tile)) continue;
+        if (!wanted.insert(request.tile).second) continue;
+        candidates.push_back({ request.tile, ComputePriority(request, frame, maxSse, maxDistance) });
+    }
+    stats.candidates = candidates.size();
+
+    // δʼ롢ұ֡ѲҪֱӳ
+    if (options.cancelStale) {
+        stats.cancelled = loader.CancelQueued([this](const TileNode& tile) { return wanted.count(&tile) == 0; });
+        stats.totalCancelled += stats.cancelled;
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+        [](const Candidate& a, const Candidate& b) { return a.priority < b.priority; });
+
+    size_t inFlight = loader.GetPendingCount();
+    for (const auto& candidate : candidates) {
+        if (loader.IsPending(*candidate.tile)) {
+            // ;ˢŶȼ
+            loader.Request(*candidate.tile, candidate.priority);
+            continue;
+        }
+        if (inFlight >= options.maxInFlight) {
+            // ʱռŶиҪ
+            if (!loader.PreemptQueued(candidate.priority)) {
+                ++stats.deferred;
+                continue;
+            }
+            ++stats.cancelled;
+            ++stats.totalCancelled;
+            --inFlight;
+        }
+        if (loader.Request(*candidate.tile, candidate.priority)) {
+            ++stats.submitted;
+            ++inFlight;
+        }
+    }
+    stats.inFlight = loader.GetPendingCount();
+}
@@ -0,0 +1,105 @@
+// TileSelector.cpp
+#include "TileSelector.h"
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+TileSelector::FrameState TileSelector::FrameState::Create(const glm::dmat4& view,
+                                                          const glm::dmat4& projection,
+                                                          int viewportHeight) {
+    FrameState state;
+    const glm::dmat4 cameraWorld = glm::inverse(view);
+    state.cameraPosition = glm::dvec3(cameraWorld[3]);
+    state.cameraDirection = -glm::normalize(glm::dvec3(cameraWorld[2]));
+    state.frustum = DFrustum(projection * view);
+    // projection[1][1] = 1 / tan(fovy / 2)
+    const double tanHalfFovY = 1.0 / projection[1][1];
+    state.sseDenominator = 2.0 * tanHalfFovY / std::max(viewportHeight, 1);
+    return state;
+}
+
+const std::vector<const TileNode*>& TileSelector::Select(const TileNode& root,
+                                                         const FrameState& frameState,
+                                                         const ReadyPredicate& isReady) {
+    selected.clear();
+    requests.clear();
+    stats = Statistics{};
+    frame = &frameState;
+    readyPredicate = &isReady;
+
+    Traverse(root);
+
+    stats.selected = selected.size();
+    stats.requested = requests.size();
+    frame = nullptr;
+    readyPredicate = nullptr;
+    return selected;
+}
+
+double TileSelector::ComputeScreenSpaceError(const TileNode& tile,
+                                             const FrameState& frameState,
+                                             double distance) const {
+    if (tile.geometricError <= 0.0) return 0.0;
+    // λڰΧڲʱΪ󣬱ϸ
+    if (distance <= std::numeric_limits<double>::epsilon())
+        return std::numeric_limits<double>::infinity();
+    return tile.geometricError / (distance * frameState.sseDenominator);
+}
+
+bool TileSelector::IsReady(const TileNode& tile) {
+    // ⲿ tileset ռλڵչǰΪδɵ÷չ
+    if (tile.external == TileNode::ExternalState::Unexpanded) return false;
+    if (!tile.HasRenderableContent()) return true;
+    return (*readyPredicate)(tile);
+}
+
+bool TileSelector::Traverse(const TileNode& tile) {
+    ++stats.visited;
+
+    // Χڽʱۻڵ任ȱʧʱ޳
+    const auto& bounds = tile.worldBounds;
+    if (options.frustumCulling && bounds.valid &&
+        (!frame->frustum.IntersectsSphere(bounds.center, bounds.radius) ||
+         !frame->frustum.IntersectsOrientedBox(bounds.center, bounds.halfAxes))) {
+        ++stats.culled;
+        return true;
+    }
+
+    const double distance = tile.DistanceTo(frame->cameraPosition);
+    const double sse = ComputeScreenSpaceError(tile, *frame, distance);
+
+    const bool hasContent = tile.HasRenderableContent();
+    const bool ready = IsReady(tile);
+    if (!ready) {
+        requests.push_back({ &tile, sse, distance });
+    }
+
+    // Ҷӽڵ򾫶㣺ֹͣϸ
+    // ⲿ tileset ڵûݣչĸڵ棬Ǽ
+    if (tile.children.empty() || (sse <= options.maximumScreenSpaceError && !tile.IsExternalTileset())) {
+        if (hasContent && ready) selected.push_back(&tile);
+        return ready;
+    }
+
+    // ADDڵӽڵͬʱȾ
+    if (tile.refine.additive) {
+        if (hasContent && ready) selected.push_back(&tile);
+        for (const auto& child : tile.children) {
+            if (child) Traverse(*child);
+        }
+        return ready;
+    }
+
+    // REPLACEӽڵ滻ڵ㣻ӽڵδʱ˵ڵ
+    const size_t mark = selected.size();
+    bool childrenReady = true;
+    for (const auto& child : tile.children) {
+        if (child) childrenReady = Traverse(*child) && childrenReady;
+    }
+    if (!childrenReady && hasContent && ready) {
+        selected.resize(mark);
+        selected.push_back(&tile);
+        return true;
+    }
+    return childrenReady;
+}
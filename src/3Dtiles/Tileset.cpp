@@ -0,0 +1,112 @@
+// Tileset.cpp
+#include "Tileset.h"
+#include "TilesetParser.h"
+#include "B3DMLoader.h"
+#include "Render/Material/DerivedMaterials.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <glm/gtx/matrix_decompose.hpp>
+
+namespace {
+    // 3D TilesZ ϣ glTFY ϣ(x, y, z) -> (x, z, -y)
+    const glm::dmat4 kYUpFromZUp(
+        1.0, 0.0,  0.0, 0.0,
+        0.0, 0.0, -1.0, 0.0,
+        0.0, 1.0,  0.0, 0.0,
+        0.0, 0.0,  0.0, 1.0);
+    const glm::dmat4 kZUpFromYUp = glm::inverse(kYUpFromZUp);
+}
+
+Tileset::Tileset(const std::string& tilesetPath, const Options& options)
+    : options(options), selector(options.selector), scheduler(options.scheduler), cache(options.cache)
+{
+    root = TilesetParser::BuildTileTree(tilesetPath, options.parser);
+    if (!root) throw std::runtime_error("tileset ȱ root ڵ: " + tilesetPath);
+
+    renderFromWorld = kYUpFromZUp * glm::inverse(root->worldTransform);
+    auto loaderOptions = options.loader;
+    loaderOptions.tileset = options.parser;
+    loader = std::make_unique<TileContentLoader>(loaderOptions);
+}
+
+void Tileset::Update(const glm::mat4& view, const glm::mat4& projection, int viewportHeight) {
+    if (!root) return;
+
+    // ϴһ֡ɵƬҽӽɵⲿ tilesetʹڱ֡ɲѡ
+    //  Tileset Уطֻ const ʽýڵ㣬ҽʱڴ˴޸
+    stats.uploadedThisFrame = loader->ProcessCompleted(options.uploadBudgetMs,
+        [this](const TileNode& tile, std::shared_ptr<Mesh> mesh) {
+            cache.Insert(tile, CreateEntity(tile, std::move(mesh)));
+        },
+        [this](const TileNode& tile, const std::string& error) {
+            std::cerr << "[Tileset] Ƭʧ " << tile.path << ": " << error << std::endl;
+            failed.insert(&tile);
+            if (tile.IsExternalTileset())
+                const_cast<TileNode&>(tile).external = TileNode::ExternalState::Failed;
+        },
+        [this](const TileNode& tile, std::shared_ptr<TileNode> subtree) {
+            if (TilesetParser::AttachExternal(const_cast<TileNode&>(tile), std::move(subtree), expandedFiles))
+                ++stats.expandedTilesets;
+        });
+
+    cache.GetOptions() = options.cache;
+    cache.BeginFrame();
+
+    selector.GetOptions() = options.selector;
+    const glm::dmat4 worldView = glm::dmat4(view) * renderFromWorld;
+    const auto frame = TileSelector::FrameState::Create(worldView, glm::dmat4(projection), viewportHeight);
+
+    const auto& selected = selector.Select(*root, frame,
+        [this](const TileNode& tile) { return IsContentReady(tile); });
+
+    // ȼύ󣬲뿪ҰŶ
+    scheduler.GetOptions() = options.scheduler;
+    scheduler.Schedule(selector.GetRequests(), frame, *loader,
+        [this](const TileNode& tile) { return failed.count(&tile) != 0; });
+
+    renderEntities.clear();
+    renderEntities.reserve(selected.size());
+    for (const TileNode* tile : selected) {
+        if (auto entity = cache.Touch(*tile)) renderEntities.push_back(std::move(entity));
+    }
+    // ÿδפƬֻ·ʱһδУȴڼ䲻ظ
+    cache.RecordMisses(scheduler.GetStatistics().submitted);
+
+    // ֡δѡеƬԤж
+    cache.Trim();
+
+    stats.selection = selector.GetStatistics();
+    stats.scheduling = scheduler.GetStatistics();
+    stats.cache = cache.GetStatistics();
+    stats.loadedTiles = stats.cache.residentTiles;
+    stats.pendingTiles = loader->GetPendingCount();
+    stats.failedTiles = failed.size();
+}
+
+bool Tileset::IsContentReady(const TileNode& tile) const {
+    return cache.Contains(tile);
+}
+
+std::shared_ptr<Entity> Tileset::CreateEntity(const TileNode& tile, std::shared_ptr<Mesh> mesh) const {
+    auto entity = std::make_shared<Entity>();
+    entity->name = tile.name;
+    entity->mesh = std::move(mesh);
+    auto material = std::make_shared<DefaultMaterial>();
+    material->SetColor(defaultColor);
+    entity->material = material;
+    // glTF ת Z ϣپƬ任صȾϵ
+    // ȾϵƽС԰ȫؽΪ
+    const glm::dmat4 model = renderFromWorld * tile.worldTransform * kZUpFromYUp;
+    glm::dvec3 scale, translation, skew;
+    glm::dvec4 perspective;
+    glm::dquat rotation;
+    entity->transform = std::make_shared<Transform>();
+    if (glm::decompose(model, scale, rotation, translation, skew, perspective)) {
+        entity->transform->position = glm::vec3(translation);
+        entity->transform->rotation = glm::quat(rotation);
+        entity->transform->scale = glm::vec3(scale);
+        entity->transform->MarkDirty();
+    }
+    return entity;
+}
@@ -1,154 +1,412 @@
 #include "TilesetParser.h"
+#include "Core/MappedFile.h"
 #include <iostream>
 #include <unordered_set>
 #include <functional>
+#include <algorithm>
 
 using json = nlohmann::json;
 
-std::vector<std::string> TilesetParser::GetB3DMPaths(const std::string& tilesetPath) {
-    std::ifstream file(tilesetPath);
-    if (!file) throw std::runtime_error("޷ tileset.json: " + tilesetPath);
+// ---------------------------------------------------------------------------
+// SAX ʽ¼ֱ TileNodeֻ root µƬֶΣ
+// ݣassetpropertiesextrasbatch Ϣڽʱ DOM
+// ---------------------------------------------------------------------------
+class TilesetParser::SaxBuilder : public nlohmann::json_sax<json> {
+public:
+    /// documentAsRootĵû root ʱĵƬⲿ tileset ļд
+    explicit SaxBuilder(bool documentAsRoot) : documentAsRoot(documentAsRoot) {}
 
-    json tilesetJson;
-    file >> tilesetJson;
+    std::shared_ptr<TileNode> TakeRoot() { return std::move(root ? root : documentTile); }
 
-    std::vector<std::string> results;
-    std::unordered_set<std::string> processedFiles;
-    fs::path basePath = fs::path(tilesetPath).parent_path();
+    bool null() override { return Scalar(); }
+    bool boolean(bool) override { return Scalar(); }
+    bool number_integer(number_integer_t value) override { return Number(static_cast<double>(value)); }
+    bool number_unsigned(number_unsigned_t value) override { return Number(static_cast<double>(value)); }
+    bool number_float(number_float_t value, const string_t&) override { return Number(value); }
+    bool binary(binary_t&) override { return Scalar(); }
 
-    if (tilesetJson.contains("root")) {
-        ParseNode(tilesetJson["root"], basePath, results, processedFiles);
+    bool string(string_t& value) override {
+        if (skipDepth > 0 || stack.empty()) return true;
+        Context& top = stack.back();
+        if (IsTile(top) && currentKey == "refine") {
+            ApplyRefine(value, *top.tile);
+        } else if (top.kind == Kind::Content) {
+            // uri ھɰ url
+            if (currentKey == "uri" || (currentKey == "url" && top.tile->content.uri.empty()))
+                top.tile->content.uri = value;
+        } else if (top.kind == Kind::Numbers) {
+            top.valid = false;
+        }
+        return true;
     }
 
-    return results;
-}
+    bool key(string_t& value) override {
+        if (skipDepth == 0) currentKey = value;
+        return true;
+    }
 
-void TilesetParser::ParseNode(const json& node,
-                              const fs::path& basePath,
-                              std::vector<std::string>& result,
-                              std::unordered_set<std::string>& processedFiles) {
-    // ǰڵ content
-    if (node.contains("content")) {
-        ProcessContentUrl(node["content"], basePath, result, processedFiles);
+    bool start_object(std::size_t) override {
+        if (skipDepth > 0) return ++skipDepth, true;
+        if (stack.empty()) {
+            // ĵƬֶȼǵýڵϣ root  root Ϊ׼
+            if (documentAsRoot) {
+                documentTile = std::make_shared<TileNode>();
+                documentTile->refine.refinement.clear();
+            }
+            stack.push_back({ Kind::Document, documentTile.get() });
+            return true;
+        }
+
+        Context& top = stack.back();
+        if ((top.kind == Kind::Document && currentKey == "root") || top.kind == Kind::Children) {
+            auto tile = std::make_shared<TileNode>();
+            tile->refine.refinement.clear();  // ձʾδָFinalizeTree м̳иڵ
+            TileNode* raw = tile.get();
+            if (top.kind == Kind::Children) top.tile->children.push_back(std::move(tile));
+            else root = std::move(tile);
+            stack.push_back({ Kind::Tile, raw });
+        } else if (IsTile(top) && currentKey == "boundingVolume") {
+            stack.push_back({ Kind::Volume, top.tile });
+        } else if (IsTile(top) && currentKey == "content") {
+            stack.push_back({ Kind::Content, top.tile });
+        } else {
+            skipDepth = 1;
+        }
+        currentKey.clear();
+        return true;
     }
 
-    // ݹ鴦ӽڵ
-    if (node.contains("children")) {
-        for (const auto& child : node["children"]) {
-            ParseNode(child, basePath, result, processedFiles);
+    bool end_object() override {
+        if (skipDepth > 0) return --skipDepth, true;
+        stack.pop_back();
+        currentKey.clear();
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        if (skipDepth > 0) return ++skipDepth, true;
+        if (stack.empty()) return skipDepth = 1, true;
+
+        Context& top = stack.back();
+        if (IsTile(top) && currentKey == "children") {
+            stack.push_back({ Kind::Children, top.tile });
+        } else if ((IsTile(top) && currentKey == "transform") ||
+                   (top.kind == Kind::Volume && (currentKey == "box" || currentKey == "region" || currentKey == "sphere"))) {
+            Context numbers{ Kind::Numbers, top.tile };
+            numbers.target = currentKey;
+            numbers.values.reserve(16);
+            stack.push_back(std::move(numbers));
+        } else {
+            skipDepth = 1;
         }
+        currentKey.clear();
+        return true;
     }
-}
 
-void TilesetParser::ProcessContentUrl(const json& content,
-                                      const fs::path& basePath,
-                                      std::vector<std::string>& result,
-                                      std::unordered_set<std::string>& processedFiles) {
-    std::string relativeUrl;
-    if (content.contains("uri")) {
-        relativeUrl = content["uri"].get<std::string>();
-    } else if (content.contains("url")) {
-        relativeUrl = content["url"].get<std::string>();
-    } else {
-        return;
+    bool end_array() override {
+        if (skipDepth > 0) return --skipDepth, true;
+        Context& top = stack.back();
+        if (top.kind == Kind::Numbers) {
+            if (!top.valid) {
+                std::cerr << "[TilesetParser] " << top.target << " ȫΪ" << std::endl;
+            } else if (top.target == "transform") {
+                ApplyTransform(top.values, *top.tile);
+            } else {
+                ApplyBoundingVolume(top.target, top.values, *top.tile);
+            }
+        }
+        stack.pop_back();
+        currentKey.clear();
+        return true;
     }
 
-    fs::path fullPath = (basePath / relativeUrl).lexically_normal();
+    bool parse_error(std::size_t position, const std::string& lastToken,
+                     const nlohmann::detail::exception& ex) override {
+        throw std::runtime_error("tileset.json ʧܣλ " + std::to_string(position)
+                                 + "\"" + lastToken + "\": " + ex.what());
+    }
 
-    try {
-        fullPath = fs::canonical(fullPath);
+private:
+    enum class Kind { Document, Tile, Children, Volume, Content, Numbers };
 
-        // ǷѴ
-        if (processedFiles.count(fullPath.string())) return;
-        processedFiles.insert(fullPath.string());
+    struct Context {
+        Kind kind;
+        TileNode* tile = nullptr;
+        std::string target{};          // Numberstransform / box / region / sphere
+        std::vector<double> values{};  // Numbersռֵ
+        bool valid = true;
+    };
 
-        const std::string extension = fullPath.extension().string();
+    /// ƬģdocumentAsRoot ʱĵҲƬռֶ
+    static bool IsTile(const Context& context) {
+        return context.kind == Kind::Tile || (context.kind == Kind::Document && context.tile);
+    }
+
+    bool Scalar() {
+        if (skipDepth == 0 && !stack.empty() && stack.back().kind == Kind::Numbers)
+            stack.back().valid = false;
+        return true;
+    }
 
-        if (extension == ".b3dm" || extension == ".glb") {
-            result.push_back(fullPath.string());
-            std::cout << "[Info] Found B3DM: " << fullPath << std::endl;
-        } else if (extension == ".json") {
-            // Ƕ tileset
-            std::ifstream file(fullPath);
-            if (!file.is_open()) throw std::runtime_error("޷Ƕ tileset");
+    bool Number(double value) {
+        if (skipDepth > 0 || stack.empty()) return true;
+        Context& top = stack.back();
+        if (top.kind == Kind::Numbers) top.values.push_back(value);
+        else if (IsTile(top) && currentKey == "geometricError") top.tile->geometricError = value;
+        return true;
+    }
 
-            json childData;
-            file >> childData;
+    const bool documentAsRoot;
+    std::shared_ptr<TileNode> root;
+    std::shared_ptr<TileNode> documentTile;  // documentAsRoot ʱĵıø
+    std::vector<Context> stack;
+    std::string currentKey;  // ǰļ
+    int skipDepth = 0;       // >0 ʱڱ
+};
 
-            const auto& childRoot = childData.contains("root") ? childData["root"] : childData;
-            ParseNode(childRoot, fullPath.parent_path(), result, processedFiles);
+std::vector<std::string> TilesetParser::GetB3DMPaths(const std::string& tilesetPath) {
+    // ȫչⲿ tileset ռ·
+    Options options;
+    options.lazyExternal = false;
+    auto root = BuildTileTree(tilesetPath, options);
+
+    std::vector<std::string> results;
+    std::unordered_set<std::string> processedFiles;
+    std::function<void(const TileNode&)> collect = [&](const TileNode& tile) {
+        if (tile.HasRenderableContent()) {
+            std::error_code ec;
+            fs::path fullPath = fs::canonical(tile.path, ec);
+            if (ec) {
+                std::cerr << "[TilesetParser] Error processing " << tile.path << ": " << ec.message() << std::endl;
+            } else if (processedFiles.insert(fullPath.string()).second) {
+                results.push_back(fullPath.string());
+                std::cout << "[Info] Found B3DM: " << fullPath << std::endl;
+            }
+        }
+        for (const auto& child : tile.children) {
+            if (child) collect(*child);
         }
+    };
+    if (root) collect(*root);
+
+    return results;
+}
+
+std::shared_ptr<TileNode> TilesetParser::BuildTileTree(const std::string& rootTilesetPath, const Options& options) {
+    const fs::path path(rootTilesetPath);
+    auto root = ParseTilesetFile(path, options.streaming);
+    if (!root) return nullptr;
+
+    FinalizeTree(*root, path.parent_path(), nullptr);
+    if (!options.lazyExternal) {
+        std::unordered_set<std::string> expandedFiles;
+        ExpandAll(*root, options, expandedFiles);
+    }
+    return root;
+}
+
+bool TilesetParser::ExpandExternal(TileNode& tile, const Options& options,
+                                   std::unordered_set<std::string>& expandedFiles) {
+    if (tile.external != TileNode::ExternalState::Unexpanded) return tile.external == TileNode::ExternalState::Expanded;
+
+    try {
+        return AttachExternal(tile, LoadExternal(tile, options), expandedFiles);
     } catch (const std::exception& e) {
-        std::cerr << "[TilesetParser] Error processing " << fullPath << ": " << e.what() << std::endl;
+        std::cerr << "[Error] Failed to parse nested tileset: " << tile.path << ": " << e.what() << std::endl;
+        tile.external = TileNode::ExternalState::Failed;
+        return false;
     }
 }
 
-std::shared_ptr<TileNode> TilesetParser::BuildTileTree(const std::string& rootTilesetPath) {
-    std::ifstream file(rootTilesetPath);
-    if (!file) throw std::runtime_error("޷ tileset.json: " + rootTilesetPath);
+std::shared_ptr<TileNode> TilesetParser::LoadExternal(const TileNode& tile, const Options& options) {
+    const fs::path path(tile.path);
+    auto childRoot = ParseTilesetFile(path, options.streaming, true);
+    if (!childRoot) throw std::runtime_error("ȱ root ڵ");
+    // ֻȡ tile 任 refine FinalizeTree ٸı
+    FinalizeTree(*childRoot, path.parent_path(), &tile);
+    return childRoot;
+}
+
+bool TilesetParser::AttachExternal(TileNode& tile, std::shared_ptr<TileNode> subtree,
+                                   std::unordered_set<std::string>& expandedFiles) {
+    if (tile.external != TileNode::ExternalState::Unexpanded) return tile.external == TileNode::ExternalState::Expanded;
+
+    if (!subtree || !expandedFiles.insert(fs::path(tile.path).lexically_normal().string()).second) {
+        std::cerr << "[TilesetParser] ⲿ tileset ظãѺ: " << tile.path << std::endl;
+        tile.external = TileNode::ExternalState::Failed;
+        return false;
+    }
+    tile.children.push_back(std::move(subtree));
+    tile.external = TileNode::ExternalState::Expanded;
+    return true;
+}
+
+void TilesetParser::ExpandAll(TileNode& tile, const Options& options, std::unordered_set<std::string>& expandedFiles) {
+    ExpandExternal(tile, options, expandedFiles);
+    for (const auto& child : tile.children) {
+        if (child) ExpandAll(*child, options, expandedFiles);
+    }
+}
+
+std::shared_ptr<TileNode> TilesetParser::ParseTilesetFile(const fs::path& path, bool streaming, bool documentAsRoot) {
+    return streaming ? ParseTilesetStreaming(path, documentAsRoot) : ParseTilesetDOM(path, documentAsRoot);
+}
+
+std::shared_ptr<TileNode> TilesetParser::ParseTilesetStreaming(const fs::path& path, bool documentAsRoot) {
+    // ֱڴӳϽȲַҲ DOM
+    const Mirror::Core::MappedFile file(path.string());
+    const auto bytes = file.Bytes();
+    const char* begin = reinterpret_cast<const char*>(bytes.data());
+
+    SaxBuilder builder(documentAsRoot);
+    json::sax_parse(begin, begin + bytes.size(), &builder);
+    return builder.TakeRoot();
+}
+
+std::shared_ptr<TileNode> TilesetParser::ParseTilesetDOM(const fs::path& path, bool documentAsRoot) {
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("޷ tileset.json: " + path.string());
 
     json tilesetJson;
     file >> tilesetJson;
 
-    std::unordered_set<std::string> processedFiles;
-    fs::path basePath = fs::path(rootTilesetPath).parent_path();
-
     if (tilesetJson.contains("root")) {
-        return ParseTreeRecursive(tilesetJson["root"], basePath, processedFiles);
+        return ParseTreeRecursive(tilesetJson["root"]);
     }
-
-    return nullptr;
+    return documentAsRoot ? ParseTreeRecursive(tilesetJson) : nullptr;
 }
 
-std::shared_ptr<TileNode> TilesetParser::ParseTreeRecursive(
-    const json& node,
-    const fs::path& basePath,
-    std::unordered_set<std::string>& processedFiles
-) {
+std::shared_ptr<TileNode> TilesetParser::ParseTreeRecursive(const json& node) {
     auto tile = std::make_shared<TileNode>();
     if (node.contains("geometricError") && node["geometricError"].is_number()) {
         tile->geometricError = node["geometricError"].get<double>();
     }
 
-    std::string uri;
-    if (node.contains("content")) {
-        if (node["content"].contains("uri")) uri = node["content"]["uri"].get<std::string>();
-        else if (node["content"].contains("url")) uri = node["content"]["url"].get<std::string>();
-    }
+    if (node.contains("transform")) ParseTransform(node["transform"], *tile);
+    if (node.contains("boundingVolume")) ParseBoundingVolume(node["boundingVolume"], *tile);
 
-    fs::path fullPath = (basePath / uri).lexically_normal();
-    tile->name = uri.empty() ? "Unnamed Tile" : uri;
-    tile->path = fullPath.string();
+    tile->refine.refinement.clear();  // ձʾδָFinalizeTree м̳иڵ
+    if (node.contains("refine") && node["refine"].is_string()) {
+        ApplyRefine(node["refine"].get<std::string>(), *tile);
+    }
 
-    // Ƕ json tileset 
-    if (!uri.empty()) {
-        const std::string ext = fullPath.extension().string();
-        if (ext == ".json" && !processedFiles.count(fullPath.string())) {
-            processedFiles.insert(fullPath.string());
-
-            try {
-                std::ifstream subFile(fullPath);
-                if (subFile.is_open()) {
-                    json childJson;
-                    subFile >> childJson;
-
-                    const auto& childRoot = childJson.contains("root") ? childJson["root"] : childJson;
-                    auto childNode = ParseTreeRecursive(childRoot, fullPath.parent_path(), processedFiles);
-                    if (childNode) tile->children.push_back(childNode);
-                }
-            } catch (...) {
-                std::cerr << "[Error] Failed to parse nested tileset: " << fullPath << std::endl;
-            }
-        }
+    if (node.contains("content")) {
+        if (node["content"].contains("uri")) tile->content.uri = node["content"]["uri"].get<std::string>();
+        else if (node["content"].contains("url")) tile->content.uri = node["content"]["url"].get<std::string>();
     }
 
     // ͨӽڵ㴦
     if (node.contains("children")) {
         for (const auto& child : node["children"]) {
-            auto childNode = ParseTreeRecursive(child, basePath, processedFiles);
+            auto childNode = ParseTreeRecursive(child);
             if (childNode) tile->children.push_back(childNode);
         }
     }
 
     return tile;
 }
+
+void TilesetParser::FinalizeTree(TileNode& tile, const fs::path& basePath, const TileNode* parent) {
+    const std::string& uri = tile.content.uri;
+    fs::path fullPath = (basePath / uri).lexically_normal();
+    tile.name = uri.empty() ? "Unnamed Tile" : uri;
+    tile.path = fullPath.string();
+
+    // refine δָʱ̳иڵ
+    if (tile.refine.refinement.empty()) tile.refine.additive = parent && parent->refine.additive;
+    tile.refine.refinement = tile.refine.additive ? "ADD" : "REPLACE";
+
+    tile.UpdateWorldBounds(parent ? parent->worldTransform : glm::dmat4(1.0));
+    if (tile.boundingVolume.type == TileNode::VolumeType::Region) {
+        const auto& axes = tile.worldBounds.halfAxes;
+        tile.boundingVolume.center = tile.worldBounds.center;
+        tile.boundingVolume.halfSize = glm::dvec3(glm::length(axes[0]), glm::length(axes[1]), glm::length(axes[2]));
+    }
+
+    // Ƕ json tilesetΪռλڵ㣬չʱٽ
+    if (!uri.empty()) {
+        std::string ext = fullPath.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if (ext == ".json") tile.external = TileNode::ExternalState::Unexpanded;
+    }
+
+    for (const auto& child : tile.children) {
+        if (child) FinalizeTree(*child, basePath, &tile);
+    }
+}
+
+void TilesetParser::ParseTransform(const json& transform, TileNode& tile) {
+    std::vector<double> values;
+    if (transform.is_array()) {
+        for (const auto& v : transform) {
+            if (!v.is_number()) { values.clear(); break; }
+            values.push_back(v.get<double>());
+        }
+    }
+    ApplyTransform(values, tile);
+}
+
+void TilesetParser::ParseBoundingVolume(const json& volume, TileNode& tile) {
+    for (const char* key : { "box", "region", "sphere" }) {
+        if (!volume.contains(key) || !volume[key].is_array()) continue;
+        const json& array = volume[key];
+        //  SAX ·һ£ԪصİΧ
+        if (!std::all_of(array.begin(), array.end(), [](const json& v) { return v.is_number(); })) {
+            std::cerr << "[TilesetParser] " << key << " ȫΪ" << std::endl;
+            continue;
+        }
+        std::vector<double> values;
+        values.reserve(array.size());
+        for (const auto& v : array) values.push_back(v.get<double>());
+        ApplyBoundingVolume(key, values, tile);
+    }
+}
+
+void TilesetParser::ApplyTransform(const std::vector<double>& values, TileNode& tile) {
+    if (values.size() != 16) {
+        std::cerr << "[TilesetParser] transform Ϊ 16 " << std::endl;
+        return;
+    }
+    // 3D Tiles  glm Ϊ򣬿Ԫؿ
+    for (int i = 0; i < 16; ++i)
+        tile.transform[i / 4][i % 4] = values[i];
+}
+
+void TilesetParser::ApplyBoundingVolume(const std::string& key, const std::vector<double>& values, TileNode& tile) {
+    using Type = TileNode::VolumeType;
+    auto& bv = tile.boundingVolume;
+    // ͬʱְΧʱ box > region > sphere ȡãȺ˳޹
+    auto rank = [](Type type) { return type == Type::Box ? 3 : type == Type::Region ? 2 : type == Type::Sphere ? 1 : 0; };
+    const Type type = key == "box" ? Type::Box : key == "region" ? Type::Region : Type::Sphere;
+    if (rank(bv.type) >= rank(type)) return;
+
+    const size_t expected = type == Type::Box ? 12 : type == Type::Region ? 6 : 4;
+    if (values.size() != expected) {
+        std::cerr << "[TilesetParser] boundingVolume." << key << " ȴ" << std::endl;
+        return;
+    }
+
+    const double* v = values.data();
+    bv.type = type;
+    if (type == Type::Box) {
+        bv.center = glm::dvec3(v[0], v[1], v[2]);
+        bv.halfAxes = glm::dmat3(glm::dvec3(v[3], v[4], v[5]),
+                                 glm::dvec3(v[6], v[7], v[8]),
+                                 glm::dvec3(v[9], v[10], v[11]));
+        bv.halfSize = glm::dvec3(glm::length(bv.halfAxes[0]),
+                                 glm::length(bv.halfAxes[1]),
+                                 glm::length(bv.halfAxes[2]));
+    } else if (type == Type::Region) {
+        std::copy(v, v + 6, bv.region);
+    } else {
+        bv.center = glm::dvec3(v[0], v[1], v[2]);
+        bv.radius = v[3];
+        bv.halfSize = glm::dvec3(bv.radius);
+    }
+}
+
+void TilesetParser::ApplyRefine(std::string refine, TileNode& tile) {
+    std::transform(refine.begin(), refine.end(), refine.begin(), ::toupper);
+    tile.refine.additive = (refine == "ADD");
+    tile.refine.refinement = refine;
+}
@@ -0,0 +1,138 @@
+// MappedFile.cpp
+#include "Core/MappedFile.h"
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+    #include <filesystem>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Mirror {
+namespace Core {
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(const std::string& filePath)
+    : path(filePath)
+{
+    //  filesystem::path תΪַ·ϵͳҳ
+    const std::wstring widePath = std::filesystem::path(filePath).wstring();
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("޷ļ: " + filePath);
+    fileHandle = file;
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize)) {
+        Close();
+        throw std::runtime_error("޷ȡļС: " + filePath);
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+    if (size == 0) return;  // ļ޷ӳ䣬ֿ span
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        Close();
+        throw std::runtime_error("޷ļӳ: " + filePath);
+    }
+    mappingHandle = mapping;
+
+    data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data) {
+        Close();
+        throw std::runtime_error("޷ӳļͼ: " + filePath);
+    }
+}
+
+void MappedFile::Close() noexcept {
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle(static_cast<HANDLE>(mappingHandle));
+    if (fileHandle) CloseHandle(static_cast<HANDLE>(fileHandle));
+    data = nullptr;
+    size = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filePath)
+    : path(filePath)
+{
+    const int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("޷ļ: " + filePath);
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("޷ȡļС: " + filePath);
+    }
+    size = static_cast<size_t>(st.st_size);
+    if (size == 0) {  // ļ޷ӳ䣬ֿ span
+        ::close(fd);
+        return;
+    }
+
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // ӳ佨ļɹر
+    if (mapped == MAP_FAILED) {
+        size = 0;
+        throw std::runtime_error("޷ӳļ: " + filePath);
+    }
+    ::madvise(mapped, size, MADV_SEQUENTIAL);
+    data = static_cast<const uint8_t*>(mapped);
+}
+
+void MappedFile::Close() noexcept {
+    if (data) ::munmap(const_cast<uint8_t*>(data), size);
+    data = nullptr;
+    size = 0;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : path(std::move(other.path)),
+      data(std::exchange(other.data, nullptr)),
+      size(std::exchange(other.size, 0))
+#if defined(_WIN32)
+    , fileHandle(std::exchange(other.fileHandle, nullptr)),
+      mappingHandle(std::exchange(other.mappingHandle, nullptr))
+#endif
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        path = std::move(other.path);
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+#if defined(_WIN32)
+        fileHandle = std::exchange(other.fileHandle, nullptr);
+        mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#endif
+    }
+    return *this;
+}
+
+} // namespace Core
+} // namespace Mirror
@@ -0,0 +1,123 @@
+// RangeAllocator.cpp
+#include "Core/RangeAllocator.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace Mirror {
+namespace Core {
+
+    namespace {
+        size_t AlignUp(size_t value, size_t alignment) {
+            return alignment <= 1 ? value : (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    RangeAllocator::RangeAllocator(size_t initialCapacity) {
+        Grow(initialCapacity);
+    }
+
+    size_t RangeAllocator::Allocate(size_t size, size_t alignment) {
+        if (size == 0) return InvalidOffset;
+        //  size С鿪ʼң alignment - 1ͨһѡ
+        for (auto it = bySize.lower_bound({ size, 0 }); it != bySize.end(); ++it) {
+            const auto [blockSize, blockOffset] = *it;
+            const size_t offset = AlignUp(blockOffset, alignment);
+            const size_t padding = offset - blockOffset;
+            if (padding + size > blockSize) continue;
+
+            EraseFree(byOffset.find(blockOffset));
+            if (padding > 0) InsertFree(blockOffset, padding);
+            if (padding + size < blockSize) InsertFree(offset + size, blockSize - padding - size);
+            allocations.emplace(offset, size);
+            used += size;
+            return offset;
+        }
+        return InvalidOffset;
+    }
+
+    void RangeAllocator::Free(size_t offset) {
+        const auto found = allocations.find(offset);
+        if (found == allocations.end())
+            throw std::out_of_range("RangeAllocator: ͷЧƫ");
+        size_t size = found->second;
+        allocations.erase(found);
+        used -= size;
+
+        // ǰڵĿпϲ
+        auto next = byOffset.lower_bound(offset);
+        if (next != byOffset.begin()) {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == offset) {
+                offset = prev->first;
+                size += prev->second;
+                EraseFree(prev);
+            }
+        }
+        if (next != byOffset.end() && offset + size == next->first) {
+            size += next->second;
+            EraseFree(next);
+        }
+        InsertFree(offset, size);
+    }
+
+    void RangeAllocator::Grow(size_t newCapacity) {
+        if (newCapacity <= capacity) return;
+        size_t offset = capacity;
+        size_t size = newCapacity - capacity;
+        // ĩβĿпϲ
+        if (!byOffset.empty()) {
+            auto last = std::prev(byOffset.end());
+            if (last->first + last->second == capacity) {
+                offset = last->first;
+                size += last->second;
+                EraseFree(last);
+            }
+        }
+        InsertFree(offset, size);
+        capacity = newCapacity;
+    }
+
+    std::vector<RangeAllocator::Move> RangeAllocator::Compact(size_t alignment) {
+        std::vector<std::pair<size_t, size_t>> live(allocations.begin(), allocations.end());
+        std::sort(live.begin(), live.end());
+
+        std::vector<Move> moves;
+        allocations.clear();
+        byOffset.clear();
+        bySize.clear();
+        size_t cursor = 0;
+        for (const auto& [offset, size] : live) {
+            const size_t target = AlignUp(cursor, alignment);
+            if (target > cursor) InsertFree(cursor, target - cursor);  // 
+            if (target != offset) moves.push_back({ offset, target, size });
+            allocations.emplace(target, size);
+            cursor = target + size;
+        }
+        if (cursor < capacity) InsertFree(cursor, capacity - cursor);
+        return moves;
+    }
+
+    size_t RangeAllocator::UsedExtent() const noexcept {
+        if (byOffset.empty()) return capacity;
+        const auto& [offset, size] = *byOffset.rbegin();
+        return offset + size == capacity ? offset : capacity;
+    }
+
+    float RangeAllocator::Fragmentation() const noexcept {
+        const size_t freeSize = FreeSize();
+        if (freeSize == 0) return 0.0f;
+        return 1.0f - static_cast<float>(LargestFreeBlock()) / static_cast<float>(freeSize);
+    }
+
+    void RangeAllocator::InsertFree(size_t offset, size_t size) {
+        byOffset.emplace(offset, size);
+        bySize.emplace(size, offset);
+    }
+
+    void RangeAllocator::EraseFree(std::map<size_t, size_t>::iterator it) {
+        bySize.erase({ it->second, it->first });
+        byOffset.erase(it);
+    }
+
+} // namespace Core
+} // namespace Mirror
@@ -0,0 +1,109 @@
+// ThreadPool.cpp
+#include "Core/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace Mirror {
+namespace Core {
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) {
+        const unsigned hw = std::thread::hardware_concurrency();
+        threadCount = hw > 1 ? hw - 1 : 1;
+    }
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        jobs.clear();
+    }
+    jobAvailable.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::Shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::Enqueue(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    jobAvailable.notify_one();
+}
+
+void ThreadPool::WorkerLoop() {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+    // ÿ߳Լ 4 飬˸ؾȿ
+    const size_t maxChunks = (workers.size() + 1) * 4;
+    const size_t chunkSize = std::max(grain, (count + maxChunks - 1) / maxChunks);
+    const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+    if (chunkCount < 2) {
+        body(0, count);
+        return;
+    }
+
+    // ߳̿ ParallelFor غȡ񣬹״̬ǹͬ
+    struct State {
+        std::atomic<size_t> next{ 0 };
+        std::mutex mutex;
+        std::condition_variable finished;
+        size_t completed = 0;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+
+    // ȡִп飬ֱûʣࣻغٷ body
+    auto run = [state, &body, count, chunkSize, chunkCount]() {
+        for (;;) {
+            const size_t chunk = state->next.fetch_add(1);
+            if (chunk >= chunkCount) return;
+            const size_t begin = chunk * chunkSize;
+            std::exception_ptr error;
+            try {
+                body(begin, std::min(count, begin + chunkSize));
+            } catch (...) {
+                error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (error && !state->error) state->error = error;
+            if (++state->completed == chunkCount) state->finished.notify_all();
+        }
+    };
+
+    const size_t helpers = std::min(workers.size(), chunkCount - 1);
+    for (size_t i = 0; i < helpers; ++i) Enqueue(run);
+    run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&] { return state->completed == chunkCount; });
+    if (state->error) std::rethrow_exception(state->error);
+}
+
+} // namespace Core
+} // namespace Mirror
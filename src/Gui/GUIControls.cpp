@@ -1,5 +1,8 @@
 // GUIControls.cpp
 #include "GUIControls.h"
+#include "Core/ThreadPool.h"
+#include "Render/MeshOptimizer.h"
+#include "Render/MeshletBuilder.h"
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/euler_angles.hpp>
@@ -15,18 +18,24 @@ void GUIControls::SetTargetEntity(const std::shared_ptr<Entity>& entity) {
             modelRotation = glm::degrees(glm::eulerAngles(entity->transform->rotation));
             modelScale = entity->transform->scale;
         }
+        // Ƭʵ LOD 贴ʱƬԤ㣻
+        // CPU ͷŵܴԴļؽſɼ򻯡ԤϽУ
+        if (!entity->lodController && entity->mesh && entity->mesh->CanRestoreCPUData()) {
+            entity->lodController = std::make_shared<ProgressiveLOD>(*entity->mesh);
+            entity->lodController->PrecomputeAsync(Mirror::Core::ThreadPool::Shared());
+        }
         lodController = entity->lodController;
         if (lodController) {
             lodParams = lodController->GetParameters();
-            lodRatio = 1.0f;
+            lodRatio = 0.0f;
         } else {
             lodParams = ProgressiveLOD::Parameters{};
-            lodRatio = 1.0f;
+            lodRatio = 0.0f;
         }
     } else {
         lodController.reset();
         lodParams = ProgressiveLOD::Parameters{};
-        lodRatio = 1.0f;
+        lodRatio = 0.0f;
     }
 }
 
@@ -86,23 +95,58 @@ void GUIControls::Render()
     ImGui::Text(U8("FPS: %.1f"), fps);
     ImGui::Separator();
 
+    // ֡Ƶ GL ãImGui ĵò״̬棬룩
+    ImGui::SeparatorText(U8("GL "));
+    const auto& gl = GLStateCache::GetStatistics();
+    ImGui::Text(U8(": %u  : %u  : %u"),
+                gl.TotalIssued(), gl.TotalSkipped(), gl.Issued(GLStateCache::Call::Draw));
+    if (ImGui::TreeNode(U8("##glcalls"))) {
+        if (ImGui::BeginTable("##GLCallTable", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+            ImGui::TableSetupColumn(U8(""));
+            ImGui::TableSetupColumn(U8(""));
+            ImGui::TableSetupColumn(U8(""));
+            ImGui::TableHeadersRow();
+            for (size_t i = 0; i < static_cast<size_t>(GLStateCache::Call::Count); ++i) {
+                const auto call = static_cast<GLStateCache::Call>(i);
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(GLStateCache::CallName(call));
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", gl.Issued(call));
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", gl.Skipped(call));
+            }
+            ImGui::EndTable();
+        }
+        ImGui::TreePop();
+    }
+    ImGui::Spacing();
+
     // 1)  & ɫ
     ImGui::SeparatorText(U8(" & ɫ"));
     if (ImGui::Button(U8(" 3D Tiles"), ImVec2(-1, 0))) {
-        fileDialog.OpenDialog("ChooseTilesetDlg", U8("ѡ񳡾ļ"), ".json");
+        fileDialog.OpenDialog("ChooseTilesetDlg", U8("ѡ񳡾ļ"), ".json,.b3dm,.glb");
     }
     if (fileDialog.Display("ChooseTilesetDlg")) {
         if (fileDialog.IsOk()) {
             std::string path = fileDialog.GetFilePathName();
             try {
-                auto modelPaths = TilesetParser::GetB3DMPaths(path);
+                auto ext = std::filesystem::path(path).extension().string();
+                std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
                 sceneManager->ClearEntities();
-                for (auto& p : modelPaths) {
-                    auto e = LoadEntityFromFile(p);
+                SetTargetEntity(nullptr);
+                tileset.reset();
+                if (ext == ".json") {
+                    // tileset ֡ѡƬ UpdateTileset а
+                    tileset = std::make_unique<Tileset>(path);
+                    tileset->SetDefaultColor(triangleColor);
+                    modelTree = tileset->GetRoot();
+                } else {
+                    auto e = LoadEntityFromFile(path);
                     if (e) sceneManager->AddEntity(e);
+                    if (auto first = sceneManager->GetFirstEntity())
+                        SetTargetEntity(first);
                 }
-                if (auto first = sceneManager->GetFirstEntity())
-                    SetTargetEntity(first);
             } catch (const std::exception& e) {
                 ImGui::OpenPopup("ش");
             }
@@ -117,6 +161,55 @@ void GUIControls::Render()
     ImGui::ColorEdit3(U8("ɫ"), glm::value_ptr(clearColor));
     ImGui::Spacing();
 
+    // Ƭ
+    if (tileset) {
+        ImGui::SeparatorText(U8("Ƭ"));
+        auto& selectorOptions = tileset->GetOptions().selector;
+        float maxSSE = static_cast<float>(selectorOptions.maximumScreenSpaceError);
+        if (ImGui::SliderFloat(U8("Ļ"), &maxSSE, 1.0f, 64.0f, "%.1f px"))
+            selectorOptions.maximumScreenSpaceError = maxSSE;
+        ImGui::Checkbox(U8("׶޳"), &selectorOptions.frustumCulling);
+        const auto& ts = tileset->GetStatistics();
+        ImGui::Text(U8(": %zu  ޳: %zu"), ts.selection.visited, ts.selection.culled);
+        ImGui::Text(U8("Ⱦ: %zu  : %zu"), ts.selection.selected, ts.selection.requested);
+        ImGui::Text(U8("Ѽ: %zu  : %zu"), ts.loadedTiles, ts.pendingTiles);
+        ImGui::Text(U8("֡ϴ: %zu  ʧ: %zu"), ts.uploadedThisFrame, ts.failedTiles);
+        ImGui::Text(U8("չⲿ tileset: %zu"), ts.expandedTilesets);
+        float budget = static_cast<float>(tileset->GetOptions().uploadBudgetMs);
+        if (ImGui::SliderFloat(U8("ϴԤ"), &budget, 0.5f, 16.0f, "%.1f ms"))
+            tileset->GetOptions().uploadBudgetMs = budget;
+        int maxInFlight = static_cast<int>(tileset->GetOptions().scheduler.maxInFlight);
+        if (ImGui::SliderInt(U8(";"), &maxInFlight, 1, 64))
+            tileset->GetOptions().scheduler.maxInFlight = static_cast<size_t>(maxInFlight);
+        ImGui::Text(U8("ύ: %zu  Ƴ: %zu  : %zu (ۼ %zu)"),
+                    ts.scheduling.submitted, ts.scheduling.deferred,
+                    ts.scheduling.cancelled, ts.scheduling.totalCancelled);
+
+        // ڴԤ㣨MB
+        auto& cacheOptions = tileset->GetOptions().cache;
+        int cpuBudgetMB = static_cast<int>(cacheOptions.cpuBudgetBytes >> 20);
+        int gpuBudgetMB = static_cast<int>(cacheOptions.gpuBudgetBytes >> 20);
+        if (ImGui::SliderInt(U8("CPU Ԥ"), &cpuBudgetMB, 0, 4096, "%d MB"))
+            cacheOptions.cpuBudgetBytes = static_cast<size_t>(cpuBudgetMB) << 20;
+        if (ImGui::SliderInt(U8("GPU Ԥ"), &gpuBudgetMB, 16, 8192, "%d MB"))
+            cacheOptions.gpuBudgetBytes = static_cast<size_t>(gpuBudgetMB) << 20;
+        const auto& cs = ts.cache;
+        ImGui::Text(U8("פ: %zu (CPU %zu)  CPU: %.1f MB  GPU: %.1f MB"),
+                    cs.residentTiles, cs.cpuResidentTiles,
+                    cs.cpuBytes / 1048576.0, cs.gpuBytes / 1048576.0);
+        ImGui::Text(U8(": %zu  δ: %zu  ж: %zu  ͷ CPU: %zu"),
+                    cs.hits, cs.misses, cs.gpuEvictions, cs.cpuEvictions);
+        // /أǰƬʽ
+        const auto as = GpuBufferArena::ForFormat(tileset->GetOptions().loader.vertexFormat).GetStatistics();
+        ImGui::Text(U8(": %zu    %.1f/%.1f MB   %.1f/%.1f MB"),
+                    as.blocks, as.vertexBytes / 1048576.0, as.vertexCapacityBytes / 1048576.0,
+                    as.indexBytes / 1048576.0, as.indexCapacityBytes / 1048576.0);
+        ImGui::Text(U8("Ƭ:  %.0f%%   %.0f%%  : %zu  : %zu"),
+                    as.vertexFragmentation * 100.0f, as.indexFragmentation * 100.0f,
+                    as.defragmentations, as.growths);
+        ImGui::Spacing();
+    }
+
     // 2) ɫ
     ImGui::SeparatorText(U8("ɫ"));
     if (auto entity = targetEntity.lock()) {
@@ -137,6 +230,7 @@ void GUIControls::Render()
     if (lodController) {
         ImGui::Text(U8(": %zu"), lodController->GetCurrentVertices());
         ImGui::Text(U8(": %.4f"), lodController->GetCurrentError());
+        if (!lodController->Poll()) ImGui::TextDisabled(U8("Ԥ..."));
         ImGui::SliderFloat(U8("򻯱"), &lodRatio, 0.0f, 1.0f, "%.2f");
         lodController->SimplifyTo(lodRatio);
         if (ImGui::Button(U8(" LOD"), ImVec2(-1,0))) {
@@ -153,8 +247,8 @@ void GUIControls::Render()
     ImGui::SeparatorText(U8("ģͱ任"));
     if (auto e = targetEntity.lock()) {
         ImGui::Text(U8(": %zu   : %zu"),
-                    e->mesh->GetVertices().size(),
-                    e->mesh->GetIndices().size()/3);
+                    e->mesh->GetVertexCount(),
+                    e->mesh->GetDrawIndexCount()/3);
         ImGui::DragFloat3(U8("λ"), glm::value_ptr(modelPosition), 0.1f);
         ImGui::DragFloat3(U8("ת"), glm::value_ptr(modelRotation), 1.0f, -180,180);
         ImGui::DragFloat3(U8(""), glm::value_ptr(modelScale),    0.1f, 0.0f,10.0f,"%.1f");
@@ -211,10 +305,17 @@ void GUIControls::Render()
         // ΧϢ
         if (ImGui::TreeNode(U8("Χ##boundingbox"))) {
             const auto& bv = modelTree->boundingVolume;
+            static const char* kVolumeTypes[] = { "none", "box", "region", "sphere" };
+            ImGui::Text(U8(": %s"), kVolumeTypes[static_cast<int>(bv.type)]);
             ImGui::Text(U8("ĵ: (%.2f, %.2f, %.2f)"),
                 bv.center.x, bv.center.y, bv.center.z);
             ImGui::Text(U8("ߴ: (%.2f, %.2f, %.2f)"),
                 bv.halfSize.x, bv.halfSize.y, bv.halfSize.z);
+            if (modelTree->worldBounds.valid) {
+                const auto& wb = modelTree->worldBounds;
+                ImGui::Text(U8(": (%.2f, %.2f, %.2f)"), wb.center.x, wb.center.y, wb.center.z);
+                ImGui::Text(U8("Χ뾶: %.2f"), wb.radius);
+            }
             ImGui::TreePop();
         }
 
@@ -331,6 +432,22 @@ void GUIControls::Render()
     ImGui::End();
 }
 
+void GUIControls::UpdateTileset(const glm::mat4& view, const glm::mat4& projection, int viewportHeight) {
+    if (!tileset || !sceneManager) return;
+
+    tileset->Update(view, projection, viewportHeight);
+
+    sceneManager->ClearEntities();
+    for (const auto& entity : tileset->GetRenderEntities())
+        sceneManager->AddEntity(entity);
+
+    // ǰѡеƬжȾбԱѡУжغ֮٣
+    // ʱѡһգͬʱͷþ LOD 
+    if (targetEntity.expired()) {
+        SetTargetEntity(sceneManager->GetFirstEntity());
+    }
+}
+
 std::shared_ptr<Entity> GUIControls::LoadEntityFromFile(const std::string& modelPath) {
     namespace fs = std::filesystem;
     if (!fs::exists(modelPath)) throw std::runtime_error(U8("ļ: ") + modelPath);
@@ -346,13 +463,13 @@ std::shared_ptr<Entity> GUIControls::LoadEntityFromFile(const std::string& model
     std::shared_ptr<Mesh> mesh;
     
     try {
-        if (ext == ".b3dm") {
-            mesh = std::make_shared<Mesh>(B3DMLoader::LoadFromFile(modelPath));
-        } else if (ext == ".glb") {
-            std::ifstream f(modelPath, std::ios::binary);
-            if (!f) throw std::runtime_error(U8("޷: ") + modelPath);
-            std::vector<uint8_t> d((std::istreambuf_iterator<char>(f)), {});
-            mesh = std::make_shared<Mesh>(Mirror::GLTF::GLBParser::Parse(d).ToMesh());
+        if (ext == ".b3dm" || ext == ".glb") {
+            // ָʽڴӳϴǰŶ˳
+            auto data = B3DMLoader::Decode(modelPath);
+            MeshOptimizer::Optimize(data.vertices, data.indices);
+            auto meshlets = MeshletBuilder::Build(data.vertices, data.indices);
+            mesh = std::make_shared<Mesh>(std::move(data).ToMesh());
+            if (!meshlets.empty()) mesh->SetMeshlets(std::move(meshlets));
         } else {
             throw std::runtime_error(U8("ֵ֧ĸʽ: ") + ext);
         }
@@ -369,7 +486,7 @@ std::shared_ptr<Entity> GUIControls::LoadEntityFromFile(const std::string& model
     entity->transform->scale = glm::vec3(1.0f);
     entity->name = modelTree->name;
     entity->lodController = std::make_shared<ProgressiveLOD>(*mesh);
-    entity->lodController->Precompute();
+    entity->lodController->PrecomputeAsync(Mirror::Core::ThreadPool::Shared());
     
     // óʼɫ
     if (auto material = std::dynamic_pointer_cast<DefaultMaterial>(entity->material)) {
@@ -123,8 +123,10 @@ int main() {
         cameraController.update(deltaTime);
 
         // === һ׶ΣȾ֡ ===
+        // һ֡ ImGui ƹ״̬棬ʹʧЧͳ
+        GLStateCache::BeginFrame();
         mainFramebuffer.Bind();
-        glEnable(GL_DEPTH_TEST); // Ȳ
+        GLStateCache::SetDepthTest(true); // Ȳ
         
         // ӿںɫ
         glViewport(0, 0, mainFramebuffer.Width(), mainFramebuffer.Height());
@@ -140,8 +142,11 @@ int main() {
             glm::radians(camera.getZoom()), 
             (float)fbWidth/(float)fbHeight, 0.1f, 100.0f);
 
+        // ѡ֡ɼƬ
+        guiControls.UpdateTileset(view, projection, mainFramebuffer.Height());
+
         // Ⱦ
-        scene.RenderScene(view, projection);
+        scene.RenderScene(view, projection, static_cast<float>(mainFramebuffer.Height()));
         
         mainFramebuffer.Unbind();
 
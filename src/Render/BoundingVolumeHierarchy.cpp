@@ -0,0 +1,491 @@
+// BoundingVolumeHierarchy.cpp
+#include "BoundingVolumeHierarchy.h"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    using AABB = BoundingVolumeHierarchy::AABB;
+
+    /// ƽ԰Χеж-1 ȫ࣬1 ȫڲ࣬0 ཻ
+    int ClassifyBox(const glm::vec4& plane, const AABB& box) {
+        const glm::vec3 n(plane);
+        const glm::vec3 positive(n.x >= 0.0f ? box.max.x : box.min.x,
+                                 n.y >= 0.0f ? box.max.y : box.min.y,
+                                 n.z >= 0.0f ? box.max.z : box.min.z);
+        if (glm::dot(n, positive) + plane.w < 0.0f) return -1;
+        const glm::vec3 negative(n.x >= 0.0f ? box.min.x : box.max.x,
+                                 n.y >= 0.0f ? box.min.y : box.max.y,
+                                 n.z >= 0.0f ? box.min.z : box.max.z);
+        return glm::dot(n, negative) + plane.w >= 0.0f ? 1 : 0;
+    }
+
+    /// ΧеĽ루slab ཻ򳬳 maxDistance ʱظ
+    float RayEnter(const glm::vec3& origin, const glm::vec3& inverseDirection, const AABB& box, float maxDistance) {
+        const glm::vec3 t0 = (box.min - origin) * inverseDirection;
+        const glm::vec3 t1 = (box.max - origin) * inverseDirection;
+        const glm::vec3 tNear = glm::min(t0, t1), tFar = glm::max(t0, t1);
+        const float enter = std::max({ tNear.x, tNear.y, tNear.z, 0.0f });
+        const float exit = std::min({ tFar.x, tFar.y, tFar.z, maxDistance });
+        return enter <= exit ? enter : -1.0f;
+    }
+}
+
+uint32_t BoundingVolumeHierarchy::AllocateNode() {
+    if (freeList == Null) {
+        nodes.emplace_back();
+        nodes.back().height = 0;
+        return static_cast<uint32_t>(nodes.size() - 1);
+    }
+    const uint32_t index = freeList;
+    freeList = nodes[index].parent;
+    nodes[index] = Node{};
+    nodes[index].height = 0;
+    return index;
+}
+
+void BoundingVolumeHierarchy::FreeNode(uint32_t index) {
+    nodes[index].parent = freeList;
+    nodes[index].height = -1;
+    freeList = index;
+}
+
+BoundingVolumeHierarchy::AABB BoundingVolumeHierarchy::Fatten(const AABB& bounds) const {
+    const glm::vec3 margin = (bounds.max - bounds.min) * options.fatMargin;
+    return { bounds.min - margin, bounds.max + margin };
+}
+
+BoundingVolumeHierarchy::ProxyId BoundingVolumeHierarchy::Insert(const AABB& bounds, uint32_t item) {
+    const uint32_t leaf = AllocateNode();
+    nodes[leaf].tight = bounds;
+    nodes[leaf].box = Fatten(bounds);
+    nodes[leaf].item = item;
+    InsertLeaf(leaf);
+    ++leafCount;
+    return leaf;
+}
+
+void BoundingVolumeHierarchy::Remove(ProxyId proxy) {
+    if (proxy >= nodes.size() || !nodes[proxy].IsLeaf() || nodes[proxy].height != 0)
+        throw std::out_of_range("Ч BVH ");
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+    --leafCount;
+}
+
+bool BoundingVolumeHierarchy::Move(ProxyId proxy, const AABB& bounds) {
+    Node& leaf = nodes[proxy];
+    leaf.tight = bounds;
+    if (leaf.box.Contains(bounds)) return false;
+
+    // ֺУժºλ²룬ȵİΧ֮ս
+    RemoveLeaf(proxy);
+    nodes[proxy].box = Fatten(bounds);
+    InsertLeaf(proxy);
+    return true;
+}
+
+void BoundingVolumeHierarchy::Clear() {
+    nodes.clear();
+    root = freeList = Null;
+    leafCount = 0;
+}
+
+void BoundingVolumeHierarchy::InsertLeaf(uint32_t leaf) {
+    if (root == Null) {
+        root = leaf;
+        nodes[leaf].parent = Null;
+        return;
+    }
+
+    // Ըѡֵܽڵ㣺Ƚ"ڴ˴Ϊֵ""µӽڵ"ı
+    const AABB leafBox = nodes[leaf].box;
+    uint32_t index = root;
+    while (!nodes[index].IsLeaf()) {
+        const Node& node = nodes[index];
+        const float area = node.box.HalfArea();
+        const float combinedArea = AABB::Union(node.box, leafBox).HalfArea();
+        const float cost = 2.0f * combinedArea;
+        const float inheritance = 2.0f * (combinedArea - area);  // ½ʱӵ
+
+        auto descendCost = [&](uint32_t child) {
+            const AABB& box = nodes[child].box;
+            const float enlarged = AABB::Union(box, leafBox).HalfArea();
+            return (nodes[child].IsLeaf() ? enlarged : enlarged - box.HalfArea()) + inheritance;
+        };
+        const float cost1 = descendCost(node.child1);
+        const float cost2 = descendCost(node.child2);
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const uint32_t sibling = index;
+    const uint32_t oldParent = nodes[sibling].parent;
+    const uint32_t newParent = AllocateNode();
+    Node& parent = nodes[newParent];
+    parent.parent = oldParent;
+    parent.box = AABB::Union(leafBox, nodes[sibling].box);
+    parent.height = nodes[sibling].height + 1;
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == Null) {
+        root = newParent;
+    } else if (nodes[oldParent].child1 == sibling) {
+        nodes[oldParent].child1 = newParent;
+    } else {
+        nodes[oldParent].child2 = newParent;
+    }
+    FixUpwards(nodes[leaf].parent);
+}
+
+void BoundingVolumeHierarchy::RemoveLeaf(uint32_t leaf) {
+    if (leaf == root) {
+        root = Null;
+        return;
+    }
+
+    const uint32_t parent = nodes[leaf].parent;
+    const uint32_t grandParent = nodes[parent].parent;
+    const uint32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    // ֵܽڵ㶥游ڵλ
+    if (grandParent == Null) {
+        root = sibling;
+        nodes[sibling].parent = Null;
+        FreeNode(parent);
+        return;
+    }
+    if (nodes[grandParent].child1 == parent) nodes[grandParent].child1 = sibling;
+    else nodes[grandParent].child2 = sibling;
+    nodes[sibling].parent = grandParent;
+    FreeNode(parent);
+    FixUpwards(grandParent);
+}
+
+void BoundingVolumeHierarchy::FixUpwards(uint32_t index) {
+    while (index != Null) {
+        index = Balance(index);
+        Node& node = nodes[index];
+        node.height = 1 + std::max(nodes[node.child1].height, nodes[node.child2].height);
+        node.box = AABB::Union(nodes[node.child1].box, nodes[node.child2].box);
+        index = node.parent;
+    }
+}
+
+uint32_t BoundingVolumeHierarchy::Balance(uint32_t iA) {
+    // ߶Ȳ 1 ʱѽϸߵӽڵת A λ
+    Node& A = nodes[iA];
+    if (A.IsLeaf() || A.height < 2) return iA;
+
+    const uint32_t iB = A.child1;
+    const uint32_t iC = A.child2;
+    Node& B = nodes[iB];
+    Node& C = nodes[iC];
+    const int balance = C.height - B.height;
+
+    auto replaceInParent = [&](uint32_t oldChild, uint32_t newChild) {
+        const uint32_t p = nodes[newChild].parent;
+        if (p == Null) root = newChild;
+        else if (nodes[p].child1 == oldChild) nodes[p].child1 = newChild;
+        else nodes[p].child2 = newChild;
+    };
+
+    if (balance > 1) {
+        const uint32_t iF = C.child1;
+        const uint32_t iG = C.child2;
+        Node& F = nodes[iF];
+        Node& G = nodes[iG];
+
+        C.child1 = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+        replaceInParent(iA, iC);
+
+        // ϸߵڵ C £ϰĽ A
+        if (F.height > G.height) {
+            C.child2 = iF;
+            A.child2 = iG;
+            G.parent = iA;
+            A.box = AABB::Union(B.box, G.box);
+            C.box = AABB::Union(A.box, F.box);
+            A.height = 1 + std::max(B.height, G.height);
+            C.height = 1 + std::max(A.height, F.height);
+        } else {
+            C.child2 = iG;
+            A.child2 = iF;
+            F.parent = iA;
+            A.box = AABB::Union(B.box, F.box);
+            C.box = AABB::Union(A.box, G.box);
+            A.height = 1 + std::max(B.height, F.height);
+            C.height = 1 + std::max(A.height, G.height);
+        }
+        return iC;
+    }
+
+    if (balance < -1) {
+        const uint32_t iD = B.child1;
+        const uint32_t iE = B.child2;
+        Node& D = nodes[iD];
+        Node& E = nodes[iE];
+
+        B.child1 = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+        replaceInParent(iA, iB);
+
+        if (D.height > E.height) {
+            B.child2 = iD;
+            A.child1 = iE;
+            E.parent = iA;
+            A.box = AABB::Union(C.box, E.box);
+            B.box = AABB::Union(A.box, D.box);
+            A.height = 1 + std::max(C.height, E.height);
+            B.height = 1 + std::max(A.height, D.height);
+        } else {
+            B.child2 = iE;
+            A.child1 = iD;
+            D.parent = iA;
+            A.box = AABB::Union(C.box, D.box);
+            B.box = AABB::Union(A.box, E.box);
+            A.height = 1 + std::max(C.height, D.height);
+            B.height = 1 + std::max(A.height, E.height);
+        }
+        return iB;
+    }
+    return iA;
+}
+
+void BoundingVolumeHierarchy::Rebuild() {
+    if (root == Null) return;
+
+    // ռҶڵ㣬ȫڲڵ
+    std::vector<BuildItem> leaves;
+    leaves.reserve(leafCount);
+    std::vector<uint32_t> stack{ root };
+    while (!stack.empty()) {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[index];
+        if (node.IsLeaf()) {
+            leaves.push_back({ node.box, (node.box.min + node.box.max) * 0.5f, index });
+            continue;
+        }
+        stack.push_back(node.child1);
+        stack.push_back(node.child2);
+        FreeNode(index);
+    }
+    root = BuildRange(leaves, 0, leaves.size());
+    nodes[root].parent = Null;
+}
+
+uint32_t BoundingVolumeHierarchy::BuildRange(std::vector<BuildItem>& leaves, size_t begin, size_t end) {
+    if (end - begin == 1) return leaves[begin].leaf;
+
+    glm::vec3 cmin(std::numeric_limits<float>::max()), cmax(std::numeric_limits<float>::lowest());
+    for (size_t i = begin; i < end; ++i) {
+        cmin = glm::min(cmin, leaves[i].centroid);
+        cmax = glm::max(cmax, leaves[i].centroid);
+    }
+
+    // ÿ䣬 SAH ۣҰΧ  ѡŷָ
+    int bestAxis = -1, bestSplit = 0;
+    float bestCost = std::numeric_limits<float>::max();
+    for (int axis = 0; axis < 3; ++axis) {
+        const float extent = cmax[axis] - cmin[axis];
+        if (extent <= 0.0f) continue;
+        const float scale = SahBins / extent;
+
+        std::array<AABB, SahBins> binBoxes;
+        std::array<size_t, SahBins> binCounts{};
+        for (size_t i = begin; i < end; ++i) {
+            const int bin = std::min(SahBins - 1, static_cast<int>((leaves[i].centroid[axis] - cmin[axis]) * scale));
+            const AABB& box = leaves[i].box;
+            binBoxes[bin] = binCounts[bin]++ ? AABB::Union(binBoxes[bin], box) : box;
+        }
+
+        // ۼҲٴɨ
+        std::array<float, SahBins> rightCost{};
+        AABB accumulated;
+        size_t count = 0;
+        for (int bin = SahBins - 1; bin > 0; --bin) {
+            if (binCounts[bin]) accumulated = count ? AABB::Union(accumulated, binBoxes[bin]) : binBoxes[bin];
+            count += binCounts[bin];
+            rightCost[bin] = count ? accumulated.HalfArea() * count : 0.0f;
+        }
+        count = 0;
+        for (int bin = 0; bin < SahBins - 1; ++bin) {
+            if (binCounts[bin]) accumulated = count ? AABB::Union(accumulated, binBoxes[bin]) : binBoxes[bin];
+            count += binCounts[bin];
+            if (count == 0 || count == end - begin) continue;
+            const float cost = accumulated.HalfArea() * count + rightCost[bin + 1];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = bin;
+            }
+        }
+    }
+
+    size_t middle;
+    if (bestAxis < 0) {
+        // ȫغϣ޷λ֣԰
+        middle = begin + (end - begin) / 2;
+    } else {
+        const float scale = SahBins / (cmax[bestAxis] - cmin[bestAxis]);
+        const auto split = std::partition(leaves.begin() + begin, leaves.begin() + end, [&](const BuildItem& item) {
+            return std::min(SahBins - 1, static_cast<int>((item.centroid[bestAxis] - cmin[bestAxis]) * scale))
+                   <= bestSplit;
+        });
+        middle = static_cast<size_t>(split - leaves.begin());
+    }
+
+    const uint32_t child1 = BuildRange(leaves, begin, middle);
+    const uint32_t child2 = BuildRange(leaves, middle, end);
+    const uint32_t index = AllocateNode();
+    Node& node = nodes[index];
+    node.child1 = child1;
+    node.child2 = child2;
+    node.box = AABB::Union(nodes[child1].box, nodes[child2].box);
+    node.height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+    nodes[child1].parent = index;
+    nodes[child2].parent = index;
+    return index;
+}
+
+void BoundingVolumeHierarchy::Cull(const Frustum& frustum, std::vector<uint32_t>& items) const {
+    items.clear();
+    if (root == Null) return;
+
+    // ¼Եƽ棺ڵȫλĳƽڲʱٲԸƽ
+    constexpr uint8_t AllPlanes = (1u << Frustum::Count) - 1;
+    std::vector<std::pair<uint32_t, uint8_t>> stack;
+    stack.reserve(64);
+    stack.emplace_back(root, AllPlanes);
+    while (!stack.empty()) {
+        auto [index, mask] = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[index];
+        const AABB& box = node.IsLeaf() ? node.tight : node.box;
+
+        bool outside = false;
+        for (int plane = 0; plane < Frustum::Count && mask; ++plane) {
+            if (!(mask & (1u << plane))) continue;
+            const int side = ClassifyBox(frustum.GetPlane(plane), box);
+            if (side < 0) {
+                outside = true;
+                break;
+            }
+            if (side > 0) mask &= static_cast<uint8_t>(~(1u << plane));
+        }
+        if (outside) continue;
+
+        if (node.IsLeaf()) {
+            items.push_back(node.item);
+        } else if (mask == 0) {
+            // ׶ڣֱռҶڵ
+            std::vector<uint32_t> subtree{ index };
+            while (!subtree.empty()) {
+                const Node& inner = nodes[subtree.back()];
+                subtree.pop_back();
+                if (inner.IsLeaf()) {
+                    items.push_back(inner.item);
+                } else {
+                    subtree.push_back(inner.child1);
+                    subtree.push_back(inner.child2);
+                }
+            }
+        } else {
+            stack.emplace_back(node.child1, mask);
+            stack.emplace_back(node.child2, mask);
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::Query(const AABB& range, std::vector<uint32_t>& items) const {
+    items.clear();
+    if (root == Null) return;
+
+    std::vector<uint32_t> stack{ root };
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+        if (!node.box.Overlaps(range)) continue;
+        if (node.IsLeaf()) {
+            if (node.tight.Overlaps(range)) items.push_back(node.item);
+        } else {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+bool BoundingVolumeHierarchy::Raycast(const glm::vec3& origin, const glm::vec3& direction, const RayCallback& callback,
+                                      uint32_t& item, float& distance) const {
+    if (root == Null) return false;
+
+    // Ϊ 0 ʱΪslab ȽȻ
+    const glm::vec3 inverseDirection = 1.0f / direction;
+    float nearest = distance;
+    bool hit = false;
+
+    std::vector<std::pair<uint32_t, float>> stack;
+    stack.reserve(64);
+    const float rootEnter = RayEnter(origin, inverseDirection, nodes[root].box, nearest);
+    if (rootEnter >= 0.0f) stack.emplace_back(root, rootEnter);
+    while (!stack.empty()) {
+        const auto [index, enter] = stack.back();
+        stack.pop_back();
+        if (enter > nearest) continue;  // ջҵ
+        const Node& node = nodes[index];
+
+        if (node.IsLeaf()) {
+            if (RayEnter(origin, inverseDirection, node.tight, nearest) < 0.0f) continue;
+            const float t = callback(node.item, nearest);
+            if (t >= 0.0f && t <= nearest) {
+                nearest = t;
+                item = node.item;
+                hit = true;
+            }
+            continue;
+        }
+
+        // Ͻӽڵջȳջ
+        const float enter1 = RayEnter(origin, inverseDirection, nodes[node.child1].box, nearest);
+        const float enter2 = RayEnter(origin, inverseDirection, nodes[node.child2].box, nearest);
+        const bool firstNearer = enter1 >= 0.0f && (enter2 < 0.0f || enter1 <= enter2);
+        const std::pair<uint32_t, float> near1(node.child1, enter1), near2(node.child2, enter2);
+        const auto& nearer = firstNearer ? near1 : near2;
+        const auto& farther = firstNearer ? near2 : near1;
+        if (farther.second >= 0.0f) stack.push_back(farther);
+        if (nearer.second >= 0.0f) stack.push_back(nearer);
+    }
+    if (hit) distance = nearest;
+    return hit;
+}
+
+BoundingVolumeHierarchy::Statistics BoundingVolumeHierarchy::GetStatistics() const {
+    Statistics stats;
+    stats.leaves = leafCount;
+    if (root == Null) return stats;
+
+    stats.height = nodes[root].height;
+    float internalArea = 0.0f;
+    std::vector<uint32_t> stack{ root };
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+        ++stats.nodes;
+        if (node.IsLeaf()) continue;
+        internalArea += node.box.HalfArea();
+        stack.push_back(node.child1);
+        stack.push_back(node.child2);
+    }
+    const float rootArea = nodes[root].box.HalfArea();
+    stats.areaRatio = rootArea > 0.0f ? internalArea / rootArea : 0.0f;
+    return stats;
+}
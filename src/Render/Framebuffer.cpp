@@ -1,5 +1,6 @@
 // Framebuffer.cpp
 #include "Framebuffer.h"
+#include "GLStateCache.h"
 #include <iostream>
 
 Framebuffer::Framebuffer(int width, int height) : width(width), height(height) {
@@ -9,7 +10,7 @@ Framebuffer::Framebuffer(int width, int height) : width(width), height(height) {
 
     // ɫ
     glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
+    GLStateCache::BindTexture(0, texture);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -32,6 +33,7 @@ Framebuffer::Framebuffer(int width, int height) : width(width), height(height) {
 
 Framebuffer::~Framebuffer() {
     glDeleteFramebuffers(1, &FBO);
+    GLStateCache::ForgetTexture(texture);
     glDeleteTextures(1, &texture);
     glDeleteRenderbuffers(1, &RBO);
 }
@@ -0,0 +1,186 @@
+// FrustumCuller.cpp
+#include "FrustumCuller.h"
+#include <algorithm>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define EMAO_CULL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define EMAO_TARGET_AVX
+#else
+#define EMAO_TARGET_AVX __attribute__((target("avx")))
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EMAO_CULL_SSE 1
+#endif
+#endif
+
+namespace {
+    /// λ˳׷
+    inline void AppendMask(unsigned mask, uint32_t base, std::vector<uint32_t>& visible) {
+        while (mask) {
+            unsigned bit = 0;
+            while (!(mask & (1u << bit))) ++bit;
+            visible.push_back(base + bit);
+            mask &= mask - 1;
+        }
+    }
+
+    void CullScalar(const float* x, const float* y, const float* z, const float* r, size_t count,
+                    const Frustum& frustum, std::vector<uint32_t>& visible) {
+        const auto& planes = frustum.GetPlanes();
+        for (size_t i = 0; i < count; ++i) {
+            bool inside = true;
+            for (const auto& p : planes) {
+                if (p.x * x[i] + p.y * y[i] + p.z * z[i] + p.w < -r[i]) {
+                    inside = false;
+                    break;
+                }
+            }
+            if (inside) visible.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+#if EMAO_CULL_SSE
+    void CullSSE(const float* x, const float* y, const float* z, const float* r, size_t paddedCount,
+                 const Frustum& frustum, std::vector<uint32_t>& visible) {
+        // ƽ㲥ͨһĳƽʱǰ
+        __m128 px[Frustum::Count], py[Frustum::Count], pz[Frustum::Count], pw[Frustum::Count];
+        for (int k = 0; k < Frustum::Count; ++k) {
+            const auto& p = frustum.GetPlane(k);
+            px[k] = _mm_set1_ps(p.x);
+            py[k] = _mm_set1_ps(p.y);
+            pz[k] = _mm_set1_ps(p.z);
+            pw[k] = _mm_set1_ps(p.w);
+        }
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        for (size_t i = 0; i < paddedCount; i += 4) {
+            const __m128 cx = _mm_loadu_ps(x + i), cy = _mm_loadu_ps(y + i), cz = _mm_loadu_ps(z + i);
+            const __m128 negR = _mm_xor_ps(_mm_loadu_ps(r + i), signMask);
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int k = 0; k < Frustum::Count; ++k) {
+                // ͬ˳򣬱֤ʵֽһ
+                const __m128 d = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px[k], cx), _mm_mul_ps(py[k], cy)),
+                                                       _mm_mul_ps(pz[k], cz)), pw[k]);
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negR));
+                if (_mm_movemask_ps(inside) == 0) break;
+            }
+            AppendMask(static_cast<unsigned>(_mm_movemask_ps(inside)), static_cast<uint32_t>(i), visible);
+        }
+    }
+#endif
+
+#if EMAO_CULL_X86
+    EMAO_TARGET_AVX
+    void CullAVX(const float* x, const float* y, const float* z, const float* r, size_t paddedCount,
+                 const Frustum& frustum, std::vector<uint32_t>& visible) {
+        __m256 px[Frustum::Count], py[Frustum::Count], pz[Frustum::Count], pw[Frustum::Count];
+        for (int k = 0; k < Frustum::Count; ++k) {
+            const auto& p = frustum.GetPlane(k);
+            px[k] = _mm256_set1_ps(p.x);
+            py[k] = _mm256_set1_ps(p.y);
+            pz[k] = _mm256_set1_ps(p.z);
+            pw[k] = _mm256_set1_ps(p.w);
+        }
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        for (size_t i = 0; i < paddedCount; i += 8) {
+            const __m256 cx = _mm256_loadu_ps(x + i), cy = _mm256_loadu_ps(y + i), cz = _mm256_loadu_ps(z + i);
+            const __m256 negR = _mm256_xor_ps(_mm256_loadu_ps(r + i), signMask);
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (int k = 0; k < Frustum::Count; ++k) {
+                const __m256 d = _mm256_add_ps(
+                    _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px[k], cx), _mm256_mul_ps(py[k], cy)),
+                                  _mm256_mul_ps(pz[k], cz)), pw[k]);
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, negR, _CMP_GE_OQ));
+                if (_mm256_movemask_ps(inside) == 0) break;
+            }
+            AppendMask(static_cast<unsigned>(_mm256_movemask_ps(inside)), static_cast<uint32_t>(i), visible);
+        }
+    }
+
+    bool CpuSupportsAVX() {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        // ϵͳ YMM Ĵ״̬
+        return osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+#else
+        return __builtin_cpu_supports("avx");
+#endif
+    }
+#endif
+}
+
+void FrustumCuller::Resize(size_t newCount) {
+    // 鳤Ȳ뵽飬ʼձֲɼ
+    const size_t padded = (newCount + Lanes - 1) / Lanes * Lanes;
+    const size_t keep = std::min(count, newCount);
+    for (auto* array : { &centerX, &centerY, &centerZ }) array->resize(padded, 0.0f);
+    radii.resize(padded, HiddenRadius);
+    std::fill(radii.begin() + keep, radii.end(), HiddenRadius);
+    count = newCount;
+}
+
+size_t FrustumCuller::Cull(const Frustum& frustum, std::vector<uint32_t>& visible, Backend backend) const {
+    visible.clear();
+    if (count == 0) return 0;
+    if (!IsSupported(backend)) backend = Backend::Scalar;
+
+    const size_t paddedCount = radii.size();
+    switch (backend) {
+#if EMAO_CULL_X86
+    case Backend::AVX:
+        CullAVX(centerX.data(), centerY.data(), centerZ.data(), radii.data(), paddedCount, frustum, visible);
+        break;
+#endif
+#if EMAO_CULL_SSE
+    case Backend::SSE:
+        CullSSE(centerX.data(), centerY.data(), centerZ.data(), radii.data(), paddedCount, frustum, visible);
+        break;
+#endif
+    default:
+        CullScalar(centerX.data(), centerY.data(), centerZ.data(), radii.data(), count, frustum, visible);
+        break;
+    }
+    return visible.size();
+}
+
+bool FrustumCuller::IsSupported(Backend backend) {
+    switch (backend) {
+    case Backend::Scalar:
+        return true;
+    case Backend::SSE:
+#if EMAO_CULL_SSE
+        return true;
+#else
+        return false;
+#endif
+    case Backend::AVX: {
+#if EMAO_CULL_X86
+        static const bool avx = CpuSupportsAVX();
+        return avx;
+#else
+        return false;
+#endif
+    }
+    }
+    return false;
+}
+
+FrustumCuller::Backend FrustumCuller::BestBackend() {
+    if (IsSupported(Backend::AVX)) return Backend::AVX;
+    if (IsSupported(Backend::SSE)) return Backend::SSE;
+    return Backend::Scalar;
+}
+
+const char* FrustumCuller::BackendName(Backend backend) {
+    switch (backend) {
+    case Backend::SSE: return "SSE";
+    case Backend::AVX: return "AVX";
+    default: return "scalar";
+    }
+}
@@ -0,0 +1,134 @@
+// GLStateCache.cpp
+#include "GLStateCache.h"
+#include <numeric>
+
+GLStateCache::State GLStateCache::state;
+GLStateCache::Statistics GLStateCache::stats;
+
+uint32_t GLStateCache::Statistics::TotalIssued() const {
+    return std::accumulate(issued.begin(), issued.end(), 0u);
+}
+
+uint32_t GLStateCache::Statistics::TotalSkipped() const {
+    return std::accumulate(skipped.begin(), skipped.end(), 0u);
+}
+
+void GLStateCache::BeginFrame() {
+    stats = Statistics{};
+    Invalidate();
+}
+
+void GLStateCache::Invalidate() {
+    state = State{};
+}
+
+void GLStateCache::UseProgram(GLuint program) {
+    const bool changed = state.program != program;
+    Record(Call::Program, changed);
+    if (!changed) return;
+    glUseProgram(program);
+    state.program = program;
+}
+
+void GLStateCache::BindVertexArray(GLuint vao) {
+    const bool changed = state.vertexArray != vao;
+    Record(Call::VertexArray, changed);
+    if (!changed) return;
+    glBindVertexArray(vao);
+    state.vertexArray = vao;
+}
+
+void GLStateCache::ActivateUnit(unsigned unit) {
+    const bool changed = state.activeUnit != unit;
+    Record(Call::ActiveTexture, changed);
+    if (!changed) return;
+    glActiveTexture(GL_TEXTURE0 + unit);
+    state.activeUnit = unit;
+}
+
+void GLStateCache::BindTexture(unsigned unit, GLuint texture) {
+    if (unit < TrackedTextureUnits && state.textures[unit] == texture) {
+        Record(Call::Texture, false);
+        return;
+    }
+    ActivateUnit(unit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    Record(Call::Texture, true);
+    if (unit < TrackedTextureUnits) state.textures[unit] = texture;
+}
+
+void GLStateCache::SetCapability(GLenum capability, int8_t& shadow, bool enabled) {
+    const bool changed = shadow != static_cast<int8_t>(enabled);
+    Record(Call::Capability, changed);
+    if (!changed) return;
+    if (enabled) glEnable(capability);
+    else glDisable(capability);
+    shadow = static_cast<int8_t>(enabled);
+}
+
+void GLStateCache::SetDepthTest(bool enabled) {
+    SetCapability(GL_DEPTH_TEST, state.depthTest, enabled);
+}
+
+void GLStateCache::SetBlend(bool enabled) {
+    SetCapability(GL_BLEND, state.blend, enabled);
+}
+
+void GLStateCache::SetCullFace(bool enabled) {
+    SetCapability(GL_CULL_FACE, state.cullFace, enabled);
+}
+
+void GLStateCache::SetDepthMask(bool enabled) {
+    const bool changed = state.depthMask != static_cast<int8_t>(enabled);
+    Record(Call::DepthMask, changed);
+    if (!changed) return;
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    state.depthMask = static_cast<int8_t>(enabled);
+}
+
+void GLStateCache::SetDepthFunc(GLenum func) {
+    const bool changed = state.depthFunc != func;
+    Record(Call::DepthFunc, changed);
+    if (!changed) return;
+    glDepthFunc(func);
+    state.depthFunc = func;
+}
+
+void GLStateCache::SetBlendFunc(GLenum source, GLenum destination) {
+    const bool changed = state.blendSource != source || state.blendDestination != destination;
+    Record(Call::BlendFunc, changed);
+    if (!changed) return;
+    glBlendFunc(source, destination);
+    state.blendSource = source;
+    state.blendDestination = destination;
+}
+
+void GLStateCache::ForgetProgram(GLuint program) {
+    if (state.program == program) state.program = UnknownName;
+}
+
+void GLStateCache::ForgetVertexArray(GLuint vao) {
+    if (state.vertexArray == vao) state.vertexArray = 0;
+}
+
+void GLStateCache::ForgetTexture(GLuint texture) {
+    for (GLuint& bound : state.textures) {
+        if (bound == texture) bound = 0;
+    }
+}
+
+const char* GLStateCache::CallName(Call call) {
+    switch (call) {
+    case Call::Program:       return "UseProgram";
+    case Call::VertexArray:   return "BindVertexArray";
+    case Call::ActiveTexture: return "ActiveTexture";
+    case Call::Texture:       return "BindTexture";
+    case Call::Capability:    return "Enable/Disable";
+    case Call::DepthMask:     return "DepthMask";
+    case Call::DepthFunc:     return "DepthFunc";
+    case Call::BlendFunc:     return "BlendFunc";
+    case Call::Uniform:       return "Uniform";
+    case Call::Draw:          return "Draw";
+    default:                  return "?";
+    }
+}
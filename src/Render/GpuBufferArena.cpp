@@ -0,0 +1,263 @@
+// GpuBufferArena.cpp
+#include "GpuBufferArena.h"
+#include "GLStateCache.h"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+    using Mirror::Core::RangeAllocator;
+
+    constexpr size_t InitialVertices = size_t(1) << 16;
+    constexpr size_t InitialIndexBytes = size_t(1) << 20;
+    constexpr size_t IndexAlignment = 4;  // 16/32 λ棬㰴 4 ֽڶ
+
+    GLvoid* OffsetToPointer(size_t offset) {
+        return reinterpret_cast<GLvoid*>(offset);
+    }
+
+    /**
+     * »滻ɻ壺帴ƾݣٰƶĿᵽλá
+     * д壬ƶǰصҲû⡣
+     */
+    GLuint ReplaceBuffer(GLuint old, size_t oldBytes, size_t newBytes,
+                         const std::vector<RangeAllocator::Move>* moves, size_t unit) {
+        GLuint buffer = 0;
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(newBytes), nullptr, GL_DYNAMIC_DRAW);
+        if (glGetError() == GL_OUT_OF_MEMORY) {
+            glDeleteBuffers(1, &buffer);
+            throw std::runtime_error("GPU ʧܣԴ治");
+        }
+        if (old != 0 && oldBytes > 0) {
+            glBindBuffer(GL_COPY_READ_BUFFER, old);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                                static_cast<GLsizeiptr>(std::min(oldBytes, newBytes)));
+            if (moves) {
+                for (const auto& move : *moves) {
+                    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                        static_cast<GLintptr>(move.from * unit),
+                                        static_cast<GLintptr>(move.to * unit),
+                                        static_cast<GLsizeiptr>(move.size * unit));
+                }
+            }
+            glDeleteBuffers(1, &old);
+        }
+        return buffer;
+    }
+
+    /**
+     * ڿռ䲻ʱݣط䵽ƫ
+     * @throws std::runtime_error ݺ޷
+     */
+    template <typename Relocate>
+    size_t AllocateOrMakeRoom(RangeAllocator& space, size_t size, size_t alignment,
+                              size_t& defragmentations, size_t& growths, Relocate&& relocate) {
+        size_t offset = space.Allocate(size, alignment);
+        if (offset != RangeAllocator::InvalidOffset) return offset;
+
+        // 㹻ֻǲ
+        if (space.FreeSize() >= size + alignment) {
+            const auto moves = space.Compact(alignment);
+            relocate(space.Capacity(), &moves);
+            ++defragmentations;
+            offset = space.Allocate(size, alignment);
+            if (offset != RangeAllocator::InvalidOffset) return offset;
+        }
+
+        // ֻӳĩβĿп飬һĽλù㣬мĿն
+        const size_t oldCapacity = space.Capacity();
+        space.Grow(std::max(oldCapacity * 2, space.UsedExtent() + size + alignment));
+        relocate(oldCapacity, nullptr);
+        ++growths;
+        offset = space.Allocate(size, alignment);
+        if (offset == RangeAllocator::InvalidOffset) throw std::runtime_error("GPU طʧ");
+        return offset;
+    }
+}
+
+GpuBufferArena::GpuBufferArena(VertexFormat vertexFormat)
+    : format(vertexFormat),
+      stride(VertexCodec::Stride(vertexFormat)),
+      vertexSpace(InitialVertices),
+      indexSpace(InitialIndexBytes)
+{
+    glGenVertexArrays(1, &vao);
+    vbo = ReplaceBuffer(0, 0, vertexSpace.Capacity() * stride, nullptr, stride);
+    ebo = ReplaceBuffer(0, 0, indexSpace.Capacity(), nullptr, 1);
+    SetupVertexArray();
+}
+
+GpuBufferArena::~GpuBufferArena() {
+    if (vao) {
+        GLStateCache::ForgetVertexArray(vao);
+        glDeleteVertexArrays(1, &vao);
+    }
+    if (vbo) glDeleteBuffers(1, &vbo);
+    if (ebo) glDeleteBuffers(1, &ebo);
+}
+
+GpuBufferArena& GpuBufferArena::ForFormat(VertexFormat format) {
+    static std::array<std::unique_ptr<GpuBufferArena>, 2> arenas;
+    auto& arena = arenas[static_cast<size_t>(format)];
+    if (!arena) arena = std::make_unique<GpuBufferArena>(format);
+    return *arena;
+}
+
+GpuBufferArena::Handle GpuBufferArena::Allocate(size_t vertexCount, size_t indexBytes) {
+    Block block;
+    block.vertexCount = vertexCount;
+    block.indexBytes = indexBytes;
+    if (vertexCount > 0) {
+        block.baseVertex = AllocateOrMakeRoom(vertexSpace, vertexCount, 1, defragmentations, growths,
+            [this](size_t oldCapacity, const std::vector<RangeAllocator::Move>* moves) {
+                ReallocateVertexBuffer(oldCapacity, moves);
+            });
+    }
+    if (indexBytes > 0) {
+        try {
+            block.indexOffset = AllocateOrMakeRoom(indexSpace, indexBytes, IndexAlignment, defragmentations, growths,
+                [this](size_t oldCapacity, const std::vector<RangeAllocator::Move>* moves) {
+                    ReallocateIndexBuffer(oldCapacity, moves);
+                });
+        } catch (...) {
+            if (vertexCount > 0) vertexSpace.Free(block.baseVertex);
+            throw;
+        }
+    }
+
+    Handle handle;
+    if (!freeHandles.empty()) {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+        blocks[handle] = block;
+    } else {
+        handle = static_cast<Handle>(blocks.size());
+        blocks.push_back(block);
+    }
+    return handle;
+}
+
+void GpuBufferArena::Free(Handle handle) {
+    Block& block = blocks[handle];
+    if (block.vertexCount > 0) vertexSpace.Free(block.baseVertex);
+    if (block.indexBytes > 0) indexSpace.Free(block.indexOffset);
+    block = Block{};
+    freeHandles.push_back(handle);
+}
+
+void GpuBufferArena::UploadVertices(Handle handle, const void* data, size_t bytes) {
+    const Block& block = blocks[handle];
+    if (bytes > block.vertexCount * stride) throw std::out_of_range("ݳؿС");
+    if (bytes == 0) return;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(block.baseVertex * stride),
+                    static_cast<GLsizeiptr>(bytes), data);
+}
+
+void GpuBufferArena::UploadIndices(Handle handle, size_t offset, const void* data, size_t bytes) {
+    const Block& block = blocks[handle];
+    if (offset + bytes > block.indexBytes) throw std::out_of_range("ݳؿС");
+    if (bytes == 0) return;
+    //  COPY_WRITE Ŀд룬Ķκ VAO 
+    glBindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(block.indexOffset + offset),
+                    static_cast<GLsizeiptr>(bytes), data);
+}
+
+void GpuBufferArena::Bind() const {
+    GLStateCache::BindVertexArray(vao);
+}
+
+void GpuBufferArena::Defragment() {
+    if (vertexSpace.Fragmentation() > 0.0f) {
+        const auto moves = vertexSpace.Compact();
+        ReallocateVertexBuffer(vertexSpace.Capacity(), &moves);
+        ++defragmentations;
+    }
+    if (indexSpace.Fragmentation() > 0.0f) {
+        const auto moves = indexSpace.Compact(IndexAlignment);
+        ReallocateIndexBuffer(indexSpace.Capacity(), &moves);
+        ++defragmentations;
+    }
+}
+
+GpuBufferArena::Statistics GpuBufferArena::GetStatistics() const {
+    Statistics stats;
+    stats.blocks = blocks.size() - freeHandles.size();
+    stats.vertexBytes = vertexSpace.UsedSize() * stride;
+    stats.vertexCapacityBytes = vertexSpace.Capacity() * stride;
+    stats.indexBytes = indexSpace.UsedSize();
+    stats.indexCapacityBytes = indexSpace.Capacity();
+    stats.vertexFragmentation = vertexSpace.Fragmentation();
+    stats.indexFragmentation = indexSpace.Fragmentation();
+    stats.defragmentations = defragmentations;
+    stats.growths = growths;
+    return stats;
+}
+
+void GpuBufferArena::ReallocateVertexBuffer(size_t oldCapacity,
+                                            const std::vector<RangeAllocator::Move>* moves) {
+    vbo = ReplaceBuffer(vbo, oldCapacity * stride, vertexSpace.Capacity() * stride, moves, stride);
+    if (moves && !moves->empty()) {
+        std::unordered_map<size_t, size_t> remap;
+        for (const auto& move : *moves) remap.emplace(move.from, move.to);
+        for (auto& block : blocks) {
+            if (block.vertexCount == 0) continue;
+            if (auto it = remap.find(block.baseVertex); it != remap.end()) block.baseVertex = it->second;
+        }
+    }
+    SetupVertexArray();
+}
+
+void GpuBufferArena::ReallocateIndexBuffer(size_t oldCapacity,
+                                           const std::vector<RangeAllocator::Move>* moves) {
+    ebo = ReplaceBuffer(ebo, oldCapacity, indexSpace.Capacity(), moves, 1);
+    if (moves && !moves->empty()) {
+        std::unordered_map<size_t, size_t> remap;
+        for (const auto& move : *moves) remap.emplace(move.from, move.to);
+        for (auto& block : blocks) {
+            if (block.indexBytes == 0) continue;
+            if (auto it = remap.find(block.indexOffset); it != remap.end()) block.indexOffset = it->second;
+        }
+    }
+    SetupVertexArray();
+}
+
+void GpuBufferArena::SetupVertexArray() {
+    GLStateCache::BindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+
+    if (format == VertexFormat::Quantized) {
+        const GLsizei quantizedStride = sizeof(QuantizedVertex);
+
+        // λãunorm16 һ [0,1]ɫΧлԭ
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, quantizedStride,
+                              OffsetToPointer(offsetof(QuantizedVertex, position)));
+
+        // ߣɫ
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, quantizedStride,
+                              OffsetToPointer(offsetof(QuantizedVertex, normal)));
+
+        // ꣺뾫ȸ
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, quantizedStride,
+                              OffsetToPointer(offsetof(QuantizedVertex, texCoords)));
+    } else {
+        const GLsizei vertexStride = sizeof(Vertex);
+
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, vertexStride, OffsetToPointer(offsetof(Vertex, Position)));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, vertexStride, OffsetToPointer(offsetof(Vertex, Normal)));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, vertexStride, OffsetToPointer(offsetof(Vertex, TexCoords)));
+    }
+    GLStateCache::BindVertexArray(0);
+}
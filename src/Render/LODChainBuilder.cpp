@@ -0,0 +1,36 @@
+// LODChainBuilder.cpp
+#include "LODChainBuilder.h"
+#include "MeshOptimizer.h"
+#include "QuadricSimplifier.h"
+
+std::vector<Mesh::LODLevel> LODChainBuilder::Build(std::span<const Vertex> vertices, std::vector<uint32_t>& indices,
+                                                   const Options& options) {
+    std::vector<Mesh::LODLevel> levels;
+    levels.push_back({ 0, static_cast<uint32_t>(indices.size()), 0.0f });
+    if (options.maxLevels <= 1 || indices.size() / 3 < options.minTriangles) return levels;
+
+    // ڹʱݣ֮ indices ׷ӲӰ
+    QuadricSimplifier simplifier(vertices, indices);
+    size_t targetVertices = simplifier.GetSourceVertexCount();
+    size_t previousTriangles = indices.size() / 3;
+    while (levels.size() < options.maxLevels) {
+        targetVertices = static_cast<size_t>(targetVertices * options.reduction);
+        simplifier.SimplifyTo(targetVertices);
+
+        // ͣʱһֻ˷Դ
+        const size_t triangles = simplifier.GetTriangleCount();
+        if (triangles == 0 || triangles > previousTriangles * (1.0f - options.minSavings)) break;
+
+        std::vector<uint32_t> levelIndices = simplifier.GetIndices();
+        // ΰԭ˳棬۵󻺴ֲԱ
+        if (options.cacheSize > 0)
+            levelIndices = MeshOptimizer::OptimizeVertexCache(levelIndices, vertices.size(), options.cacheSize);
+        levels.push_back({ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(levelIndices.size()),
+                           simplifier.GetError() });
+        indices.insert(indices.end(), levelIndices.begin(), levelIndices.end());
+
+        previousTriangles = triangles;
+        if (triangles < options.minTriangles) break;
+    }
+    return levels;
+}
@@ -1,13 +1,15 @@
 #include "Material.h"
+#include "Render/GLStateCache.h"
 #include <iostream>
 
 Material::Material(std::shared_ptr<Shader> shader)
     : shader(std::move(shader)) {}
 
 void Material::Apply() {
-    if (!shader || !shader->IsValid() || !dirty) return;
+    if (!IsValid()) return;
     
     shader->Use();
+    ApplyRenderState();
     
     // ñ
     for (const auto& [name, value] : floatParams) {
@@ -32,6 +34,12 @@ void Material::Apply() {
             shader->SetUniform(name, unit++);
         }
     }
-    
-    dirty = false; // 
+}
+
+void Material::ApplyRenderState() const {
+    const bool transparent = IsTransparent();
+    GLStateCache::SetBlend(transparent);
+    if (transparent) GLStateCache::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLStateCache::SetDepthMask(!transparent);
+    GLStateCache::SetCullFace(!doubleSided);
 }
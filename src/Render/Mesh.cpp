@@ -1,6 +1,11 @@
 // Mesh.cpp
 #include "Mesh.h"
+#include "GLStateCache.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
 #include <sstream>
 
 
@@ -8,6 +13,15 @@
 static_assert(sizeof(Vertex) == (sizeof(glm::vec3) * 2) + sizeof(glm::vec2),
              "Vertex ṹڴ沼ֲԤڣ");
 
+namespace {
+    // 16 λѰַĶʹͼԪ0xFFFF ҲЧ
+    constexpr size_t MaxShortIndexVertices = 65536;
+
+    std::vector<uint16_t> NarrowIndices(const unsigned int* indices, size_t count) {
+        return std::vector<uint16_t>(indices, indices + count);
+    }
+}
+
 // ȫƫתͷļΪ̬Ա
 /*
 private:
@@ -17,10 +31,13 @@ private:
 */
 
 Mesh::Mesh(std::vector<Vertex>&& vertices, 
-         std::vector<unsigned int>&& indices)
+         std::vector<unsigned int>&& indices,
+         VertexFormat format)
     : vertices(std::move(vertices)), 
-      indices(std::move(indices)) 
+      indices(std::move(indices)),
+      vertexFormat(format)
 {
+    ComputeBounds();
     SetupBuffers();
 }
 
@@ -40,12 +57,30 @@ ProgressiveLOD& Mesh::GetLODController() {
 Mesh::Mesh(Mesh&& other) noexcept
     : vertices(std::move(other.vertices)),
       indices(std::move(other.indices)),
-      VAO(other.VAO),
-      VBO(other.VBO),
-      EBO(other.EBO),
-      isUploaded(other.isUploaded) 
+      lodLevels(std::move(other.lodLevels)),
+      pickPositions(std::move(other.pickPositions)),
+      pickIndices(std::move(other.pickIndices)),
+      residency(other.residency),
+      reloader(std::move(other.reloader)),
+      meshlets(std::move(other.meshlets)),
+      vertexFormat(other.vertexFormat),
+      indexType(other.indexType),
+      arena(other.arena),
+      arenaBlock(other.arenaBlock),
+      isUploaded(other.isUploaded),
+      vertexCount(other.vertexCount),
+      indexCount(other.indexCount),
+      drawIndexCount(other.drawIndexCount),
+      gpuVertexBytes(other.gpuVertexBytes),
+      gpuIndexBytes(other.gpuIndexBytes),
+      positionOffset(other.positionOffset),
+      positionScale(other.positionScale),
+      boundsCenter(other.boundsCenter),
+      boundsRadius(other.boundsRadius),
+      boundsMin(other.boundsMin),
+      boundsMax(other.boundsMax)
 {
-    other.VAO = other.VBO = other.EBO = 0;
+    other.arenaBlock = GpuBufferArena::InvalidHandle;
     other.isUploaded = false;
 }
 
@@ -55,122 +90,206 @@ Mesh& Mesh::operator=(Mesh&& other) noexcept {
         ClearGPUResources();
         vertices = std::move(other.vertices);
         indices = std::move(other.indices);
-        VAO = other.VAO;
-        VBO = other.VBO;
-        EBO = other.EBO;
+        lodLevels = std::move(other.lodLevels);
+        pickPositions = std::move(other.pickPositions);
+        pickIndices = std::move(other.pickIndices);
+        residency = other.residency;
+        reloader = std::move(other.reloader);
+        meshlets = std::move(other.meshlets);
+        vertexFormat = other.vertexFormat;
+        indexType = other.indexType;
+        arena = other.arena;
+        arenaBlock = other.arenaBlock;
         isUploaded = other.isUploaded;
-        other.VAO = other.VBO = other.EBO = 0;
+        vertexCount = other.vertexCount;
+        indexCount = other.indexCount;
+        drawIndexCount = other.drawIndexCount;
+        gpuVertexBytes = other.gpuVertexBytes;
+        gpuIndexBytes = other.gpuIndexBytes;
+        positionOffset = other.positionOffset;
+        positionScale = other.positionScale;
+        boundsCenter = other.boundsCenter;
+        boundsRadius = other.boundsRadius;
+        boundsMin = other.boundsMin;
+        boundsMax = other.boundsMax;
+        other.arenaBlock = GpuBufferArena::InvalidHandle;
         other.isUploaded = false;
     }
     return *this;
 }
 
 void Mesh::SetupBuffers() {
-    //  OpenGL Ч
-    if (!gladLoadGL()) {
+    //  OpenGL Чԣָ gladLoadGLLoader أ
+    // ﲻظ gladLoadGLÿϴ½ȫڣ
+    if (!GLAD_GL_VERSION_3_3) {
         throw std::runtime_error("OpenGL δȷʼ");
     }
 
     ClearGPUResources();
 
-    // ɻ
-    glGenVertexArrays(1, &VAO);
-    CheckGLError(__LINE__);
-    glGenBuffers(1, &VBO);
-    CheckGLError(__LINE__);
-    glGenBuffers(1, &EBO);
-    CheckGLError(__LINE__);
+    // ͬʽĹл䣬VAO ɻͳһ
+    arena = &GpuBufferArena::ForFormat(vertexFormat);
+    indexType = SelectIndexType();
+    arenaBlock = arena->Allocate(vertices.size(), indices.size() * IndexSize());
 
-    glBindVertexArray(VAO);
+    UploadVertexBuffer();
+    UploadIndexBuffer();
     CheckGLError(__LINE__);
 
-    // ȫת
-    const auto vertexDataSize = static_cast<GLsizeiptr>(vertices.size() * sizeof(Vertex));
-    const auto indexDataSize = static_cast<GLsizeiptr>(indices.size() * sizeof(unsigned int));
-
-    // 㻺
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    CheckGLError(__LINE__);
-    glBufferData(GL_ARRAY_BUFFER, vertexDataSize, vertices.data(), GL_DYNAMIC_DRAW);
-    CheckGLError(__LINE__);
+    isUploaded = true;
+    RecordUploadSize();
+}
 
-    // 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    CheckGLError(__LINE__);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexDataSize, indices.data(), GL_DYNAMIC_DRAW);
-    CheckGLError(__LINE__);
+void Mesh::UploadVertexBuffer() {
+    if (vertexFormat == VertexFormat::Quantized) {
+        // Χÿϴ¼㣬֤ж㶼 unorm16 Χ
+        VertexCodec::ComputeQuantizationBox(vertices, positionOffset, positionScale);
+        const auto packed = VertexCodec::Quantize(vertices, positionOffset, positionScale);
+        arena->UploadVertices(arenaBlock, packed.data(), packed.size() * sizeof(QuantizedVertex));
+        return;
+    }
+    arena->UploadVertices(arenaBlock, vertices.data(), vertices.size() * sizeof(Vertex));
+}
 
-    // ãʹðȫת
-    constexpr GLsizei stride = sizeof(Vertex);
-    const auto positionOffset = OffsetToPointer(offsetof(Vertex, Position));
-    const auto normalOffset = OffsetToPointer(offsetof(Vertex, Normal));
-    const auto texCoordOffset = OffsetToPointer(offsetof(Vertex, TexCoords));
+void Mesh::UploadIndexBuffer() {
+    // ڵľֲţʱ baseVertex 㵽еλ
+    if (indexType == GL_UNSIGNED_SHORT) {
+        const auto narrow = NarrowIndices(indices.data(), indices.size());
+        arena->UploadIndices(arenaBlock, 0, narrow.data(), narrow.size() * sizeof(uint16_t));
+        return;
+    }
+    arena->UploadIndices(arenaBlock, 0, indices.data(), indices.size() * sizeof(unsigned int));
+}
 
-    // λ
-    glEnableVertexAttribArray(0);
-    CheckGLError(__LINE__);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, positionOffset);
-    CheckGLError(__LINE__);
-    
-    // 
-    glEnableVertexAttribArray(1);
-    CheckGLError(__LINE__);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, normalOffset);
-    CheckGLError(__LINE__);
-    
-    // 
-    glEnableVertexAttribArray(2);
-    CheckGLError(__LINE__);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, texCoordOffset);
-    CheckGLError(__LINE__);
+GLenum Mesh::SelectIndexType() const {
+    return vertices.size() <= MaxShortIndexVertices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
 
-    glBindVertexArray(0);
-    isUploaded = true;
-    
-    static bool hasPrinted = false;
-    if (!hasPrinted && !vertices.empty()) {
-        std::cout << "\n-----  -----\n";
-        // ӡVAO󶨵Ķ
-        std::cout << "VAO" << std::endl;
-        std::cout << "  - 0 (P): " << std::endl;
-        std::cout << "  - 1 (N): " << std::endl;
-        std::cout << "  - 2 (T): \n" << std::endl;
-        // ӡVBOеԭʼ
-        std::cout << "VBO" << std::endl;
-        for (size_t i = 0; i < std::min(size_t(20), vertices.size()); ++i) {
-            const auto& v = vertices[i];
-            printf("  [%2zu] Pos=(%6.2f, %6.2f, %6.2f) | Normal=(%6.2f, %6.2f, %6.2f) | UV=(%4.2f, %4.2f)\n",
-                   i,
-                   v.Position.x, v.Position.y, v.Position.z,
-                   v.Normal.x, v.Normal.y, v.Normal.z,
-                   v.TexCoords.x, v.TexCoords.y);
-        }
-        // ӡEBOеݣͲƥ䣩
-        if (!indices.empty()) {
-            std::cout << "\nEBO" << std::endl;
-            for (size_t i = 0; i < std::min(size_t(20), indices.size()); ++i) {
-                std::cout << "  " << indices[i] << (i % 3 == 2 ? "\n" : ", ");
-            }
-        }
-        std::cout << "----------------------------------------\n" << std::endl;
-        hasPrinted = true;
+void Mesh::Draw() const {
+    if (!isUploaded || !IsReady()) {
+        std::cerr << "棺Ⱦδϴ" << std::endl;
+        return;
     }
 
+    const auto& block = arena->GetBlock(arenaBlock);
+    arena->Bind();
+    glDrawElementsBaseVertex(GL_TRIANGLES,
+                             static_cast<GLsizei>(drawIndexCount),
+                             indexType,
+                             OffsetToPointer(block.indexOffset),
+                             static_cast<GLint>(block.baseVertex));
+    GLStateCache::Record(GLStateCache::Call::Draw, true);
+}
 
+void Mesh::Draw(size_t lod) const {
+    if (lodLevels.empty()) {
+        Draw();
+        return;
+    }
+    if (!isUploaded || !IsReady()) {
+        std::cerr << "棺Ⱦδϴ" << std::endl;
+        return;
+    }
+
+    const LODLevel& level = lodLevels[std::min(lod, lodLevels.size() - 1)];
+    const auto& block = arena->GetBlock(arenaBlock);
+    arena->Bind();
+    glDrawElementsBaseVertex(GL_TRIANGLES,
+                             static_cast<GLsizei>(level.indexCount),
+                             indexType,
+                             OffsetToPointer(block.indexOffset + level.firstIndex * IndexSize()),
+                             static_cast<GLint>(block.baseVertex));
+    GLStateCache::Record(GLStateCache::Call::Draw, true);
 }
 
-void Mesh::Draw() const {
-    if (!isUploaded || VAO == 0) {
+void Mesh::DrawRanges(std::span<const IndexRange> ranges) const {
+    if (!isUploaded || !IsReady()) {
         std::cerr << "棺Ⱦδϴ" << std::endl;
         return;
     }
-    
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 
-                  static_cast<GLsizei>(indices.size()), 
-                  GL_UNSIGNED_INT, 
-                  nullptr);
-    glBindVertexArray(0);
+    if (ranges.empty()) return;
+
+    const auto& block = arena->GetBlock(arenaBlock);
+    const GLint baseVertex = static_cast<GLint>(block.baseVertex);
+    arena->Bind();
+    if (ranges.size() == 1) {
+        glDrawElementsBaseVertex(GL_TRIANGLES,
+                                 static_cast<GLsizei>(ranges[0].indexCount),
+                                 indexType,
+                                 OffsetToPointer(block.indexOffset + ranges[0].firstIndex * IndexSize()),
+                                 baseVertex);
+    } else {
+        multiDrawCounts.clear();
+        multiDrawOffsets.clear();
+        multiDrawBaseVertices.assign(ranges.size(), baseVertex);
+        for (const auto& range : ranges) {
+            multiDrawCounts.push_back(static_cast<GLsizei>(range.indexCount));
+            multiDrawOffsets.push_back(OffsetToPointer(block.indexOffset + range.firstIndex * IndexSize()));
+        }
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, multiDrawCounts.data(), indexType, multiDrawOffsets.data(),
+                                      static_cast<GLsizei>(ranges.size()), multiDrawBaseVertices.data());
+    }
+    GLStateCache::Record(GLStateCache::Call::Draw, true);
+}
+
+void Mesh::SetLODLevels(std::vector<LODLevel> levels) {
+    for (const auto& level : levels) {
+        if (size_t(level.firstIndex) + level.indexCount > indexCount)
+            throw std::out_of_range("LOD 𳬳巶Χ");
+    }
+    lodLevels = std::move(levels);
+    drawIndexCount = lodLevels.empty() ? indexCount : lodLevels[0].indexCount;
+}
+
+void Mesh::ClearLODLevels() {
+    if (lodLevels.size() <= 1 || !HasCPUData()) return;
+    //  0 λ忪ͷضϺϴ
+    indices.resize(lodLevels[0].indexCount);
+    indices.shrink_to_fit();
+    lodLevels.clear();
+    UpdateGPUData();
+}
+
+void Mesh::ReplaceIndices(std::vector<unsigned int> newIndices) {
+    indices = std::move(newIndices);
+    lodLevels.clear();
+    meshlets.clear();
+    UpdateGPUData();
+}
+
+void Mesh::SetMeshlets(std::vector<Meshlet> clusters) {
+    const size_t baseCount = lodLevels.empty() ? indexCount : lodLevels[0].indexCount;
+    for (const auto& meshlet : clusters) {
+        if (size_t(meshlet.firstIndex) + meshlet.indexCount > baseCount)
+            throw std::out_of_range("س 0 Χ");
+    }
+    meshlets = std::move(clusters);
+}
+
+size_t Mesh::SelectLOD(float pixelsPerUnit, float maxPixelError) const {
+    // 漶𵥵ӣһ
+    for (size_t lod = lodLevels.size(); lod > 1; --lod) {
+        if (lodLevels[lod - 1].error * pixelsPerUnit <= maxPixelError) return lod - 1;
+    }
+    return 0;
+}
+
+void Mesh::ComputeBounds() {
+    if (vertices.empty()) return;
+    glm::vec3 minP = vertices[0].Position, maxP = minP;
+    for (const auto& v : vertices) {
+        minP = glm::min(minP, v.Position);
+        maxP = glm::max(maxP, v.Position);
+    }
+    boundsMin = minP;
+    boundsMax = maxP;
+    boundsCenter = 0.5f * (minP + maxP);
+    boundsRadius = 0.0f;
+    for (const auto& v : vertices) {
+        const glm::vec3 d = v.Position - boundsCenter;
+        boundsRadius = std::max(boundsRadius, glm::dot(d, d));
+    }
+    boundsRadius = std::sqrt(boundsRadius);
 }
 
 void Mesh::CalculateNormals() {
@@ -204,50 +323,184 @@ void Mesh::Destroy() {
     ClearGPUResources();
     vertices.clear();
     indices.clear();
+    lodLevels.clear();
+    meshlets.clear();
+    std::vector<glm::vec3>().swap(pickPositions);
+    std::vector<unsigned int>().swap(pickIndices);
 }
 
-void Mesh::ClearGPUResources() {
-    if (VAO) {
-        glDeleteVertexArrays(1, &VAO);
-        VAO = 0;
+void Mesh::ReleaseCPUData() {
+    if (!HasCPUData()) return;
+    if (residency == Residency::PositionsOnly) {
+        // ʰȡڵ޳ֻҪǰƵΣ 0 򽥽򻯺ǰ׺
+        pickPositions.resize(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) pickPositions[i] = vertices[i].Position;
+        const size_t count = std::min(drawIndexCount, indices.size());
+        pickIndices.assign(indices.begin(), indices.begin() + count);
+    }
+    // clear 黹Ҫ
+    std::vector<Vertex>().swap(vertices);
+    std::vector<unsigned int>().swap(indices);
+}
+
+void Mesh::SetResidency(Residency policy) {
+    residency = policy;
+    if (isUploaded) ApplyResidency();
+}
+
+void Mesh::ApplyResidency() {
+    if (residency != Residency::Keep) ReleaseCPUData();
+    if (residency == Residency::Discard) {
+        std::vector<glm::vec3>().swap(pickPositions);
+        std::vector<unsigned int>().swap(pickIndices);
+    }
+}
+
+bool Mesh::RestoreCPUData() {
+    if (HasCPUData()) return true;
+    if (!reloader) return false;
+
+    std::vector<Vertex> restoredVertices;
+    std::vector<unsigned int> restoredIndices;
+    reloader(restoredVertices, restoredIndices);
+    // GPU е LOD Χضָԭģһ˵Դѱ仯
+    if (isUploaded && (restoredVertices.size() != vertexCount || restoredIndices.size() != indexCount))
+        throw std::runtime_error("ؽϴݲһ");
+
+    vertices = std::move(restoredVertices);
+    indices = std::move(restoredIndices);
+    std::vector<glm::vec3>().swap(pickPositions);
+    std::vector<unsigned int>().swap(pickIndices);
+    return true;
+}
+
+void Mesh::RestoreVertices(std::vector<Vertex> restored) {
+    if (isUploaded && restored.size() != vertexCount)
+        throw std::runtime_error("ؽϴݲһ");
+    vertices = std::move(restored);
+    std::vector<glm::vec3>().swap(pickPositions);
+    std::vector<unsigned int>().swap(pickIndices);
+}
+
+bool Mesh::GetOccluderGeometry(OccluderGeometry& geometry) const {
+    if (HasCPUData()) {
+        if (vertices.empty()) return false;
+        geometry.positions = &vertices.front().Position.x;
+        geometry.stride = sizeof(Vertex);
+        geometry.vertexCount = vertices.size();
+        geometry.indices = indices.data();
+        geometry.indexCount = std::min(drawIndexCount, indices.size());
+        return true;
     }
-    if (VBO) {
-        glDeleteBuffers(1, &VBO);
-        VBO = 0;
+    if (pickPositions.empty()) return false;
+    geometry.positions = &pickPositions.front().x;
+    geometry.stride = sizeof(glm::vec3);
+    geometry.vertexCount = pickPositions.size();
+    geometry.indices = pickIndices.data();
+    geometry.indexCount = pickIndices.size();
+    return true;
+}
+
+bool Mesh::Raycast(const glm::vec3& origin, const glm::vec3& direction, float& distance) const {
+    // Moller-Trumbore 㷨פʱֱӶ㣬ʰȡ
+    const bool full = HasCPUData();
+    const size_t count = full ? std::min(drawIndexCount, indices.size()) : pickIndices.size();
+    const unsigned int* triangles = full ? indices.data() : pickIndices.data();
+    auto position = [&](unsigned int index) -> const glm::vec3& {
+        return full ? vertices[index].Position : pickPositions[index];
+    };
+
+    constexpr float Epsilon = 1e-8f;
+    bool hit = false;
+    float nearest = std::numeric_limits<float>::max();
+    for (size_t i = 0; i + 2 < count; i += 3) {
+        const glm::vec3& p0 = position(triangles[i]);
+        const glm::vec3 e1 = position(triangles[i + 1]) - p0;
+        const glm::vec3 e2 = position(triangles[i + 2]) - p0;
+        const glm::vec3 p = glm::cross(direction, e2);
+        const float det = glm::dot(e1, p);
+        if (std::abs(det) < Epsilon) continue;  // ƽ
+        const float inverse = 1.0f / det;
+        const glm::vec3 s = origin - p0;
+        const float u = glm::dot(s, p) * inverse;
+        if (u < 0.0f || u > 1.0f) continue;
+        const glm::vec3 q = glm::cross(s, e1);
+        const float v = glm::dot(direction, q) * inverse;
+        if (v < 0.0f || u + v > 1.0f) continue;
+        const float t = glm::dot(e2, q) * inverse;
+        if (t >= 0.0f && t < nearest) {
+            nearest = t;
+            hit = true;
+        }
     }
-    if (EBO) {
-        glDeleteBuffers(1, &EBO);
-        EBO = 0;
+    if (hit) distance = nearest;
+    return hit;
+}
+
+void Mesh::RecordUploadSize() {
+    vertexCount = vertices.size();
+    indexCount = indices.size();
+    drawIndexCount = lodLevels.empty() ? indexCount : std::min<size_t>(lodLevels[0].indexCount, indexCount);
+    gpuVertexBytes = vertexCount * VertexCodec::Stride(vertexFormat);
+    gpuIndexBytes = indexCount * IndexSize();
+}
+
+void Mesh::ClearGPUResources() {
+    if (arena && arenaBlock != GpuBufferArena::InvalidHandle) {
+        arena->Free(arenaBlock);
     }
+    arenaBlock = GpuBufferArena::InvalidHandle;
     isUploaded = false;
 }
 
 
 void Mesh::UpdateGPUData() {
+    if (!HasCPUData()) {
+        std::cerr << "棺CPU ͷţ GPU ݸ" << std::endl;
+        return;
+    }
     if (!IsReady()) {
         SetupBuffers(); // ״ϴ
         return;
     }
 
-    glBindVertexArray(VAO);
-    CheckGLError(__LINE__);
+    // ܿ 16 λޣ֮ѡСʱԭظǣ»
+    const GLenum newIndexType = SelectIndexType();
+    const auto& block = arena->GetBlock(arenaBlock);
+    const size_t newIndexSize = newIndexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+    if (block.vertexCount != vertices.size() || block.indexBytes != indices.size() * newIndexSize) {
+        SetupBuffers();
+        return;
+    }
 
-    // ¶㻺
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, 
-                vertices.size() * sizeof(Vertex), 
-                vertices.data(), 
-                GL_DYNAMIC_DRAW); // ޸Ϊ̬ģʽ
-
-    // 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                indices.size() * sizeof(unsigned int),
-                indices.data(),
-                GL_DYNAMIC_DRAW); // ޸Ϊ̬ģʽ
-
-    glBindVertexArray(0);
+    // Χпܱ仯ò
+    indexType = newIndexType;
+    UploadVertexBuffer();
+    UploadIndexBuffer();
     isUploaded = true;
+    RecordUploadSize();
+}
+
+void Mesh::UpdateIndexRange(size_t first, size_t count) {
+    if (!isUploaded || !IsReady() || indices.size() != indexCount || vertices.size() != vertexCount) {
+        UpdateGPUData();  // δϴ򳤶ȱ仯Ϳܸı䣩ֻϴ
+        return;
+    }
+    if (count == 0) return;
+    if (first + count > indexCount)
+        throw std::out_of_range("·ΧԽ");
+
+    if (indexType == GL_UNSIGNED_SHORT) {
+        const auto narrow = NarrowIndices(indices.data() + first, count);
+        arena->UploadIndices(arenaBlock, first * sizeof(uint16_t), narrow.data(), count * sizeof(uint16_t));
+    } else {
+        arena->UploadIndices(arenaBlock, first * sizeof(unsigned int), indices.data() + first,
+                             count * sizeof(unsigned int));
+    }
+}
+
+void Mesh::SetDrawIndexCount(size_t count) {
+    drawIndexCount = std::min(count, indexCount);
 }
 
 // 麯
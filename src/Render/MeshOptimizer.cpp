@@ -0,0 +1,248 @@
+// MeshOptimizer.cpp
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    constexpr uint32_t Invalid = ~0u;
+
+    /**
+     * FIFO 㻺ģ⣺ÿδʱһ
+     * ڻеҽ뻺δдС
+     */
+    class FifoCache {
+    public:
+        FifoCache(size_t vertexCount, size_t cacheSize)
+            : entered(vertexCount, 0), size(static_cast<uint32_t>(cacheSize)), time(size + 1) {}
+
+        /// ʶ㣬Ƿδ
+        bool Access(uint32_t v) {
+            if (time - entered[v] <= size) return false;
+            entered[v] = time++;
+            return true;
+        }
+        /// ջ
+        void Flush() { time += size + 1; }
+
+    private:
+        std::vector<uint32_t> entered;
+        uint32_t size;
+        uint32_t time;
+    };
+
+    glm::vec3 TriangleCross(std::span<const Vertex> vertices, const uint32_t* tri) {
+        const glm::vec3& p0 = vertices[tri[0]].Position;
+        return glm::cross(vertices[tri[1]].Position - p0, vertices[tri[2]].Position - p0);
+    }
+}
+
+MeshOptimizer::Report MeshOptimizer::Optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                              const Options& options) {
+    if (indices.size() % 3 != 0)
+        throw std::runtime_error(" 3 ı: " + std::to_string(indices.size()));
+    for (uint32_t index : indices) {
+        if (index >= vertices.size())
+            throw std::runtime_error("Խ: " + std::to_string(index));
+    }
+
+    Report report;
+    report.before = AnalyzeVertexCache(indices, vertices.size(), options.cacheSize);
+
+    const bool overdraw = options.overdrawThreshold >= 1.0f;
+    std::vector<uint32_t> clusters;
+    indices = OptimizeVertexCache(indices, vertices.size(), options.cacheSize, overdraw ? &clusters : nullptr);
+    if (overdraw) OptimizeOverdraw(vertices, indices, clusters, options.cacheSize, options.overdrawThreshold);
+    if (options.optimizeVertexFetch) OptimizeVertexFetch(vertices, indices);
+
+    report.after = AnalyzeVertexCache(indices, vertices.size(), options.cacheSize);
+    return report;
+}
+
+std::vector<uint32_t> MeshOptimizer::OptimizeVertexCache(std::span<const uint32_t> indices, size_t vertexCount,
+                                                         size_t cacheSize, std::vector<uint32_t>* clusters) {
+    const size_t triangleCount = indices.size() / 3;
+    std::vector<uint32_t> result;
+    result.reserve(triangleCount * 3);
+    if (clusters) clusters->clear();
+    if (triangleCount == 0) return result;
+
+    // 㵽εڽӣCSRlive Ϊδ
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) ++offsets[indices[i] + 1];
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    std::vector<uint32_t> live(vertexCount);
+    {
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; ++i) adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        for (size_t v = 0; v < vertexCount; ++v) live[v] = offsets[v + 1] - offsets[v];
+    }
+
+    const uint32_t size = static_cast<uint32_t>(cacheSize);
+    std::vector<uint32_t> entered(vertexCount, 0);  // 뻺ʱʱ
+    uint32_t time = size + 1;
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint32_t> deadEnd;  // Ķ㣬·ʱ
+    deadEnd.reserve(triangleCount * 3);
+    std::vector<uint32_t> candidates;
+    size_t scan = 0;  // ˳ɨλ
+
+    uint32_t fan = indices[0];
+    if (clusters) clusters->push_back(0);
+    for (;;) {
+        // ĵȫδ
+        candidates.clear();
+        for (uint32_t k = offsets[fan]; k < offsets[fan + 1]; ++k) {
+            const uint32_t t = adjacency[k];
+            if (emitted[t]) continue;
+            emitted[t] = 1;
+            for (int c = 0; c < 3; ++c) {
+                const uint32_t v = indices[3 * size_t(t) + c];
+                result.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                --live[v];
+                if (time - entered[v] > size) entered[v] = time++;
+            }
+        }
+
+        // һģѡȫԻڻĶ㣬Խ뻺Խ
+        uint32_t next = Invalid;
+        int64_t bestPriority = -1;
+        for (uint32_t v : candidates) {
+            if (live[v] == 0) continue;
+            int64_t priority = 0;
+            if (time - entered[v] + 2 * live[v] <= size) priority = time - entered[v];
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = v;
+            }
+        }
+
+        if (next == Invalid) {
+            // ·ȻĶ㣬ٰ˳ɨ
+            while (!deadEnd.empty() && next == Invalid) {
+                const uint32_t v = deadEnd.back();
+                deadEnd.pop_back();
+                if (live[v] > 0) next = v;
+            }
+            while (next == Invalid && scan < vertexCount) {
+                if (live[scan] > 0) next = static_cast<uint32_t>(scan);
+                else ++scan;
+            }
+            if (next == Invalid) break;
+            if (clusters && clusters->back() != result.size() / 3) clusters->push_back(static_cast<uint32_t>(result.size() / 3));
+        }
+        fan = next;
+    }
+    return result;
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::span<const Vertex> vertices, std::vector<uint32_t>& indices,
+                                     std::span<const uint32_t> clusters, size_t cacheSize, float threshold) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || clusters.size() < 2) return;
+
+    // ϲأ仺濪ʼۼƣֻۼ ACMR  threshold ȫ ACMR ·п
+    // и ACMR ֵ
+    const float limit = AnalyzeVertexCache(indices, vertices.size(), cacheSize).acmr * threshold;
+    std::vector<uint32_t> starts{ 0 };
+    {
+        FifoCache cache(vertices.size(), cacheSize);
+        size_t misses = 0;
+        size_t next = 1;
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (int c = 0; c < 3; ++c) misses += cache.Access(indices[3 * t + c]);
+            const size_t end = t + 1;
+            if (next < clusters.size() && clusters[next] == end) {
+                ++next;
+                if (static_cast<float>(misses) <= limit * static_cast<float>(end - starts.back())) {
+                    starts.push_back(static_cast<uint32_t>(end));
+                    cache.Flush();
+                    misses = 0;
+                }
+            }
+        }
+    }
+    if (starts.size() < 2) return;
+    starts.push_back(static_cast<uint32_t>(triangleCount));
+    const size_t clusterCount = starts.size() - 1;
+
+    // صȨƽ
+    std::vector<glm::vec3> centroids(clusterCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> normals(clusterCount, glm::vec3(0.0f));
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusterCount; ++c) {
+        float area = 0.0f;
+        for (uint32_t t = starts[c]; t < starts[c + 1]; ++t) {
+            const uint32_t* tri = &indices[3 * size_t(t)];
+            const glm::vec3 n = TriangleCross(vertices, tri);
+            const float a = glm::length(n);
+            const glm::vec3 center = (vertices[tri[0]].Position + vertices[tri[1]].Position + vertices[tri[2]].Position) / 3.0f;
+            centroids[c] += center * a;
+            normals[c] += n;
+            area += a;
+        }
+        meshCentroid += centroids[c];
+        meshArea += area;
+        if (area > 0.0f) centroids[c] /= area;
+    }
+    if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+    // Խ⣨ƫط߷򣩵ĴԽڵأȻ
+    std::vector<float> keys(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        const float length = glm::length(normals[c]);
+        keys[c] = length > 0.0f ? glm::dot(centroids[c] - meshCentroid, normals[c] / length) : 0.0f;
+    }
+    std::vector<uint32_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+
+    std::vector<uint32_t> sorted;
+    sorted.reserve(indices.size());
+    for (uint32_t c : order) {
+        sorted.insert(sorted.end(), indices.begin() + 3 * size_t(starts[c]), indices.begin() + 3 * size_t(starts[c + 1]));
+    }
+    indices.swap(sorted);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex>& vertices, std::span<uint32_t> indices) {
+    std::vector<uint32_t> remap(vertices.size(), Invalid);
+    std::vector<Vertex> reordered;
+    reordered.reserve(vertices.size());
+    for (uint32_t& index : indices) {
+        if (remap[index] == Invalid) {
+            remap[index] = static_cast<uint32_t>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+    reordered.shrink_to_fit();
+    vertices.swap(reordered);
+}
+
+MeshOptimizer::CacheStatistics MeshOptimizer::AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount,
+                                                                 size_t cacheSize) {
+    CacheStatistics stats;
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return stats;
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<uint8_t> referenced(vertexCount, 0);
+    size_t misses = 0, unique = 0;
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        const uint32_t v = indices[i];
+        misses += cache.Access(v);
+        if (!referenced[v]) {
+            referenced[v] = 1;
+            ++unique;
+        }
+    }
+    stats.acmr = static_cast<float>(misses) / static_cast<float>(triangleCount);
+    stats.atvr = static_cast<float>(misses) / static_cast<float>(unique);
+    return stats;
+}
@@ -0,0 +1,237 @@
+// MeshletBuilder.cpp
+#include "MeshletBuilder.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    constexpr uint32_t Invalid = ~0u;
+    // ׶Снҵڸֵʱؼ屳ټ¼׶
+    constexpr float MinConeDot = 0.1f;
+
+    glm::vec3 TriangleCenter(std::span<const Vertex> vertices, const uint32_t* tri) {
+        return (vertices[tri[0]].Position + vertices[tri[1]].Position + vertices[tri[2]].Position) / 3.0f;
+    }
+
+    /// ɴڶμΧͷ׶
+    void ComputeBounds(std::span<const Vertex> vertices, std::span<const uint32_t> clusterVertices,
+                       std::span<const uint32_t> triangles, Mesh::Meshlet& meshlet) {
+        glm::vec3 minP = vertices[clusterVertices[0]].Position, maxP = minP;
+        for (uint32_t v : clusterVertices) {
+            minP = glm::min(minP, vertices[v].Position);
+            maxP = glm::max(maxP, vertices[v].Position);
+        }
+        meshlet.center = 0.5f * (minP + maxP);
+        float radius = 0.0f;
+        for (uint32_t v : clusterVertices) {
+            const glm::vec3 d = vertices[v].Position - meshlet.center;
+            radius = std::max(radius, glm::dot(d, d));
+        }
+        meshlet.radius = std::sqrt(radius);
+
+        // ׶ȡλ֮͵ķ򣬰ȡнķߣһΣ
+        auto unitNormal = [&](size_t i, glm::vec3& n) {
+            const glm::vec3& p0 = vertices[triangles[i]].Position;
+            n = glm::cross(vertices[triangles[i + 1]].Position - p0, vertices[triangles[i + 2]].Position - p0);
+            const float length = glm::length(n);
+            if (length <= 0.0f) return false;  // ˻βɼӰ챳ж
+            n /= length;
+            return true;
+        };
+        glm::vec3 sum(0.0f), n;
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            if (unitNormal(i, n)) sum += n;
+        }
+        meshlet.coneAxis = glm::vec3(0.0f);
+        meshlet.coneCutoff = 1.0f;
+        const float sumLength = glm::length(sum);
+        if (sumLength <= 0.0f) return;
+
+        const glm::vec3 axis = sum / sumLength;
+        float minDot = 1.0f;
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            if (unitNormal(i, n)) minDot = std::min(minDot, glm::dot(axis, n));
+        }
+        if (minDot < MinConeDot) return;
+
+        meshlet.coneAxis = axis;
+        meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+}
+
+std::vector<Mesh::Meshlet> MeshletBuilder::Build(std::span<const Vertex> vertices, std::span<uint32_t> indices,
+                                                 const Options& options) {
+    if (indices.size() % 3 != 0)
+        throw std::runtime_error(" 3 ı: " + std::to_string(indices.size()));
+    for (uint32_t index : indices) {
+        if (index >= vertices.size())
+            throw std::runtime_error("Խ: " + std::to_string(index));
+    }
+
+    std::vector<Mesh::Meshlet> meshlets;
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || triangleCount < options.minMeshTriangles) return meshlets;
+    const size_t maxVertices = std::max<size_t>(options.maxVertices, 3);
+    const size_t maxTriangles = std::max<size_t>(options.maxTriangles, 1);
+    const size_t vertexCount = vertices.size();
+
+    // 㵽εڽӣCSRÿǰ live δ
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (uint32_t index : indices) ++offsets[index + 1];
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> live(vertexCount, 0);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        const uint32_t v = indices[i];
+        adjacency[offsets[v] + live[v]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<uint8_t> assigned(triangleCount, 0);
+    std::vector<uint32_t> localIndex(vertexCount, Invalid);  // ڵǰڵ
+    std::vector<uint32_t> clusterVertices;
+    std::vector<uint32_t> frontier;          // ǰδεĶ
+    std::vector<uint32_t> clusterTriangles;  // ǰصΣԭʼ
+    std::vector<uint32_t> localTriangles;
+    std::vector<uint32_t> reordered;
+    reordered.reserve(indices.size());
+    clusterVertices.reserve(maxVertices);
+    clusterTriangles.reserve(maxTriangles * 3);
+    glm::vec3 centerSum(0.0f);
+    size_t scan = 0;  // ´صӰԭ˳ȡʱŻ˳
+
+    uint32_t lastTriangle = Invalid;
+
+    auto addTriangle = [&](uint32_t t) {
+        assigned[t] = 1;
+        lastTriangle = t;
+        for (int c = 0; c < 3; ++c) {
+            const uint32_t v = indices[3 * size_t(t) + c];
+            clusterTriangles.push_back(v);
+            if (localIndex[v] == Invalid) {
+                localIndex[v] = static_cast<uint32_t>(clusterVertices.size());
+                clusterVertices.push_back(v);
+                frontier.push_back(v);
+                centerSum += vertices[v].Position;
+            }
+            // ڽӱЧƳ
+            uint32_t* list = adjacency.data() + offsets[v];
+            uint32_t* last = list + --live[v];
+            *std::find(list, last + 1, t) = *last;
+        }
+    };
+
+    auto flushCluster = [&]() {
+        Mesh::Meshlet meshlet;
+        meshlet.firstIndex = static_cast<uint32_t>(reordered.size());
+        meshlet.indexCount = static_cast<uint32_t>(clusterTriangles.size());
+        ComputeBounds(vertices, clusterVertices, clusterTriangles, meshlet);
+
+        if (options.cacheSize > 0) {
+            // ڶ٣ھֲţشС
+            localTriangles.clear();
+            for (uint32_t v : clusterTriangles) localTriangles.push_back(localIndex[v]);
+            const auto ordered = MeshOptimizer::OptimizeVertexCache(localTriangles, clusterVertices.size(),
+                                                                    options.cacheSize);
+            for (uint32_t local : ordered) reordered.push_back(clusterVertices[local]);
+        } else {
+            reordered.insert(reordered.end(), clusterTriangles.begin(), clusterTriangles.end());
+        }
+        meshlets.push_back(meshlet);
+
+        for (uint32_t v : clusterVertices) localIndex[v] = Invalid;
+        clusterVertices.clear();
+        frontier.clear();
+        clusterTriangles.clear();
+        centerSum = glm::vec3(0.0f);
+    };
+
+    for (;;) {
+        if (clusterTriangles.empty()) {
+            while (scan < triangleCount && assigned[scan]) ++scan;
+            if (scan == triangleCount) break;
+            addTriangle(static_cast<uint32_t>(scan));
+            continue;
+        }
+
+        // һҲ¶αȻŵһֱ࣬ȡãʡȥɨ߽
+        uint32_t best = Invalid;
+        for (int c = 0; c < 3 && best == Invalid; ++c) {
+            const uint32_t v = indices[3 * size_t(lastTriangle) + c];
+            for (uint32_t k = offsets[v], end = offsets[v] + live[v]; k < end; ++k) {
+                const uint32_t* tri = &indices[3 * size_t(adjacency[k])];
+                if (localIndex[tri[0]] != Invalid && localIndex[tri[1]] != Invalid && localIndex[tri[2]] != Invalid) {
+                    best = adjacency[k];
+                    break;
+                }
+            }
+        }
+
+        // ڱ߽١
+        if (best == Invalid) {
+            const glm::vec3 center = centerSum / static_cast<float>(clusterVertices.size());
+            int bestExtra = 4;
+            float bestDistance = std::numeric_limits<float>::max();
+            // ˳ƳڽȫĶ
+            frontier.erase(std::remove_if(frontier.begin(), frontier.end(), [&](uint32_t v) { return live[v] == 0; }),
+                           frontier.end());
+            for (uint32_t v : frontier) {
+                for (uint32_t k = offsets[v], end = offsets[v] + live[v]; k < end; ++k) {
+                    const uint32_t t = adjacency[k];
+                    const uint32_t* tri = &indices[3 * size_t(t)];
+                    const int extra = (localIndex[tri[0]] == Invalid) + (localIndex[tri[1]] == Invalid)
+                                    + (localIndex[tri[2]] == Invalid);
+                    if (extra > bestExtra || clusterVertices.size() + extra > maxVertices) continue;
+                    const glm::vec3 d = TriangleCenter(vertices, tri) - center;
+                    const float distance = glm::dot(d, d);
+                    if (extra < bestExtra || distance < bestDistance) {
+                        best = t;
+                        bestExtra = extra;
+                        bestDistance = distance;
+                    }
+                }
+            }
+        }
+
+        if (best == Invalid) {
+            flushCluster();
+            continue;
+        }
+        addTriangle(best);
+        if (clusterTriangles.size() / 3 >= maxTriangles) flushCluster();
+    }
+    if (!clusterTriangles.empty()) flushCluster();
+
+    std::copy(reordered.begin(), reordered.end(), indices.begin());
+    return meshlets;
+}
+
+MeshletCuller::Statistics MeshletCuller::Cull(std::span<const Mesh::Meshlet> meshlets, const Frustum& frustum,
+                                              const glm::vec3& camera, bool coneCulling,
+                                              std::vector<Mesh::IndexRange>& ranges) {
+    Statistics stats;
+    ranges.clear();
+    for (const auto& meshlet : meshlets) {
+        if (!frustum.IntersectsSphere(meshlet.center, meshlet.radius)) {
+            ++stats.frustumCulled;
+            continue;
+        }
+        if (coneCulling && meshlet.coneCutoff < 1.0f) {
+            // ׶ļнС 90 -  ʱΧһ㿴ĶǱ
+            const glm::vec3 toCenter = meshlet.center - camera;
+            if (glm::dot(toCenter, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius) {
+                ++stats.backfaceCulled;
+                continue;
+            }
+        }
+        ++stats.visible;
+        if (!ranges.empty() && ranges.back().firstIndex + ranges.back().indexCount == meshlet.firstIndex) {
+            ranges.back().indexCount += meshlet.indexCount;
+        } else {
+            ranges.push_back({ meshlet.firstIndex, meshlet.indexCount });
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,288 @@
+// OcclusionCuller.cpp
+#include "OcclusionCuller.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EMAO_OCCLUSION_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    /// һߵıߺ Ax + By + CΪʱʱڲȫǸ
+    struct Edge {
+        float a, b, c;
+    };
+
+    /**
+     * ڲౣصıߺأ L1 ĴǸضڱڲࡣ
+     * ιضд룬ֻٵ൲
+     */
+    template <typename V>
+    Edge MakeEdge(const V& from, const V& to) {
+        const float dx = to.x - from.x, dy = to.y - from.y;
+        return { -dy, dx, dy * from.x - dx * from.y - 0.5f * (std::abs(dx) + std::abs(dy)) };
+    }
+
+    glm::vec4 Lerp(const glm::vec4& a, const glm::vec4& b, float t) { return a + (b - a) * t; }
+}
+
+void OcclusionCuller::Resize(int newWidth, int newHeight) {
+    width = std::max(1, newWidth);
+    height = std::max(1, newHeight);
+    pitch = (width + Lanes - 1) / Lanes * Lanes;
+    depth.assign(static_cast<size_t>(pitch) * height, 0.0f);
+
+    // ÿ߼루ȡֱ 11
+    pyramid.clear();
+    int w = width, h = height;
+    while (w > 1 || h > 1) {
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+        Level level;
+        level.width = w;
+        level.height = h;
+        level.depth.resize(static_cast<size_t>(w) * h);
+        pyramid.push_back(std::move(level));
+    }
+    hizReady = false;
+}
+
+void OcclusionCuller::Begin(const glm::mat4& matrix) {
+    viewProjection = matrix;
+    std::fill(depth.begin(), depth.end(), 0.0f);
+    stats = {};
+    hizReady = false;
+}
+
+void OcclusionCuller::RasterizeOccluder(const glm::mat4& model, const float* positions, size_t stride,
+                                        size_t vertexCount, const uint32_t* indices, size_t indexCount,
+                                        Backend backend) {
+    if (!IsSupported(backend)) backend = Backend::Scalar;
+    const glm::mat4 mvp = viewProjection * model;
+    const auto* bytes = reinterpret_cast<const unsigned char*>(positions);
+    auto clip = [&](uint32_t index) {
+        const float* p = reinterpret_cast<const float*>(bytes + index * stride);
+        return mvp * glm::vec4(p[0], p[1], p[2], 1.0f);
+    };
+
+    ++stats.occluders;
+    hizReady = false;
+    for (size_t i = 0; i + 2 < indexCount; i += 3) {
+        if (indices[i] >= vertexCount || indices[i + 1] >= vertexCount || indices[i + 2] >= vertexCount) continue;
+        ++stats.triangles;
+        RasterizeClipped(clip(indices[i]), clip(indices[i + 1]), clip(indices[i + 2]), backend);
+    }
+}
+
+void OcclusionCuller::RasterizeClipped(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c, Backend backend) {
+    // 㶼ͬһƽ֮ʱβɼ
+    for (int axis = 0; axis < 2; ++axis) {
+        if (a[axis] > a.w && b[axis] > b.w && c[axis] > c.w) return;
+        if (a[axis] < -a.w && b[axis] < -b.w && c[axis] < -c.w) return;
+    }
+
+    // ƽ棨z >= -wüõı
+    const glm::vec4 input[3] = { a, b, c };
+    glm::vec4 polygon[4];
+    int count = 0;
+    for (int i = 0; i < 3; ++i) {
+        const glm::vec4& p = input[i];
+        const glm::vec4& q = input[(i + 1) % 3];
+        const float dp = p.z + p.w, dq = q.z + q.w;
+        if (dp >= 0.0f) polygon[count++] = p;
+        if ((dp >= 0.0f) != (dq >= 0.0f)) polygon[count++] = Lerp(p, q, dp / (dp - dq));
+    }
+    if (count < 3) return;
+
+    ScreenVertex screen[4];
+    for (int i = 0; i < count; ++i) {
+        const glm::vec4& p = polygon[i];
+        if (!(p.w > 0.0f)) return;
+        const float invW = 1.0f / p.w;
+        screen[i] = { (p.x * invW * 0.5f + 0.5f) * width, (p.y * invW * 0.5f + 0.5f) * height, invW };
+    }
+    RasterizeTriangle(screen[0], screen[1], screen[2], backend);
+    if (count == 4) RasterizeTriangle(screen[0], screen[2], screen[3], backend);
+}
+
+void OcclusionCuller::RasterizeTriangle(const ScreenVertex& p0, const ScreenVertex& p1, const ScreenVertex& p2,
+                                        Backend backend) {
+    ScreenVertex v0 = p0, v1 = p1, v2 = p2;
+    float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+    if (!(std::abs(area) > 1e-8f)) return;  // ˻ NaN
+    if (area < 0.0f) {
+        // ޳ͳһΪʱ
+        std::swap(v1, v2);
+        area = -area;
+    }
+
+    // ΧڵأڸõĻȡ⼫
+    const float minX = std::max(std::min({ v0.x, v1.x, v2.x }), 0.0f);
+    const float maxX = std::min(std::max({ v0.x, v1.x, v2.x }), static_cast<float>(width - 1) + 0.5f);
+    const float minY = std::max(std::min({ v0.y, v1.y, v2.y }), 0.0f);
+    const float maxY = std::min(std::max({ v0.y, v1.y, v2.y }), static_cast<float>(height - 1) + 0.5f);
+    if (minX > maxX || minY > maxY) return;
+    const int x0 = static_cast<int>(std::floor(minX)), x1 = static_cast<int>(std::floor(maxX));
+    const int y0 = static_cast<int>(std::floor(minY)), y1 = static_cast<int>(std::floor(maxY));
+    ++stats.rasterizedTriangles;
+
+    const Edge e0 = MakeEdge(v1, v2), e1 = MakeEdge(v2, v0), e2 = MakeEdge(v0, v1);
+    // 1/w ĻռԵģz = zxx + zyy + zc
+    const float zx = ((v1.invW - v0.invW) * (v2.y - v0.y) - (v2.invW - v0.invW) * (v1.y - v0.y)) / area;
+    const float zy = ((v2.invW - v0.invW) * (v1.x - v0.x) - (v1.invW - v0.invW) * (v2.x - v0.x)) / area;
+    // дڵԶֵ1/w ԣСֵĳϣĴֵ
+    const float zc = v0.invW - zx * v0.x - zy * v0.y - 0.5f * (std::abs(zx) + std::abs(zy));
+
+    for (int y = y0; y <= y1; ++y) {
+        const float py = static_cast<float>(y) + 0.5f;
+        const float row0 = e0.b * py + e0.c, row1 = e1.b * py + e1.c, row2 = e2.b * py + e2.c;
+        const float rowZ = zy * py + zc;
+        float* line = depth.data() + static_cast<size_t>(y) * pitch;
+
+#if EMAO_OCCLUSION_SSE
+        if (backend == Backend::SSE) {
+            // ÿ 4 أβаΧų˳·һ
+            const __m128 laneOffset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            const __m128 a0 = _mm_set1_ps(e0.a), a1 = _mm_set1_ps(e1.a), a2 = _mm_set1_ps(e2.a), az = _mm_set1_ps(zx);
+            const __m128 r0 = _mm_set1_ps(row0), r1 = _mm_set1_ps(row1), r2 = _mm_set1_ps(row2), rz = _mm_set1_ps(rowZ);
+            const __m128 first = _mm_set1_ps(static_cast<float>(x0) + 0.5f);
+            const __m128 last = _mm_set1_ps(static_cast<float>(x1) + 0.5f);
+            const __m128 zero = _mm_setzero_ps();
+            for (int x = x0 & ~(Lanes - 1); x <= x1; x += Lanes) {
+                const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffset);
+                __m128 inside = _mm_and_ps(_mm_cmpge_ps(px, first), _mm_cmple_ps(px, last));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, px), r0), zero));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, px), r1), zero));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, px), r2), zero));
+                if (_mm_movemask_ps(inside) == 0) continue;
+                const __m128 z = _mm_add_ps(_mm_mul_ps(az, px), rz);
+                const __m128 old = _mm_loadu_ps(line + x);
+                const __m128 nearest = _mm_max_ps(old, z);
+                _mm_storeu_ps(line + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, old)));
+            }
+            continue;
+        }
+#endif
+        for (int x = x0; x <= x1; ++x) {
+            const float px = static_cast<float>(x) + 0.5f;
+            if (e0.a * px + row0 >= 0.0f && e1.a * px + row1 >= 0.0f && e2.a * px + row2 >= 0.0f) {
+                const float z = zx * px + rowZ;
+                //  SSE · _mm_max_ps ȡֵһ
+                line[x] = line[x] > z ? line[x] : z;
+            }
+        }
+    }
+}
+
+void OcclusionCuller::BuildHiZ() {
+    // ÿȡһ 22 Զ1/w Сȣ߳ʱĩ / ĩظʹ
+    const float* source = depth.data();
+    int sourceWidth = width, sourceHeight = height, sourcePitch = pitch;
+    for (Level& level : pyramid) {
+        for (int y = 0; y < level.height; ++y) {
+            const int sy0 = 2 * y, sy1 = std::min(2 * y + 1, sourceHeight - 1);
+            for (int x = 0; x < level.width; ++x) {
+                const int sx0 = 2 * x, sx1 = std::min(2 * x + 1, sourceWidth - 1);
+                const float* row0 = source + static_cast<size_t>(sy0) * sourcePitch;
+                const float* row1 = source + static_cast<size_t>(sy1) * sourcePitch;
+                level.depth[static_cast<size_t>(y) * level.width + x] =
+                    std::min(std::min(row0[sx0], row0[sx1]), std::min(row1[sx0], row1[sx1]));
+            }
+        }
+        source = level.depth.data();
+        sourceWidth = sourcePitch = level.width;
+        sourceHeight = level.height;
+    }
+    hizReady = true;
+}
+
+bool OcclusionCuller::IsVisible(const glm::mat4& model, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    ++stats.tests;
+    if (!hizReady) return true;
+
+    const glm::mat4 mvp = viewProjection * model;
+    float minX = std::numeric_limits<float>::max(), minY = minX;
+    float maxX = std::numeric_limits<float>::lowest(), maxY = maxX;
+    float nearest = 0.0f;  // Χ 1/w
+    for (int corner = 0; corner < 8; ++corner) {
+        const glm::vec3 p((corner & 1) ? boundsMax.x : boundsMin.x,
+                          (corner & 2) ? boundsMax.y : boundsMin.y,
+                          (corner & 4) ? boundsMax.z : boundsMin.z);
+        const glm::vec4 c = mvp * glm::vec4(p, 1.0f);
+        // ƽཻ޷ɿĻΧ
+        if (!(c.w > 0.0f) || c.z < -c.w) return true;
+        const float invW = 1.0f / c.w;
+        const float sx = (c.x * invW * 0.5f + 0.5f) * width;
+        const float sy = (c.y * invW * 0.5f + 0.5f) * height;
+        minX = std::min(minX, sx);
+        maxX = std::max(maxX, sx);
+        minY = std::min(minY, sy);
+        maxY = std::max(maxY, sy);
+        nearest = std::max(nearest, invW);
+    }
+    // ȫĻĽ׶޳
+    if (maxX < 0.0f || maxY < 0.0f || minX >= static_cast<float>(width) || minY >= static_cast<float>(height))
+        return true;
+
+    // ΧνӴأ𼶼ֱ 44 
+    int x0 = static_cast<int>(std::floor(std::max(minX, 0.0f)));
+    int y0 = static_cast<int>(std::floor(std::max(minY, 0.0f)));
+    int x1 = static_cast<int>(std::floor(std::min(maxX, static_cast<float>(width - 1))));
+    int y1 = static_cast<int>(std::floor(std::min(maxY, static_cast<float>(height - 1))));
+    size_t level = 0;
+    while ((x1 - x0 >= 4 || y1 - y0 >= 4) && level < pyramid.size()) {
+        x0 >>= 1;
+        y0 >>= 1;
+        x1 >>= 1;
+        y1 >>= 1;
+        ++level;
+    }
+
+    const float* source = level == 0 ? depth.data() : pyramid[level - 1].depth.data();
+    const int sourcePitch = level == 0 ? pitch : pyramid[level - 1].width;
+    float farthest = std::numeric_limits<float>::max();
+    for (int y = y0; y <= y1; ++y) {
+        const float* row = source + static_cast<size_t>(y) * sourcePitch;
+        for (int x = x0; x <= x1; ++x) farthest = std::min(farthest, row[x]);
+    }
+
+    // ΧԱԶڵȸԶ
+    if (nearest < farthest * (1.0f - DepthBias)) {
+        ++stats.occluded;
+        return false;
+    }
+    return true;
+}
+
+std::vector<float> OcclusionCuller::GetDepth() const {
+    std::vector<float> result(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; ++y) {
+        std::copy_n(depth.data() + static_cast<size_t>(y) * pitch, width, result.data() + static_cast<size_t>(y) * width);
+    }
+    return result;
+}
+
+bool OcclusionCuller::IsSupported(Backend backend) {
+    switch (backend) {
+    case Backend::Scalar:
+        return true;
+    case Backend::SSE:
+#if EMAO_OCCLUSION_SSE
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+OcclusionCuller::Backend OcclusionCuller::BestBackend() {
+    return IsSupported(Backend::SSE) ? Backend::SSE : Backend::Scalar;
+}
+
+const char* OcclusionCuller::BackendName(Backend backend) {
+    return backend == Backend::SSE ? "SSE" : "scalar";
+}
@@ -1,165 +1,288 @@
 #include "ProgressiveLOD.h"
 #include "Mesh.h"
-#include <glm/gtx/norm.hpp>
-#include <glm/gtc/constants.hpp>
+#include "Core/ThreadPool.h"
 #include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+    // ڸĶСڸֵʱϲϴ glBufferSubData 
+    constexpr size_t MergeGap = 256;
+    // ʱΪϴȫĶһ
+    constexpr size_t MaxUploadRanges = 64;
+}
 
 ProgressiveLOD::ProgressiveLOD(Mesh& mesh)
     : target_mesh(mesh),
-      current_vertex_count(mesh.GetVertices().size()),
-      vertex_validity(mesh.GetVertices().size(), true)
+      current_vertex_count(mesh.GetVertices().size())
 { }
 
 void ProgressiveLOD::Precompute() {
-    if (is_precomputed) return;
-
-    // ԭʼ/
-    original_vertices = target_mesh.GetVertices();
-    original_indices  = target_mesh.GetIndices();
-
-    // ߵ EdgeCollapse ӳ
-    std::unordered_map<uint64_t, EdgeCollapse> edge_map;
-    for (size_t i = 0; i + 2 < original_indices.size(); i += 3) {
-        uint32_t ia = original_indices[i],
-                 ib = original_indices[i+1],
-                 ic = original_indices[i+2];
-        uint32_t tri[3] = { ia, ib, ic };
-        for (int e = 0; e < 3; ++e) {
-            size_t a = tri[e], b = tri[(e+1)%3];
-            if (a > b) std::swap(a, b);
-            uint64_t key = (uint64_t(a) << 32) | b;
-            auto it = edge_map.find(key);
-            if (it == edge_map.end()) {
-                EdgeCollapse ec;
-                ec.v1 = a; ec.v2 = b;
-                ec.collapse_cost = ComputeCollapseCost(a, b);
-                ec.affected_triangles.push_back(i / 3);
-                edge_map[key] = std::move(ec);
-            } else {
-                it->second.affected_triangles.push_back(i / 3);
-            }
-        }
+    if (pending_build.valid()) {
+        pending_build.wait();
+        Poll();
+        return;
     }
+    if (is_precomputed || build_failed) return;
+    const SourceLoader source = SnapshotSource();
+    if (!source) return;
 
-    // תƵѡб
-    collapse_candidates.reserve(edge_map.size());
-    for (auto& kv : edge_map) {
-        collapse_candidates.push_back(std::move(kv.second));
+    try {
+        ReceiveBuild(BuildFromSource(source, active_params));
+    } catch (const std::exception& e) {
+        std::cerr << "Ԥʧ: " << e.what() << std::endl;
+        build_failed = true;
     }
-    RebuildPriorityQueue();
-    is_precomputed = true;
 }
 
-float ProgressiveLOD::ComputeCollapseCost(size_t v1, size_t v2) const {
-    const Vertex& A = original_vertices[v1];
-    const Vertex& B = original_vertices[v2];
+void ProgressiveLOD::PrecomputeAsync(Mirror::Core::ThreadPool& pool) {
+    if (is_precomputed || pending_build.valid() || build_failed) return;
+    SourceLoader source = SnapshotSource();
+    if (!source) return;
+
+    // Դݣ Reloaderĸ
+    pending_build = pool.Submit([source = std::move(source), params = active_params]() {
+        return BuildFromSource(source, params);
+    });
+}
+
+bool ProgressiveLOD::Poll() {
+    if (!pending_build.valid()) return is_precomputed;
+    if (pending_build.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+
+    try {
+        ReceiveBuild(pending_build.get());
+    } catch (const std::exception& e) {
+        std::cerr << "Ԥʧ: " << e.what() << std::endl;
+        build_failed = true;
+        return false;
+    }
+    SimplifyTo(requested_ratio);
+    return true;
+}
+
+ProgressiveLOD::SourceLoader ProgressiveLOD::SnapshotSource() const {
+    // 㻺ڼбֲ䣬ֻ 0 ɢ LOD ĸ
+    const auto& levels = target_mesh.GetLODLevels();
+    const size_t baseCount = levels.empty() ? target_mesh.GetIndexCount() : levels[0].indexCount;
+    if (target_mesh.HasCPUData()) {
+        const auto& indices = target_mesh.GetIndices();
+        return [vertices = target_mesh.GetVertices(),
+                base = std::vector<unsigned int>(indices.begin(), indices.begin() + std::min(baseCount, indices.size()))](
+                   std::vector<Vertex>& outVertices, std::vector<unsigned int>& outIndices) {
+            outVertices = vertices;
+            outIndices = base;
+        };
+    }
+    // פͷŹ CPU дԴؽ
+    if (!target_mesh.GetReloader()) return {};
+    return [reloader = target_mesh.GetReloader(), baseCount](
+               std::vector<Vertex>& outVertices, std::vector<unsigned int>& outIndices) {
+        reloader(outVertices, outIndices);
+        if (outIndices.size() < baseCount) throw std::runtime_error("ؽϴݲһ");
+        outIndices.resize(baseCount);
+    };
+}
 
-    float geom  = active_params.geometry_weight * glm::distance(A.Position, B.Position);
-    float norm  = active_params.normal_weight   * (1.0f - glm::dot(A.Normal, B.Normal));
-    float uvErr = active_params.uv_weight       * glm::distance(A.TexCoords, B.TexCoords);
-    return geom + norm + uvErr;
+ProgressiveLOD::Build ProgressiveLOD::BuildFromSource(const SourceLoader& source, const Parameters& params) {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    source(vertices, indices);
+    Build build = BuildProgressiveMesh(vertices, indices, params);
+    build.vertices = std::move(vertices);
+    build.source_indices = std::move(indices);
+    return build;
 }
 
-void ProgressiveLOD::ApplyEdgeCollapse(const EdgeCollapse& col) {
-    auto& V = target_mesh.GetVertices();
-    auto& I = target_mesh.GetIndices();
-    //  v2 Ч
-    vertex_validity[col.v2] = false;
-    //  index==v2 Ļ v1
-    for (auto& idx : I) {
-        if (idx == col.v2) idx = uint32_t(col.v1);
-    }
-    // ϲԵ v1
-    Vertex& dst = V[col.v1];
-    const Vertex& src = original_vertices[col.v2];
-    dst.Position  = (dst.Position  + src.Position)  * 0.5f;
-    dst.Normal    = glm::normalize(dst.Normal + src.Normal);
-    dst.TexCoords = (dst.TexCoords + src.TexCoords) * 0.5f;
-
-    --current_vertex_count;
-    current_error = col.collapse_cost;
+ProgressiveLOD::Build ProgressiveLOD::BuildProgressiveMesh(std::span<const Vertex> vertices,
+                                                           std::span<const uint32_t> indices,
+                                                           const Parameters& params) {
+    QuadricSimplifier::Options options;
+    options.geometryWeight = params.geometry_weight;
+    options.normalWeight = params.normal_weight;
+    options.uvWeight = params.uv_weight;
+    options.preserveTopology = params.preserve_topology;
+
+    QuadricSimplifier simplifier(vertices, indices, options);
+    // Ӻ˻Σ˳۵¼е
+    const std::vector<uint32_t> source = simplifier.GetIndices();
+    Build build;
+    simplifier.RecordHistory(&build.history);
+    simplifier.SimplifyTo(0);
+    build.source_vertex_count = simplifier.GetSourceVertexCount();
+    const size_t triangles = source.size() / 3;
+
+    // ţӲɾǰԽɾԽ
+    // ִǰ k ۵ʣǡǰ׺
+    constexpr uint32_t Unassigned = ~0u;
+    std::vector<uint32_t> slot(triangles, Unassigned);
+    const auto& removed = build.history.removedTriangles;
+    for (size_t i = 0; i < removed.size(); ++i) {
+        slot[removed[i]] = static_cast<uint32_t>(triangles - 1 - i);
+    }
+    uint32_t next = 0;
+    for (auto& s : slot) {
+        if (s == Unassigned) s = next++;
+    }
+
+    build.indices.assign(source.size(), 0);
+    for (size_t t = 0; t < triangles; ++t) {
+        std::copy_n(&source[3 * t], 3, &build.indices[3 * size_t(slot[t])]);
+    }
+    for (auto& change : build.history.changes) {
+        change.corner = 3 * slot[change.corner / 3] + change.corner % 3;
+    }
+    return build;
 }
 
-void ProgressiveLOD::RemoveDegenerateTriangles() {
-    auto& I = target_mesh.GetIndices();
-    std::vector<uint32_t> clean;
-    clean.reserve(I.size());
-    for (size_t i = 0; i + 2 < I.size(); i += 3) {
-        uint32_t a = I[i], b = I[i+1], c = I[i+2];
-        if (!vertex_validity[a] || !vertex_validity[b] || !vertex_validity[c]) continue;
-        if (a==b || b==c || c==a) continue;
-        clean.push_back(a);
-        clean.push_back(b);
-        clean.push_back(c);
-    }
-    I.swap(clean);
+void ProgressiveLOD::ReceiveBuild(Build&& build) {
+    current_vertex_count = build.source_vertex_count;
+    unapplied = std::move(build);
+    is_precomputed = true;
 }
 
-void ProgressiveLOD::RebuildPriorityQueue() {
-    while (!collapse_queue.empty()) collapse_queue.pop();
-    for (size_t i = 0; i < collapse_candidates.size(); ++i) {
-        // 渺ֵʹ top() С cost
-        collapse_queue.emplace(-collapse_candidates[i].collapse_cost, i);
+bool ProgressiveLOD::ApplyBuild() {
+    Build build = std::move(*unapplied);
+    unapplied.reset();
+    // ͷ CPU װعõĶ㣬ٴؽ
+    if (!target_mesh.HasCPUData()) {
+        try {
+            target_mesh.RestoreVertices(std::move(build.vertices));
+        } catch (const std::exception& e) {
+            std::cerr << "ؽʧ: " << e.what() << std::endl;
+            build_failed = true;
+            is_precomputed = false;
+            return false;
+        }
     }
+    InstallBuild(std::move(build));
+    return true;
 }
 
-void ProgressiveLOD::ResetToOriginal() {
-    // ָԭʼ
-    target_mesh.GetVertices() = original_vertices;
-    target_mesh.GetIndices()  = original_indices;
-    // ָЧ
-    vertex_validity.assign(original_vertices.size(), true);
-    current_vertex_count = original_vertices.size();
+void ProgressiveLOD::InstallBuild(Build&& build) {
+    history = std::move(build.history);
+    original_indices = std::move(build.source_indices);
+    source_vertex_count = build.source_vertex_count;
+    triangle_count = build.indices.size() / 3;
+
+    // źϴһΣɢ LOD ر֮ʧЧֲֻ֮
+    target_mesh.ReplaceIndices(std::move(build.indices));
+    current_step = 0;
+    current_vertex_count = source_vertex_count;
     current_error = 0.0f;
-    // ؽȶ
-    RebuildPriorityQueue();
+    last_ratio = 0.0f;
+    changed_indices.clear();
+    is_applied = true;
 }
 
-void ProgressiveLOD::SimplifyTo(float ratio) {
-    if (!is_precomputed) Precompute();
+size_t ProgressiveLOD::TargetStep(float ratio) const {
+    const size_t target = static_cast<size_t>(source_vertex_count * (1.0f - ratio));
+    if (source_vertex_count <= target) return 0;
+    // ʣඥ۵ݼȡһĿļ
+    const auto& steps = history.steps;
+    const auto it = std::partition_point(steps.begin(), steps.end(),
+        [target](const QuadricSimplifier::CollapseStep& step) { return step.vertexCount > target; });
+    return it == steps.end() ? steps.size() : size_t(it - steps.begin()) + 1;
+}
 
-    ratio = glm::clamp(ratio, 0.0f, 1.0f);
+void ProgressiveLOD::ApplyStep(size_t step, bool forward) {
+    auto& indices = target_mesh.GetIndices();
+    const uint32_t begin = step > 0 ? history.steps[step - 1].changeEnd : 0;
+    const uint32_t end = history.steps[step].changeEnd;
+    for (uint32_t i = begin; i < end; ++i) {
+        const auto& change = history.changes[i];
+        indices[change.corner] = forward ? change.newVertex : change.oldVertex;
+        changed_indices.push_back(change.corner);
+    }
+}
 
-    // ratio Сָԭʼ۵
-    if (ratio < last_ratio) {
-        ResetToOriginal();
+void ProgressiveLOD::UploadChanges() {
+    if (changed_indices.empty()) return;
+    std::sort(changed_indices.begin(), changed_indices.end());
+
+    // ϲĸĶλ
+    std::vector<std::pair<size_t, size_t>> ranges;  // [first, last]
+    for (uint32_t index : changed_indices) {
+        if (!ranges.empty() && index <= ranges.back().second + MergeGap) {
+            ranges.back().second = index;
+        } else {
+            ranges.emplace_back(index, index);
+        }
     }
-    last_ratio = ratio;
+    if (ranges.size() > MaxUploadRanges) {
+        // ȻʱϲСɴڵô޵ǰٴ
+        std::vector<size_t> gaps(ranges.size() - 1);
+        for (size_t i = 1; i < ranges.size(); ++i) gaps[i - 1] = ranges[i].first - ranges[i - 1].second;
+        const size_t merges = ranges.size() - MaxUploadRanges;
+        std::nth_element(gaps.begin(), gaps.begin() + (merges - 1), gaps.end());
+        const size_t threshold = gaps[merges - 1];
 
-    // Ŀ궥
-    const size_t target_count =
-        static_cast<size_t>(original_vertices.size() * (1.0f - ratio));
-
-    int moves = active_params.max_collapses_per_frame;
-    // ѾĿ꣬۵
-    while (current_vertex_count > target_count &&
-           !collapse_queue.empty() &&
-           moves-- > 0) {
-        auto [negCost, idx] = collapse_queue.top();
-        collapse_queue.pop();
-        const auto& col = collapse_candidates[idx];
-        if (vertex_validity[col.v1] && vertex_validity[col.v2]) {
-            ApplyEdgeCollapse(col);
+        size_t count = 1;
+        for (size_t i = 1; i < ranges.size(); ++i) {
+            auto& last = ranges[count - 1];
+            if (ranges[i].first - last.second <= threshold) last.second = ranges[i].second;
+            else ranges[count++] = ranges[i];
         }
+        ranges.resize(count);
     }
+    for (const auto& [first, last] : ranges) {
+        target_mesh.UpdateIndexRange(first, last - first + 1);
+    }
+    changed_indices.clear();
+}
 
-    RemoveDegenerateTriangles();
-    target_mesh.UpdateGPUData();
+void ProgressiveLOD::SimplifyTo(float ratio) {
+    ratio = glm::clamp(ratio, 0.0f, 1.0f);
+    requested_ratio = ratio;
+    // 첽Ԥǰֻ±ʱ Poll л
+    if (pending_build.valid()) {
+        Poll();
+        return;
+    }
+    // δ仯ʱκι
+    if (is_precomputed && ratio == last_ratio) return;
+    if (!is_precomputed) {
+        if (build_failed) return;
+        Precompute();
+        if (!is_precomputed) return;
+    }
+    // ԭʼɢ LOD رЧ
+    if (!is_applied) {
+        if (ratio == 0.0f) return;
+        if (!ApplyBuild()) return;
+    }
+    // ͷ CPU ޷ٸдţԴؽԭʼݲܴ
+    if (!target_mesh.HasCPUData()) return;
+    last_ratio = ratio;
+
+    const size_t target = TargetStep(ratio);
+    if (target == current_step) return;
+    while (current_step < target) ApplyStep(current_step++, true);   // ۵
+    while (current_step > target) ApplyStep(--current_step, false);  // 
+    UploadChanges();
+
+    const size_t removed = current_step > 0 ? history.steps[current_step - 1].removedEnd : 0;
+    target_mesh.SetDrawIndexCount((triangle_count - removed) * 3);
+    current_vertex_count = current_step > 0 ? history.steps[current_step - 1].vertexCount : source_vertex_count;
+    current_error = current_step > 0 ? history.steps[current_step - 1].error : 0.0f;
 }
 
 void ProgressiveLOD::UpdateParameters(const Parameters& new_params) {
-    if (is_precomputed &&
-        active_params.preserve_topology != new_params.preserve_topology) {
-        throw std::runtime_error(
-            "Cannot change preserve_topology after precompute");
-    }
     active_params = new_params;
-    if (is_precomputed) {
-        // ¼ߴۣؽ
-        for (auto& col : collapse_candidates) {
-            col.collapse_cost =
-                ComputeCollapseCost(col.v1, col.v2);
-        }
-        RebuildPriorityQueue();
+    if (pending_build.valid()) Precompute();  // ɰɲеԤ
+    if (!is_precomputed) return;
+    // Ȩظı۵˳֮ı䣬¼¼صǰ
+    if (is_applied) {
+        if (!target_mesh.HasCPUData()) return;
+        Build build = BuildProgressiveMesh(target_mesh.GetVertices(), original_indices, active_params);
+        build.source_indices = original_indices;
+        InstallBuild(std::move(build));
+    } else if (unapplied) {
+        Build build = BuildProgressiveMesh(unapplied->vertices, unapplied->source_indices, active_params);
+        build.vertices = std::move(unapplied->vertices);
+        build.source_indices = std::move(unapplied->source_indices);
+        ReceiveBuild(std::move(build));
     }
+    SimplifyTo(requested_ratio);
 }
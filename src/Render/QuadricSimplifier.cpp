@@ -0,0 +1,638 @@
+// QuadricSimplifier.cpp
+#include "QuadricSimplifier.h"
+#include "Core/ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    constexpr float FlipThreshold = 0.25f;  // ۵ǰ߼нҵڸֵΪת
+    constexpr float BorderWeight = 10.0f;   // ߽ԼƽƽȨ
+
+    uint32_t HashPosition(const glm::vec3& p) {
+        uint32_t bits[3];
+        std::memcpy(bits, &p, sizeof(bits));
+        for (auto& b : bits) {
+            if (b == 0x80000000u) b = 0;  // -0.0f  0.0f Ϊͬһλ
+        }
+        // ĵλȫΪ 0ҪֻϺȡģ
+        uint32_t h = bits[0] * 0x9E3779B1u ^ bits[1] * 0x85EBCA77u ^ bits[2] * 0xC2B2AE3Du;
+        h ^= h >> 16;
+        h *= 0x7FEB352Du;
+        h ^= h >> 15;
+        h *= 0x846CA68Bu;
+        h ^= h >> 16;
+        return h;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Quadric
+// ---------------------------------------------------------------------------
+void QuadricSimplifier::Quadric::Add(const Quadric& o) {
+    a00 += o.a00; a11 += o.a11; a22 += o.a22;
+    a10 += o.a10; a20 += o.a20; a21 += o.a21;
+    b0 += o.b0; b1 += o.b1; b2 += o.b2;
+    c += o.c;
+    w += o.w;
+}
+
+void QuadricSimplifier::Quadric::AddPlane(const glm::vec3& n, float d, float weight) {
+    a00 += weight * n.x * n.x;
+    a11 += weight * n.y * n.y;
+    a22 += weight * n.z * n.z;
+    a10 += weight * n.y * n.x;
+    a20 += weight * n.z * n.x;
+    a21 += weight * n.z * n.y;
+    b0 += weight * n.x * d;
+    b1 += weight * n.y * d;
+    b2 += weight * n.z * d;
+    c += weight * d * d;
+    w += weight;
+}
+
+QuadricSimplifier::Quadric QuadricSimplifier::Quadric::Translated(const glm::vec3& t) const {
+    // A' = A, b' = b + A t, c' = c + 2 bt + t(A t)
+    const glm::vec3 at(a00 * t.x + a10 * t.y + a20 * t.z,
+                       a10 * t.x + a11 * t.y + a21 * t.z,
+                       a20 * t.x + a21 * t.y + a22 * t.z);
+    Quadric q = *this;
+    q.b0 += at.x;
+    q.b1 += at.y;
+    q.b2 += at.z;
+    q.c += 2.0f * (b0 * t.x + b1 * t.y + b2 * t.z) + glm::dot(t, at);
+    return q;
+}
+
+float QuadricSimplifier::Quadric::Evaluate(const glm::vec3& x) const {
+    const float ax = a00 * x.x + a10 * x.y + a20 * x.z;
+    const float ay = a10 * x.x + a11 * x.y + a21 * x.z;
+    const float az = a20 * x.x + a21 * x.y + a22 * x.z;
+    return x.x * ax + x.y * ay + x.z * az + 2.0f * (b0 * x.x + b1 * x.y + b2 * x.z) + c;
+}
+
+// ---------------------------------------------------------------------------
+// 
+// ---------------------------------------------------------------------------
+QuadricSimplifier::QuadricSimplifier(std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+                                     const Options& options)
+    : options(options)
+{
+    Weld(vertices, indices);
+    BuildAdjacency();
+    BuildQuadrics();
+    ClassifyVertices();
+
+    bestCollapse.resize(positions.size());
+    dirty.assign(positions.size(), Stale);
+    updatedPass.assign(positions.size(), 0);
+}
+
+void QuadricSimplifier::Weld(std::span<const Vertex> vertices, std::span<const uint32_t> indices) {
+    if (indices.size() % 3 != 0)
+        throw std::runtime_error(" 3 ı: " + std::to_string(indices.size()));
+
+    const size_t count = vertices.size();
+    std::vector<uint8_t> referenced(count, 0);
+    for (uint32_t index : indices) {
+        if (index >= count)
+            throw std::runtime_error("Խ: " + std::to_string(index));
+        referenced[index] = 1;
+    }
+
+    // Χйһλ
+    glm::vec3 minP(std::numeric_limits<float>::max());
+    glm::vec3 maxP(std::numeric_limits<float>::lowest());
+    for (size_t v = 0; v < count; ++v) {
+        if (!referenced[v]) continue;
+        minP = glm::min(minP, vertices[v].Position);
+        maxP = glm::max(maxP, vertices[v].Position);
+    }
+    const glm::vec3 extent = maxP - minP;
+    scale = std::max({ extent.x, extent.y, extent.z });
+    if (!(scale > 0.0f)) scale = 1.0f;
+    const float invScale = 1.0f / scale;
+
+    // ѰַϣλȫͬĶΪһ
+    size_t tableSize = 1;
+    while (tableSize < count * 2) tableSize <<= 1;
+    std::vector<uint32_t> table(tableSize, Invalid);
+    std::vector<uint32_t> groupOf(count, Invalid);
+    for (uint32_t v = 0; v < count; ++v) {
+        if (!referenced[v]) continue;
+        const glm::vec3& p = vertices[v].Position;
+        size_t slot = HashPosition(p) & (tableSize - 1);
+        while (table[slot] != Invalid && vertices[table[slot]].Position != p) {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        if (table[slot] == Invalid) {
+            table[slot] = v;
+            groupOf[v] = static_cast<uint32_t>(positions.size());
+            positions.push_back((p - minP) * invScale);
+        } else {
+            groupOf[v] = groupOf[table[slot]];
+        }
+    }
+    const size_t groupCount = positions.size();
+
+    wedgeOffset.assign(groupCount + 1, 0);
+    for (size_t v = 0; v < count; ++v) {
+        if (referenced[v]) ++wedgeOffset[groupOf[v] + 1];
+    }
+    for (size_t g = 0; g < groupCount; ++g) wedgeOffset[g + 1] += wedgeOffset[g];
+    wedges.resize(wedgeOffset.back());
+    std::vector<uint32_t> cursor(wedgeOffset.begin(), wedgeOffset.end() - 1);
+    for (uint32_t v = 0; v < count; ++v) {
+        if (referenced[v]) wedges[cursor[groupOf[v]]++] = v;
+    }
+
+    // ԰Ȩź
+    attributes.resize(count * AttributeCount);
+    for (size_t v = 0; v < count; ++v) {
+        float* a = attributes.data() + v * AttributeCount;
+        const glm::vec3 n = vertices[v].Normal * options.normalWeight;
+        const glm::vec2 uv = vertices[v].TexCoords * options.uvWeight;
+        a[0] = n.x; a[1] = n.y; a[2] = n.z;
+        a[3] = uv.x; a[4] = uv.y;
+    }
+
+    // Ӻ˻ֱӶ
+    triangleGroups.reserve(indices.size());
+    triangleWedges.reserve(indices.size());
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        const uint32_t a = groupOf[indices[i]], b = groupOf[indices[i + 1]], c = groupOf[indices[i + 2]];
+        if (a == b || b == c || c == a) continue;
+        triangleGroups.insert(triangleGroups.end(), { a, b, c });
+        triangleWedges.insert(triangleWedges.end(), { indices[i], indices[i + 1], indices[i + 2] });
+    }
+    triangleCount = triangleGroups.size() / 3;
+    triangleAlive.assign(triangleCount, 1);
+
+    groupAlive.assign(groupCount, 1);
+    sourceVertexCount = vertexCount = wedges.size();
+}
+
+void QuadricSimplifier::BuildAdjacency() {
+    const size_t groupCount = positions.size();
+    adjacencyCount.assign(groupCount, 0);
+    for (uint32_t g : triangleGroups) ++adjacencyCount[g];
+
+    adjacencyOffset.resize(groupCount);
+    uint32_t offset = 0;
+    for (size_t g = 0; g < groupCount; ++g) {
+        adjacencyOffset[g] = offset;
+        offset += adjacencyCount[g];
+    }
+
+    // ۵ʱб׷ڳβԤͬȿռ
+    adjacency.reserve(size_t(offset) * 2);
+    adjacency.resize(offset);
+    std::vector<uint32_t> cursor(adjacencyOffset);
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        for (int k = 0; k < 3; ++k) adjacency[cursor[triangleGroups[3 * t + k]]++] = t;
+    }
+
+    markA.assign(groupCount, 0);
+    markB.assign(groupCount, 0);
+}
+
+void QuadricSimplifier::BuildQuadrics() {
+    geometryQuadrics.assign(positions.size(), {});
+    attributeQuadrics.assign(attributes.size() / AttributeCount, {});
+    attributeGrads.assign(attributes.size(), {});
+
+    auto& pool = Mirror::Core::ThreadPool::Shared();
+    if (!options.parallelSetup || pool.ThreadCount() + 1 < MinParallelThreads
+        || positions.size() < 2 * ParallelGrain) {
+        for (uint32_t t = 0; t < triangleCount; ++t) {
+            TriangleTerms terms;
+            if (!ComputeTriangleTerms(t, terms)) continue;
+            for (int k = 0; k < 3; ++k) AddTriangleTerms(terms, t, k);
+        }
+        return;
+    }
+
+    // λռεĹףÿֻдԼԼԭʼ㣬ԭӲм顣
+    // ϸһΣ߳㹻ʱŻ㡣ۼ˳봮ͬһ
+    pool.ParallelFor(positions.size(), ParallelGrain, [this](size_t first, size_t last) {
+        for (uint32_t group = static_cast<uint32_t>(first); group < last; ++group) {
+            for (uint32_t t : Triangles(group)) {
+                TriangleTerms terms;
+                if (!ComputeTriangleTerms(t, terms)) continue;
+                const uint32_t* g = &triangleGroups[3 * t];
+                AddTriangleTerms(terms, t, g[0] == group ? 0 : (g[1] == group ? 1 : 2));
+            }
+        }
+    });
+}
+
+bool QuadricSimplifier::ComputeTriangleTerms(uint32_t t, TriangleTerms& terms) const {
+    const uint32_t* g = &triangleGroups[3 * t];
+    const uint32_t* w = &triangleWedges[3 * t];
+    const glm::vec3& p0 = positions[g[0]];
+    const glm::vec3 e1 = positions[g[1]] - p0;
+    const glm::vec3 e2 = positions[g[2]] - p0;
+    const glm::vec3 n = glm::cross(e1, e2);
+    const float length = glm::length(n);
+    if (!(length > 0.0f)) return false;  // β
+
+    terms.area = 0.5f * length;
+    terms.normal = n / length;
+
+    // ݶȣƽԲֵ s(p) = gp + d s(p_k) = a_k
+    const float d00 = glm::dot(e1, e1), d01 = glm::dot(e1, e2), d11 = glm::dot(e2, e2);
+    const float invDenom = 1.0f / (length * length);  // d00 * d11 - d01 * d01 = |e1 x e2|^2
+    const float* a0 = Attributes(w[0]);
+    const float* a1 = Attributes(w[1]);
+    const float* a2 = Attributes(w[2]);
+    terms.gradientTerms = {};
+    for (int j = 0; j < AttributeCount; ++j) {
+        const float da1 = a1[j] - a0[j], da2 = a2[j] - a0[j];
+        const float x = (d11 * da1 - d01 * da2) * invDenom;
+        const float y = (d00 * da2 - d01 * da1) * invDenom;
+        const glm::vec3 gj = x * e1 + y * e2;
+        const glm::vec3 weighted = terms.area * gj;
+        terms.gradients[j] = weighted;
+        terms.gradientTerms.a00 += weighted.x * gj.x;
+        terms.gradientTerms.a11 += weighted.y * gj.y;
+        terms.gradientTerms.a22 += weighted.z * gj.z;
+        terms.gradientTerms.a10 += weighted.y * gj.x;
+        terms.gradientTerms.a20 += weighted.z * gj.x;
+        terms.gradientTerms.a21 += weighted.z * gj.y;
+    }
+    terms.gradientTerms.w = terms.area;
+    return true;
+}
+
+void QuadricSimplifier::AddTriangleTerms(const TriangleTerms& terms, uint32_t t, int k) {
+    const uint32_t* g = &triangleGroups[3 * t];
+    const uint32_t* w = &triangleWedges[3 * t];
+
+    // ԸýλΪԭۼӣֵʱӽ
+    const glm::vec3 toOrigin = positions[g[k]] - positions[g[0]];
+    Quadric plane;
+    plane.AddPlane(terms.normal, glm::dot(terms.normal, toOrigin), terms.area);
+    geometryQuadrics[g[k]].Add(plane);
+
+    const float* ak = Attributes(w[k]);
+    Quadric& aq = attributeQuadrics[w[k]];
+    aq.Add(terms.gradientTerms);
+    QuadricGrad* grads = &attributeGrads[size_t(w[k]) * AttributeCount];
+    for (int j = 0; j < AttributeCount; ++j) {
+        const glm::vec3& gj = terms.gradients[j];
+        aq.b0 += ak[j] * gj.x;
+        aq.b1 += ak[j] * gj.y;
+        aq.b2 += ak[j] * gj.z;
+        aq.c += terms.area * ak[j] * ak[j];
+        grads[j].gx += gj.x;
+        grads[j].gy += gj.y;
+        grads[j].gz += gj.z;
+        grads[j].gw += terms.area * ak[j];
+    }
+}
+
+void QuadricSimplifier::ClassifyVertices() {
+    kinds.assign(positions.size(), VertexKind::Manifold);
+
+    // ÿεռֲ鲢ͬڵγȼñ
+    // ιã1 Ϊ߽磬2 ΪΣΪΡ
+    // ֮以д룬ɰ䲢У鰴鸴ã߷
+    const size_t grain = options.parallelSetup ? ParallelGrain : std::max<size_t>(positions.size(), 1);
+    Mirror::Core::ThreadPool::Shared().ParallelFor(positions.size(), grain, [this](size_t first, size_t last) {
+        std::vector<uint32_t> neighbors;
+        for (uint32_t g = static_cast<uint32_t>(first); g < last; ++g) {
+            neighbors.clear();
+            for (uint32_t t : Triangles(g)) {
+                for (int k = 0; k < 3; ++k) {
+                    const uint32_t n = triangleGroups[3 * t + k];
+                    if (n != g) neighbors.push_back(n);
+                }
+            }
+            std::sort(neighbors.begin(), neighbors.end());
+
+            size_t borderEdges = 0;
+            bool nonManifold = false;
+            for (size_t i = 0; i < neighbors.size();) {
+                const uint32_t n = neighbors[i];
+                size_t uses = 1;
+                while (i + uses < neighbors.size() && neighbors[i + uses] == n) ++uses;
+                i += uses;
+                if (uses > 2) nonManifold = true;
+                if (uses != 1) continue;
+                ++borderEdges;
+                AddBorderPlane(g, n);
+            }
+
+            if (nonManifold) kinds[g] = VertexKind::Locked;
+            else if (borderEdges == 0) kinds[g] = VertexKind::Manifold;
+            else if (borderEdges == 2) kinds[g] = VertexKind::Border;
+            else kinds[g] = VertexKind::Locked;  // ߽罻ҵı߽
+        }
+    });
+}
+
+void QuadricSimplifier::AddBorderPlane(uint32_t g, uint32_t n) {
+    // ߽߼һñߡֱεԼƽ棬ֱ߽״
+    // ƽ gֲ³Ϊ 0ߵһڴԼʱͬһƽ
+    for (uint32_t t : Triangles(g)) {
+        const uint32_t* tri = &triangleGroups[3 * t];
+        if (tri[0] != n && tri[1] != n && tri[2] != n) continue;
+        const uint32_t other = tri[0] != g && tri[0] != n ? tri[0] : (tri[1] != g && tri[1] != n ? tri[1] : tri[2]);
+        const glm::vec3 edge = positions[n] - positions[g];
+        const glm::vec3 faceNormal = glm::cross(edge, positions[other] - positions[g]);
+        const glm::vec3 planeNormal = glm::cross(edge, faceNormal);
+        const float length = glm::length(planeNormal);
+        if (length > 0.0f) {
+            geometryQuadrics[g].AddPlane(planeNormal / length, 0.0f, glm::dot(edge, edge) * BorderWeight);
+        }
+        return;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// ۵
+// ---------------------------------------------------------------------------
+size_t QuadricSimplifier::SharedTriangles(uint32_t a, uint32_t b) const {
+    size_t shared = 0;
+    for (uint32_t t : Triangles(a)) {
+        if (!triangleAlive[t]) continue;
+        const uint32_t* tri = &triangleGroups[3 * t];
+        if (tri[0] == b || tri[1] == b || tri[2] == b) ++shared;
+    }
+    return shared;
+}
+
+bool QuadricSimplifier::CanMove(uint32_t from, uint32_t to) const {
+    if (!options.preserveTopology) return true;
+    switch (kinds[from]) {
+    case VertexKind::Manifold:
+        return true;
+    case VertexKind::Border:
+        // ߽綥ֻر߽߲һ߽ϵĶ
+        return kinds[to] != VertexKind::Manifold && SharedTriangles(from, to) == 1;
+    default:
+        return false;
+    }
+}
+
+bool QuadricSimplifier::PassesLinkCondition(uint32_t from, uint32_t to, size_t shared) {
+    // ˵Ĺڵֻǹεĵ㣬۵α
+    ++stamp;
+    for (uint32_t t : Triangles(from)) {
+        if (!triangleAlive[t]) continue;
+        for (int k = 0; k < 3; ++k) markA[triangleGroups[3 * t + k]] = stamp;
+    }
+    size_t common = 0;
+    for (uint32_t t : Triangles(to)) {
+        if (!triangleAlive[t]) continue;
+        for (int k = 0; k < 3; ++k) {
+            const uint32_t n = triangleGroups[3 * t + k];
+            if (n == from || n == to || markA[n] != stamp || markB[n] == stamp) continue;
+            markB[n] = stamp;
+            ++common;
+        }
+    }
+    return common <= shared;
+}
+
+bool QuadricSimplifier::HasFlippedTriangles(uint32_t from, uint32_t to) const {
+    const glm::vec3& target = positions[to];
+    for (uint32_t t : Triangles(from)) {
+        if (!triangleAlive[t]) continue;
+        const uint32_t* tri = &triangleGroups[3 * t];
+        if (tri[0] == to || tri[1] == to || tri[2] == to) continue;  // ۵ɾ
+
+        glm::vec3 p[3] = { positions[tri[0]], positions[tri[1]], positions[tri[2]] };
+        const glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+        for (auto k = 0; k < 3; ++k) {
+            if (tri[k] == from) p[k] = target;
+        }
+        const glm::vec3 after = glm::cross(p[1] - p[0], p[2] - p[0]);
+
+        const float lengths = glm::dot(before, before) * glm::dot(after, after);
+        if (lengths == 0.0f) {
+            if (glm::dot(before, before) == 0.0f) continue;  // ԭ˻βж
+            return true;                                      // ۵˻
+        }
+        if (glm::dot(before, after) <= FlipThreshold * std::sqrt(lengths)) return true;
+    }
+    return false;
+}
+
+uint32_t QuadricSimplifier::MatchWedge(uint32_t wedge, uint32_t group) const {
+    const auto targets = Wedges(group);
+    if (targets.size() == 1) return targets[0];
+
+    // ӷ촦ѡӽĿ
+    const float* a = Attributes(wedge);
+    uint32_t best = targets[0];
+    float bestDistance = std::numeric_limits<float>::max();
+    for (uint32_t candidate : targets) {
+        const float* b = Attributes(candidate);
+        float distance = 0.0f;
+        for (int j = 0; j < AttributeCount; ++j) distance += (a[j] - b[j]) * (a[j] - b[j]);
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+float QuadricSimplifier::AttributeError(uint32_t wedge, const glm::vec3& offset, const float* target) const {
+    const Quadric& q = attributeQuadrics[wedge];
+    if (!(q.w > 0.0f)) return 0.0f;
+    const QuadricGrad* g = &attributeGrads[size_t(wedge) * AttributeCount];
+
+    float error = q.Evaluate(offset);
+    for (int j = 0; j < AttributeCount; ++j) {
+        const float s = target[j];
+        const float interpolated = g[j].gx * offset.x + g[j].gy * offset.y + g[j].gz * offset.z + g[j].gw;
+        error += q.w * s * s - 2.0f * s * interpolated;
+    }
+    return std::fabs(error) / q.w;
+}
+
+float QuadricSimplifier::CollapseCost(uint32_t from, uint32_t to) const {
+    const glm::vec3 offset = positions[to] - positions[from];
+    const Quadric& q = geometryQuadrics[from];
+    float error = q.w > 0.0f ? options.geometryWeight * std::fabs(q.Evaluate(offset)) / q.w : 0.0f;
+    for (uint32_t wedge : Wedges(from)) {
+        error += AttributeError(wedge, offset, Attributes(MatchWedge(wedge, to)));
+    }
+    return error;
+}
+
+QuadricSimplifier::Candidate QuadricSimplifier::FindBestCollapse(uint32_t group, bool validate) {
+    // 㵽ÿڶ۵ۡ˼ִʱִʱʧܹĶ
+    // 飬ȡһϷ
+    neighborCosts.clear();
+    ++stamp;
+    for (uint32_t t : Triangles(group)) {
+        if (!triangleAlive[t]) continue;
+        for (int k = 0; k < 3; ++k) {
+            const uint32_t n = triangleGroups[3 * t + k];
+            if (n == group || markA[n] == stamp) continue;
+            markA[n] = stamp;
+            if (CanMove(group, n)) neighborCosts.emplace_back(CollapseCost(group, n), n);
+        }
+    }
+    if (!validate) {
+        const auto best = std::min_element(neighborCosts.begin(), neighborCosts.end());
+        return best != neighborCosts.end() ? Candidate{ best->first, group, best->second } : Candidate{};
+    }
+    std::sort(neighborCosts.begin(), neighborCosts.end());
+    for (const auto& [cost, n] : neighborCosts) {
+        if (IsValidCollapse(group, n)) return { cost, group, n };
+    }
+    return {};
+}
+
+bool QuadricSimplifier::IsValidCollapse(uint32_t from, uint32_t to) {
+    if (!CanMove(from, to)) return false;
+    const size_t shared = SharedTriangles(from, to);
+    if (shared == 0) return false;
+    if (options.preserveTopology && !PassesLinkCondition(from, to, shared)) return false;
+    return !HasFlippedTriangles(from, to);
+}
+
+void QuadricSimplifier::Collapse(uint32_t from, uint32_t to, float cost) {
+    const glm::vec3 offset = positions[to] - positions[from];
+
+    // Ͳ뱣Ķ㣨ƽƵֲ꣩ӷ촦ÿӽĿ
+    geometryQuadrics[to].Add(geometryQuadrics[from].Translated(offset));
+    scratch.clear();
+    for (uint32_t wedge : Wedges(from)) {
+        const uint32_t target = MatchWedge(wedge, to);
+        scratch.push_back(wedge);
+        scratch.push_back(target);
+
+        attributeQuadrics[target].Add(attributeQuadrics[wedge].Translated(offset));
+        const QuadricGrad* src = &attributeGrads[size_t(wedge) * AttributeCount];
+        QuadricGrad* dst = &attributeGrads[size_t(target) * AttributeCount];
+        for (int j = 0; j < AttributeCount; ++j) {
+            dst[j].gx += src[j].gx;
+            dst[j].gy += src[j].gy;
+            dst[j].gz += src[j].gz;
+            dst[j].gw += src[j].gw + src[j].gx * offset.x + src[j].gy * offset.y + src[j].gz * offset.z;
+        }
+    }
+
+    // д from Σͬʱ˵˻ɾڽӱдβ
+    const uint32_t fromOffset = adjacencyOffset[from], fromCount = adjacencyCount[from];
+    const uint32_t toOffset = adjacencyOffset[to], toCount = adjacencyCount[to];
+    const uint32_t newOffset = static_cast<uint32_t>(adjacency.size());
+    for (uint32_t i = 0; i < fromCount; ++i) {
+        const uint32_t t = adjacency[fromOffset + i];
+        if (!triangleAlive[t]) continue;
+        uint32_t* tri = &triangleGroups[3 * t];
+        if (tri[0] == to || tri[1] == to || tri[2] == to) {
+            triangleAlive[t] = 0;
+            --triangleCount;
+            if (history) history->removedTriangles.push_back(t);
+            continue;
+        }
+        for (int k = 0; k < 3; ++k) {
+            if (tri[k] != from) continue;
+            tri[k] = to;
+            uint32_t& wedge = triangleWedges[3 * t + k];
+            const uint32_t oldWedge = wedge;
+            for (size_t m = 0; m < scratch.size(); m += 2) {
+                if (scratch[m] == wedge) {
+                    wedge = scratch[m + 1];
+                    break;
+                }
+            }
+            if (history) history->changes.push_back({ 3 * t + k, oldWedge, wedge });
+        }
+        adjacency.push_back(t);
+    }
+    for (uint32_t i = 0; i < toCount; ++i) {
+        const uint32_t t = adjacency[toOffset + i];
+        if (triangleAlive[t]) adjacency.push_back(t);
+    }
+    adjacencyOffset[to] = newOffset;
+    adjacencyCount[to] = static_cast<uint32_t>(adjacency.size()) - newOffset;
+    adjacencyCount[from] = 0;
+
+    groupAlive[from] = 0;
+    vertexCount -= Wedges(from).size();
+    maxError = std::max(maxError, cost);
+    if (history) {
+        history->steps.push_back({ static_cast<uint32_t>(history->changes.size()),
+                                   static_cast<uint32_t>(history->removedTriangles.size()),
+                                   static_cast<uint32_t>(vertexCount), GetError() });
+    }
+
+    // ͱˣڲΪ۵
+    // ԭ from ڵ㻻ھӣ۵ܸı䣬һ¼
+    updatedPass[to] = pass;
+    for (uint32_t t : Triangles(to)) {
+        for (int k = 0; k < 3; ++k) {
+            uint8_t& state = dirty[triangleGroups[3 * t + k]];
+            state = std::max(state, Stale);
+        }
+    }
+}
+
+size_t QuadricSimplifier::SimplifyTo(size_t targetVertexCount) {
+    while (vertexCount > targetVertexCount) {
+        ++pass;
+
+        // ֻ¼ĶĶ
+        candidates.clear();
+        for (uint32_t g = 0; g < positions.size(); ++g) {
+            if (!groupAlive[g] || adjacencyCount[g] == 0) continue;
+            if (dirty[g] != Clean) {
+                bestCollapse[g] = FindBestCollapse(g, dirty[g] == NeedsValidation);
+                dirty[g] = Clean;
+            }
+            if (bestCollapse[g].to != Invalid) candidates.push_back(bestCollapse[g]);
+        }
+        if (candidates.empty()) break;
+
+        // ȡ͵һ˳ִУ۵Ĵ۶ܵͣȺ˳ԽӰС
+        // ˳ڽӱͱȰ˳ʿöࡣ
+        // ÿȡһѡʣµһ¼ĴһȽ
+        const size_t batch = std::min(vertexCount - targetVertexCount, std::max<size_t>(candidates.size() / 2, 1));
+        if (batch < candidates.size()) {
+            std::nth_element(candidates.begin(), candidates.begin() + batch, candidates.end(),
+                             [](const Candidate& a, const Candidate& b) { return a.cost < b.cost; });
+            candidates.resize(batch);
+        }
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Candidate& a, const Candidate& b) { return a.from < b.from; });
+
+        size_t collapsed = 0, rejected = 0;
+        for (const Candidate& c : candidates) {
+            if (vertexCount <= targetVertexCount) break;
+            if (!groupAlive[c.from] || !groupAlive[c.to] || updatedPass[c.from] == pass) continue;
+            if (!IsValidCollapse(c.from, c.to)) {
+                dirty[c.from] = NeedsValidation;
+                ++rejected;
+                continue;
+            }
+            Collapse(c.from, c.to, c.cost);
+            ++collapsed;
+        }
+        if (collapsed == 0 && rejected == 0) break;
+    }
+    return vertexCount;
+}
+
+float QuadricSimplifier::GetError() const {
+    return std::sqrt(maxError) * scale;
+}
+
+std::vector<uint32_t> QuadricSimplifier::GetIndices() const {
+    std::vector<uint32_t> result;
+    result.reserve(triangleCount * 3);
+    for (uint32_t t = 0; t < triangleAlive.size(); ++t) {
+        if (!triangleAlive[t]) continue;
+        result.insert(result.end(), &triangleWedges[3 * t], &triangleWedges[3 * t] + 3);
+    }
+    return result;
+}
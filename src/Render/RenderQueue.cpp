@@ -0,0 +1,58 @@
+// RenderQueue.cpp
+#include "RenderQueue.h"
+
+namespace {
+    constexpr int DigitBits = 11;
+    constexpr int Buckets = 1 << DigitBits;
+    constexpr int Passes = (RenderQueue::KeyBits + DigitBits - 1) / DigitBits;
+}
+
+void RenderQueue::Widen() {
+    wideEntries.reserve(std::max(entries.capacity(), entries.size() + 1));
+    for (const uint64_t entry : entries)
+        wideEntries.push_back({ entry >> IndexBits, static_cast<uint32_t>(entry & (MaxItems - 1)) });
+    entries.clear();
+}
+
+void RenderQueue::Sort() {
+    if (!wideEntries.empty()) {
+        // κٳֱ֣ñȽŸͬ (, ) 򼴵ͬȶ
+        std::sort(wideEntries.begin(), wideEntries.end(), [](const WideEntry& a, const WideEntry& b) {
+            return a.key != b.key ? a.key < b.key : a.index < b.index;
+        });
+        return;
+    }
+
+    const size_t count = entries.size();
+    if (count < 2) return;
+
+    // һαͳλεֱͼڵĵλ򣨸ͬͬʱȻУ
+    histograms.assign(static_cast<size_t>(Passes) * Buckets, 0);
+    for (const uint64_t entry : entries) {
+        for (int pass = 0; pass < Passes; ++pass)
+            ++histograms[pass * Buckets + ((entry >> (IndexBits + pass * DigitBits)) & (Buckets - 1))];
+    }
+
+    scratch.resize(count);
+    uint64_t* source = entries.data();
+    uint64_t* target = scratch.data();
+    for (int pass = 0; pass < Passes; ++pass) {
+        uint32_t* histogram = histograms.data() + pass * Buckets;
+        const int shift = IndexBits + pass * DigitBits;
+        // ڸλֻͬһȾУʱ˳򲻱䣬
+        if (histogram[(source[0] >> shift) & (Buckets - 1)] == count) continue;
+
+        uint32_t offset = 0;
+        for (int bucket = 0; bucket < Buckets; ++bucket) {
+            const uint32_t size = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += size;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            const uint64_t entry = source[i];
+            target[histogram[(entry >> shift) & (Buckets - 1)]++] = entry;
+        }
+        std::swap(source, target);
+    }
+    if (source != entries.data()) entries.swap(scratch);
+}
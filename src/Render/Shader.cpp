@@ -1,4 +1,6 @@
 #include "Shader.h"
+#include "GLStateCache.h"
+#include <cstring>
 #include <iostream>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -34,51 +36,69 @@ Shader::Shader(const std::string& vertexSrc, const std::string& fragmentSrc) {
 
 Shader::~Shader() {
     if (ID != 0) {
+        GLStateCache::ForgetProgram(ID);
         glDeleteProgram(ID);
     }
 }
 
 void Shader::Use() const {
-    glUseProgram(ID);
+    GLStateCache::UseProgram(ID);
 }
 
 // Uniform λû
-GLint Shader::GetLocation(const std::string& name) const {
+Shader::Uniform& Shader::GetUniform(const std::string& name) const {
     auto it = uniformCache.find(name);
     if (it != uniformCache.end()) {
         return it->second;
     }
 
-    GLint location = glGetUniformLocation(ID, name.c_str());
-    if (location == -1) {
+    Uniform uniform;
+    uniform.location = glGetUniformLocation(ID, name.c_str());
+    if (uniform.location == -1) {
         std::cerr << "[Shader Warning] Uniform '" << name 
                  << "' not found or optimized out\n";
     }
 
-    uniformCache[name] = location;
-    return location;
+    return uniformCache.emplace(name, uniform).first->second;
+}
+
+// λȽϣڵ uniform ϴҲЧһ
+bool Shader::UpdateValue(Uniform& uniform, const void* data, size_t words) {
+    const bool changed = uniform.location != -1 &&
+        (uniform.words != words || std::memcmp(uniform.value.data(), data, words * sizeof(uint32_t)) != 0);
+    GLStateCache::Record(GLStateCache::Call::Uniform, changed);
+    if (changed) {
+        std::memcpy(uniform.value.data(), data, words * sizeof(uint32_t));
+        uniform.words = static_cast<uint8_t>(words);
+    }
+    return changed;
 }
 
 // ʵ
 void Shader::SetBool(const std::string& name, bool value) const {
-    glUniform1i(GetLocation(name), (int)value);
+    SetInt(name, value ? 1 : 0);
 }
 
 void Shader::SetInt(const std::string& name, int value) const {
-    glUniform1i(GetLocation(name), value);
+    Uniform& uniform = GetUniform(name);
+    if (UpdateValue(uniform, &value, 1)) glUniform1i(uniform.location, value);
 }
 
 void Shader::SetFloat(const std::string& name, float value) const {
-    glUniform1f(GetLocation(name), value);
+    Uniform& uniform = GetUniform(name);
+    if (UpdateValue(uniform, &value, 1)) glUniform1f(uniform.location, value);
 }
 
 // GLMʵ
 void Shader::SetVec3(const std::string& name, const glm::vec3& value) const {
-    glUniform3fv(GetLocation(name), 1, glm::value_ptr(value));
+    Uniform& uniform = GetUniform(name);
+    if (UpdateValue(uniform, glm::value_ptr(value), 3)) glUniform3fv(uniform.location, 1, glm::value_ptr(value));
 }
 
 void Shader::SetMat4(const std::string& name, const glm::mat4& value) const {
-    glUniformMatrix4fv(GetLocation(name), 1, GL_FALSE, glm::value_ptr(value));
+    Uniform& uniform = GetUniform(name);
+    if (UpdateValue(uniform, glm::value_ptr(value), 16))
+        glUniformMatrix4fv(uniform.location, 1, GL_FALSE, glm::value_ptr(value));
 }
 
 // 
@@ -1,5 +1,6 @@
 // Texture.cpp
 #include "Texture.h"
+#include "GLStateCache.h"
 #include "Resources/stb_image.h"
 #include <iostream>
 #include <stdexcept>
@@ -77,7 +78,7 @@ void Texture::LoadFromFile() {
     }
 
     glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    GLStateCache::BindTexture(0, textureID);
     
     glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 
                 0, format, GL_UNSIGNED_BYTE, data);
@@ -98,12 +99,12 @@ Texture::~Texture() {
 
 void Texture::Bind(unsigned int unit) const {
     if (!IsValid()) return;
-    glActiveTexture(GL_TEXTURE0 + unit);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    GLStateCache::BindTexture(unit, textureID);
 }
 
 void Texture::Release() {
     if (textureID != 0) {
+        GLStateCache::ForgetTexture(textureID);
         glDeleteTextures(1, &textureID);
         textureID = 0;
     }
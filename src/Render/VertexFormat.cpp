@@ -0,0 +1,81 @@
+// VertexFormat.cpp
+#include "VertexFormat.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/packing.hpp>
+
+namespace VertexCodec {
+
+namespace {
+    uint16_t ToUnorm16(float v) {
+        return static_cast<uint16_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 65535.0f));
+    }
+    int16_t ToSnorm16(float v) {
+        return static_cast<int16_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f));
+    }
+    float SignNotZero(float v) { return v >= 0.0f ? 1.0f : -1.0f; }
+}
+
+glm::vec2 EncodeOctahedral(const glm::vec3& n) {
+    const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (!(l1 > 0.0f)) return glm::vec2(0.0f);
+    glm::vec2 e = glm::vec2(n.x, n.y) / l1;
+    if (n.z < 0.0f) {
+        // °ضԽ۵
+        e = glm::vec2((1.0f - std::abs(e.y)) * SignNotZero(e.x),
+                      (1.0f - std::abs(e.x)) * SignNotZero(e.y));
+    }
+    return e;
+}
+
+glm::vec3 DecodeOctahedral(const glm::vec2& e) {
+    glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+    const float t = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return glm::normalize(n);
+}
+
+void ComputeQuantizationBox(std::span<const Vertex> vertices, glm::vec3& offset, glm::vec3& scale) {
+    if (vertices.empty()) {
+        offset = glm::vec3(0.0f);
+        scale = glm::vec3(1.0f);
+        return;
+    }
+    glm::vec3 minP = vertices[0].Position, maxP = minP;
+    for (const auto& v : vertices) {
+        minP = glm::min(minP, v.Position);
+        maxP = glm::max(maxP, v.Position);
+    }
+    offset = minP;
+    scale = maxP - minP;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (!(scale[axis] > 0.0f)) scale[axis] = 1.0f;
+    }
+}
+
+std::vector<QuantizedVertex> Quantize(std::span<const Vertex> vertices,
+                                      const glm::vec3& offset, const glm::vec3& scale) {
+    const glm::vec3 invScale = 1.0f / scale;
+    std::vector<QuantizedVertex> packed(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const Vertex& v = vertices[i];
+        QuantizedVertex& q = packed[i];
+
+        const glm::vec3 p = (v.Position - offset) * invScale;
+        q.position[0] = ToUnorm16(p.x);
+        q.position[1] = ToUnorm16(p.y);
+        q.position[2] = ToUnorm16(p.z);
+        q.position[3] = 0;
+
+        const glm::vec2 e = EncodeOctahedral(v.Normal);
+        q.normal[0] = ToSnorm16(e.x);
+        q.normal[1] = ToSnorm16(e.y);
+
+        q.texCoords[0] = glm::packHalf1x16(v.TexCoords.x);
+        q.texCoords[1] = glm::packHalf1x16(v.TexCoords.y);
+    }
+    return packed;
+}
+
+} // namespace VertexCodec